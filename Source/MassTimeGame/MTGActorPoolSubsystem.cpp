@@ -0,0 +1,152 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGActorPoolSubsystem.h"
+
+#include "MassActorSpawnerSubsystem.h"
+#include "MassEntityConfigAsset.h"
+#include "MassTimeGame.h"
+#include "MassVisualizationTrait.h"
+#include "MTGSpawnerSubsystem.h"
+#include "MTGWandererActor.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Actor Pool Hits"), STAT_MTGActorPoolHits, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Actor Pool Misses"), STAT_MTGActorPoolMisses, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Actor Pool Releases"), STAT_MTGActorPoolReleases, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::ActorPool
+{
+	static FAutoConsoleCommandWithWorld CmdActorPoolStats(
+		TEXT("mtg.ActorPoolStats"),
+		TEXT("Log the wanderer actor pool hit rate and spawn time counters"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UMTGActorPoolSubsystem* PoolSubsystem = World ? World->GetSubsystem<UMTGActorPoolSubsystem>() : nullptr)
+			{
+				const FMTGActorPoolStats& Stats = PoolSubsystem->GetPoolStats();
+				UE_LOG(LogMassTimeGame, Log, TEXT("Actor Pool: prewarmed %d in %.2f ms; hits %d, misses %d (hit rate %.1f%%), releases %d; on-demand spawns took %.2f ms total, %.3f ms avg"),
+					Stats.NumPrewarmed, 1000. * Stats.PrewarmSeconds,
+					Stats.NumHits, Stats.NumMisses, 100.f * Stats.GetHitRate(), Stats.NumReleases,
+					1000. * Stats.MissSpawnSeconds, Stats.NumMisses > 0 ? 1000. * Stats.MissSpawnSeconds / Stats.NumMisses : 0.);
+			}
+		}));
+}
+
+// Set Class Defaults
+UMTGActorPoolSubsystem::UMTGActorPoolSubsystem()
+{
+	WandererActorClass = TSoftClassPtr<AMTGWandererActor>(FSoftObjectPath(TEXT("/Game/Mass/BP_Wanderer.BP_Wanderer_C")));
+}
+
+void UMTGActorPoolSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	PrewarmPool();
+}
+
+bool UMTGActorPoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UMTGActorPoolSubsystem::GetVisibleActorBudget() const
+{
+	const UMTGSpawnerSubsystem* SpawnerSubsystem = GetWorld()->GetSubsystem<UMTGSpawnerSubsystem>();
+	const UMassEntityConfigAsset* EntityConfig = SpawnerSubsystem ? SpawnerSubsystem->GetWandererEntityConfig() : nullptr;
+	const UMassVisualizationTrait* VisualizationTrait = EntityConfig
+		? Cast<UMassVisualizationTrait>(EntityConfig->GetConfig().FindTrait(UMassVisualizationTrait::StaticClass()))
+		: nullptr;
+	if (!VisualizationTrait)
+	{
+		return 0;
+	}
+
+	// The representation shows an actor exactly for the entities the LOD processor puts in High
+	const int32 HighMaxCount = VisualizationTrait->LODParams.LODMaxCount[EMassLOD::High];
+	if (HighMaxCount == MAX_int32)
+	{
+		UE_LOG(LogMassTimeGame, Warning, TEXT("Wanderer visualization [%s] has no High LOD max count; nothing to size the actor pool by"), *GetNameSafe(EntityConfig));
+		return 0;
+	}
+
+	return FMath::Max(0, HighMaxCount);
+}
+
+void UMTGActorPoolSubsystem::PrewarmPool()
+{
+	UWorld* World = GetWorld();
+	check(World);
+
+	UMassActorSpawnerSubsystem* ActorSpawnerSubsystem = World->GetSubsystem<UMassActorSpawnerSubsystem>();
+	if (!ensureMsgf(ActorSpawnerSubsystem, TEXT("MassActorSpawnerSubsystem is required")))
+	{
+		return;
+	}
+
+	// Mass only recycles actors if pooling is on; make sure it is even if we don't pre-warm
+	ActorSpawnerSubsystem->EnableActorPooling();
+
+	UClass* ActorClass = WandererActorClass.LoadSynchronous();
+	const int32 VisibleActorBudget = GetVisibleActorBudget();
+	if (!ActorClass || VisibleActorBudget <= 0)
+	{
+		UE_LOG(LogMassTimeGame, Warning, TEXT("Actor Pool pre-warm skipped (class [%s], budget %d)"), *WandererActorClass.ToString(), VisibleActorBudget);
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.bDeferConstruction = true;
+
+	for (int32 Index = 0; Index < VisibleActorBudget; ++Index)
+	{
+		AMTGWandererActor* Actor = World->SpawnActor<AMTGWandererActor>(ActorClass, FTransform::Identity, SpawnParameters);
+		if (!Actor)
+		{
+			break;
+		}
+
+		// Must be marked before BeginPlay, or it would count itself as a pool miss
+		Actor->MarkAsPrewarmed();
+		Actor->FinishSpawning(FTransform::Identity);
+
+		// Mass calls PrepareForPooling, which deactivates the actor
+		if (!ActorSpawnerSubsystem->ReleaseActorToPool(Actor))
+		{
+			Actor->Destroy();
+			break;
+		}
+
+		++PoolStats.NumPrewarmed;
+	}
+
+	PoolStats.PrewarmSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// Pre-warming isn't representation traffic
+	PoolStats.NumReleases = 0;
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Actor Pool pre-warmed with %d [%s] in %.2f ms"), PoolStats.NumPrewarmed, *GetNameSafe(ActorClass), 1000. * PoolStats.PrewarmSeconds);
+}
+
+void UMTGActorPoolSubsystem::RecordPoolHit()
+{
+	++PoolStats.NumHits;
+	INC_DWORD_STAT(STAT_MTGActorPoolHits);
+}
+
+void UMTGActorPoolSubsystem::RecordPoolMiss(double SpawnSeconds)
+{
+	++PoolStats.NumMisses;
+	PoolStats.MissSpawnSeconds += SpawnSeconds;
+	INC_DWORD_STAT(STAT_MTGActorPoolMisses);
+}
+
+void UMTGActorPoolSubsystem::RecordPoolRelease()
+{
+	++PoolStats.NumReleases;
+	INC_DWORD_STAT(STAT_MTGActorPoolReleases);
+}
@@ -0,0 +1,96 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGActorPoolSubsystem.generated.h"
+
+class AMTGWandererActor;
+
+/**
+ * Counters describing how well the wanderer actor pool is working
+ */
+struct FMTGActorPoolStats
+{
+	/** Number of actors spawned at BeginPlay to pre-warm the pool */
+	int32 NumPrewarmed = 0;
+
+	/** Real time (seconds) spent pre-warming the pool */
+	double PrewarmSeconds = 0.;
+
+	/** Number of times the representation got an actor from the pool */
+	int32 NumHits = 0;
+
+	/** Number of times the representation had to spawn a new actor because the pool was empty */
+	int32 NumMisses = 0;
+
+	/** Number of times an actor was returned to the pool */
+	int32 NumReleases = 0;
+
+	/** Total real time (seconds) spent spawning actors on demand (i.e. on misses) */
+	double MissSpawnSeconds = 0.;
+
+	/** @return Fraction (0..1) of actor requests that were served from the pool */
+	float GetHitRate() const { return NumHits + NumMisses > 0 ? static_cast<float>(NumHits) / (NumHits + NumMisses) : 1.f; }
+};
+
+/**
+ * MTG Actor Pool Subsystem
+ *
+ * When the camera pans or the sim runs fast, lots of wanderers cross the
+ * high LOD boundary at once, and spawning/destroying BP_Wanderer actors in
+ * bursts causes frame hitches.
+ *
+ * This enables actor pooling in UMassActorSpawnerSubsystem and pre-warms the
+ * pool at BeginPlay with one wanderer actor per entity the representation can
+ * show as an actor at once, i.e. the High LOD max count of the wanderer entity
+ * config's visualization trait.  The representation then recycles actors (see
+ * AMTGWandererActor) instead of spawning them.  It also counts pool
+ * hits/misses and the cost of on-demand spawns.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Actor Pool Subsystem"))
+class MASSTIMEGAME_API UMTGActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGActorPoolSubsystem();
+
+	//~Begin UWorldSubsystem interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 * Get the pool counters
+	 * @return Current pool stats
+	 */
+	const FMTGActorPoolStats& GetPoolStats() const { return PoolStats; }
+
+	/** Called by AMTGWandererActor when it is retrieved from the pool */
+	void RecordPoolHit();
+
+	/** Called by AMTGWandererActor when it was spawned on demand, i.e. the pool was empty */
+	void RecordPoolMiss(double SpawnSeconds);
+
+	/** Called by AMTGWandererActor when it is returned to the pool */
+	void RecordPoolRelease();
+
+protected:
+	/** The wanderer representation actor class to pre-warm (BP_Wanderer) */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	TSoftClassPtr<AMTGWandererActor> WandererActorClass;
+
+	/**
+	 * Get the maximum number of wanderers represented by actors at once
+	 * @return High LOD max count of the wanderer visualization, or 0 if there is none or it's unlimited
+	 */
+	int32 GetVisibleActorBudget() const;
+
+	/** Spawn GetVisibleActorBudget actors into the Mass actor pool */
+	void PrewarmPool();
+
+private:
+	FMTGActorPoolStats PoolStats;
+};
@@ -0,0 +1,414 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGAggregateSubsystem.h"
+
+#include "MassCommonFragments.h"
+#include "MassEntityConfigAsset.h"
+#include "MassEntityManager.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutionContext.h"
+#include "MassMovementFragments.h"
+#include "MassSpawnerSubsystem.h"
+#include "MassSpawnerTypes.h"
+#include "MassSpawnLocationProcessor.h"
+#include "MassTimeGame.h"
+#include "MTGFrameArena.h"
+#include "MTGMassFragments.h"
+#include "MTGRandomSubsystem.h"
+#include "MTGSimTimeSubsystem.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Aggregate LOD"), STAT_MTGAggregateLOD, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Aggregate Population"), STAT_MTGAggregatePopulation, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Aggregate Folded"), STAT_MTGAggregateFolded, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Aggregate Expanded"), STAT_MTGAggregateExpanded, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::Aggregate
+{
+	static bool bEnabled = false;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("mtg.AggregateLOD"),
+		bEnabled,
+		TEXT("If true, wanderers far from the camera are folded into aggregate cell populations"));
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdSeedAggregatePopulation(
+		TEXT("mtg.SeedAggregatePopulation"),
+		TEXT("Add wanderers to the aggregate grid, spread over the cells away from the camera. Usage: mtg.SeedAggregatePopulation 1000000"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UMTGAggregateSubsystem* AggregateSubsystem = World ? World->GetSubsystem<UMTGAggregateSubsystem>() : nullptr;
+			if (AggregateSubsystem && Args.Num() > 0)
+			{
+				AggregateSubsystem->SeedPopulation(FCString::Atoi64(*Args[0]));
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorld CmdAggregateStats(
+		TEXT("mtg.AggregateStats"),
+		TEXT("Log the aggregate LOD population"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UMTGAggregateSubsystem* AggregateSubsystem = World ? World->GetSubsystem<UMTGAggregateSubsystem>() : nullptr)
+			{
+				AggregateSubsystem->LogStats();
+			}
+		}));
+
+	/** Never move more than this fraction of a cell's population in one step, so populations can't go negative */
+	static constexpr float MaxFlowFraction = 0.45f;
+
+	/** Find the camera to measure distances from */
+	static bool GetCameraLocation(const UWorld* World, FVector& OutLocation)
+	{
+		const APlayerController* PlayerController = World->GetFirstPlayerController();
+		if (PlayerController && PlayerController->PlayerCameraManager)
+		{
+			OutLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+			return true;
+		}
+		return false;
+	}
+}
+
+// Set Class Defaults
+UMTGAggregateSubsystem::UMTGAggregateSubsystem()
+{
+	WandererEntityConfig = TSoftObjectPtr<UMassEntityConfigAsset>(FSoftObjectPath(TEXT("/Game/Mass/MEC_Wanderer.MEC_Wanderer")));
+	AggregateDistance = 20000.f;
+	ExpandDistance = 15000.f;
+	CellSize = 2000.f;
+	GridHalfExtent = 200000.f;
+	AggregateStepSeconds = 1.f;
+	DiffusionRate = 0.05f;
+	FlowDecaySeconds = 30.f;
+	MaxFoldsPerTick = 500;
+	MaxExpandsPerTick = 200;
+}
+
+void UMTGAggregateSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+	Collection.InitializeDependency<UMassSpawnerSubsystem>();
+
+	if (const UMTGRandomSubsystem* RandomSubsystem = Collection.InitializeDependency<UMTGRandomSubsystem>())
+	{
+		RandomStream.Initialize(static_cast<int32>(HashCombineFast(RandomSubsystem->GetWorldSeed(), GetTypeHash(TEXT("MTGAggregate")))));
+	}
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+	}
+
+	ensureMsgf(ExpandDistance < AggregateDistance, TEXT("ExpandDistance (%.0f) should be less than AggregateDistance (%.0f), else wanderers will fold and expand every tick"), ExpandDistance, AggregateDistance);
+
+	NumCells1D = FMath::Max(1, FMath::CeilToInt32(2. * GridHalfExtent / CellSize));
+	Population.SetNumZeroed(NumCells1D * NumCells1D);
+	FlowVelocity.SetNumZeroed(NumCells1D * NumCells1D);
+}
+
+void UMTGAggregateSubsystem::Deinitialize()
+{
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+bool UMTGAggregateSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+int32 UMTGAggregateSubsystem::GetClampedCellIndex(const FVector& Location) const
+{
+	const int32 X = FMath::Clamp(FMath::FloorToInt32((Location.X + GridHalfExtent) / CellSize), 0, NumCells1D - 1);
+	const int32 Y = FMath::Clamp(FMath::FloorToInt32((Location.Y + GridHalfExtent) / CellSize), 0, NumCells1D - 1);
+	return Y * NumCells1D + X;
+}
+
+FVector2D UMTGAggregateSubsystem::GetCellCenter(const int32 CellIndex) const
+{
+	return FVector2D(
+		-GridHalfExtent + (CellIndex % NumCells1D + 0.5) * CellSize,
+		-GridHalfExtent + (CellIndex / NumCells1D + 0.5) * CellSize);
+}
+
+double UMTGAggregateSubsystem::GetTotalPopulation() const
+{
+	double Total = 0.;
+	for (const float CellPopulation : Population)
+	{
+		Total += CellPopulation;
+	}
+	return Total;
+}
+
+void UMTGAggregateSubsystem::LogStats() const
+{
+	int32 NumOccupiedCells = 0;
+	float MaxCellPopulation = 0.f;
+	for (const float CellPopulation : Population)
+	{
+		NumOccupiedCells += CellPopulation > 0.f ? 1 : 0;
+		MaxCellPopulation = FMath::Max(MaxCellPopulation, CellPopulation);
+	}
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Aggregate LOD %s: population %.0f in %d/%d cells (max %.0f per cell)"),
+		UE::MTG::Aggregate::bEnabled ? TEXT("enabled") : TEXT("disabled"),
+		GetTotalPopulation(), NumOccupiedCells, Population.Num(), MaxCellPopulation);
+}
+
+void UMTGAggregateSubsystem::SeedPopulation(const int64 Count)
+{
+	FVector CameraLocation = FVector::ZeroVector;
+	const bool bHasCamera = UE::MTG::Aggregate::GetCameraLocation(GetWorld(), CameraLocation);
+
+	// Only seed cells that won't immediately expand
+	TArray<int32> SeedCells;
+	for (int32 CellIndex = 0; CellIndex < Population.Num(); ++CellIndex)
+	{
+		if (!bHasCamera || FVector2D::Distance(GetCellCenter(CellIndex), FVector2D(CameraLocation)) > ExpandDistance + CellSize)
+		{
+			SeedCells.Add(CellIndex);
+		}
+	}
+
+	if (SeedCells.Num() == 0 || Count <= 0)
+	{
+		return;
+	}
+
+	const float PerCell = static_cast<float>(static_cast<double>(Count) / SeedCells.Num());
+	for (const int32 CellIndex : SeedCells)
+	{
+		Population[CellIndex] += PerCell;
+	}
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Seeded %lld aggregate wanderers over %d cells"), Count, SeedCells.Num());
+}
+
+void UMTGAggregateSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	using namespace UE::MTG::Aggregate;
+
+	if (LIKELY(!bEnabled))
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGAggregateLOD);
+
+	AccumulatedStepTime += SimTimeSubsystemIn->GetSimDeltaTime();
+	while (AccumulatedStepTime >= AggregateStepSeconds)
+	{
+		AccumulatedStepTime -= AggregateStepSeconds;
+		StepAggregate(AggregateStepSeconds);
+	}
+
+	FVector CameraLocation;
+	if (GetCameraLocation(GetWorld(), CameraLocation))
+	{
+		FoldDistantWanderers(CameraLocation);
+		ExpandNearbyCells(CameraLocation);
+	}
+
+	SET_DWORD_STAT(STAT_MTGAggregatePopulation, static_cast<uint32>(GetTotalPopulation()));
+}
+
+void UMTGAggregateSubsystem::StepAggregate(const float DeltaTime)
+{
+	using namespace UE::MTG::Aggregate;
+
+	const int32 NumCells = Population.Num();
+	const float FlowDecay = FMath::Exp(-DeltaTime / FlowDecaySeconds);
+	const float DiffuseFraction = FMath::Min(DiffusionRate * DeltaTime, MaxFlowFraction) * 0.25f;
+
+	// Scratch for this step only; OnSimTickCompleted is in a frame arena scope
+	TArray<float, FMTGFrameArenaAllocator> NewPopulation;
+	TArray<FVector2f, FMTGFrameArenaAllocator> NewMomentum;  // Population-weighted velocity sum
+	NewPopulation.SetNumZeroed(NumCells);
+	NewMomentum.SetNumZeroed(NumCells);
+
+	auto Move = [&](const int32 ToX, const int32 ToY, const int32 FromIndex, const float Amount, const FVector2f& Velocity)
+	{
+		// Population at the edge of the grid stays put
+		const int32 ToIndex = (ToX >= 0 && ToY >= 0 && ToX < NumCells1D && ToY < NumCells1D) ? ToY * NumCells1D + ToX : FromIndex;
+		NewPopulation[ToIndex] += Amount;
+		NewMomentum[ToIndex] += Velocity * Amount;
+	};
+
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		const float CellPopulation = Population[CellIndex];
+		if (CellPopulation <= 0.f)
+		{
+			continue;
+		}
+
+		const int32 X = CellIndex % NumCells1D;
+		const int32 Y = CellIndex / NumCells1D;
+		const FVector2f Velocity = FlowVelocity[CellIndex] * FlowDecay;
+
+		// Advection along the mean flow, as the fraction of the cell crossed this step
+		const float FlowX = FMath::Min(FMath::Abs(Velocity.X) * DeltaTime / CellSize, MaxFlowFraction) * CellPopulation;
+		const float FlowY = FMath::Min(FMath::Abs(Velocity.Y) * DeltaTime / CellSize, MaxFlowFraction) * CellPopulation;
+		const float Remaining = FMath::Max(0.f, CellPopulation - FlowX - FlowY);
+		const float Diffuse = Remaining * DiffuseFraction;
+
+		Move(X + (Velocity.X >= 0.f ? 1 : -1), Y, CellIndex, FlowX, Velocity);
+		Move(X, Y + (Velocity.Y >= 0.f ? 1 : -1), CellIndex, FlowY, Velocity);
+
+		// Diffusing wanderers have no net direction
+		Move(X + 1, Y, CellIndex, Diffuse, FVector2f::ZeroVector);
+		Move(X - 1, Y, CellIndex, Diffuse, FVector2f::ZeroVector);
+		Move(X, Y + 1, CellIndex, Diffuse, FVector2f::ZeroVector);
+		Move(X, Y - 1, CellIndex, Diffuse, FVector2f::ZeroVector);
+
+		Move(X, Y, CellIndex, Remaining - 4.f * Diffuse, Velocity);
+	}
+
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		Population[CellIndex] = NewPopulation[CellIndex];
+		FlowVelocity[CellIndex] = NewPopulation[CellIndex] > UE_KINDA_SMALL_NUMBER ? NewMomentum[CellIndex] / NewPopulation[CellIndex] : FVector2f::ZeroVector;
+	}
+}
+
+void UMTGAggregateSubsystem::FoldDistantWanderers(const FVector& CameraLocation)
+{
+	UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntitySubsystem))
+	{
+		return;
+	}
+
+	FMassEntityManager& EntityManager = EntitySubsystem->GetMutableEntityManager();
+	const FVector2D Camera2D(CameraLocation);
+	const double AggregateDistanceSquared = FMath::Square(AggregateDistance);
+
+	EntitiesToFold.Reset();
+
+	FMassEntityQuery Query(EntityManager.AsShared());
+	Query.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddRequirement<FMassVelocityFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddRequirement<FMTGWanderTargetFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+
+	FMassExecutionContext ExecutionContext(EntityManager);
+	Query.ForEachEntityChunk(ExecutionContext, [this, &Camera2D, AggregateDistanceSquared](FMassExecutionContext& Context)
+	{
+		const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+		const TConstArrayView<FMassVelocityFragment> Velocities = Context.GetFragmentView<FMassVelocityFragment>();
+
+		const int32 NumEntities = Context.GetNumEntities();
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities && EntitiesToFold.Num() < MaxFoldsPerTick; ++EntityIndex)
+		{
+			const FVector Location = Transforms[EntityIndex].GetTransform().GetLocation();
+			if (FVector2D::DistSquared(FVector2D(Location), Camera2D) <= AggregateDistanceSquared)
+			{
+				continue;
+			}
+
+			// Fold this wanderer's velocity into the cell's mean flow
+			const int32 CellIndex = GetClampedCellIndex(Location);
+			const float OldPopulation = Population[CellIndex];
+			const FVector& Velocity = Velocities[EntityIndex].Value;
+			FlowVelocity[CellIndex] = (FlowVelocity[CellIndex] * OldPopulation + FVector2f(Velocity.X, Velocity.Y)) / (OldPopulation + 1.f);
+			Population[CellIndex] = OldPopulation + 1.f;
+
+			EntitiesToFold.Add(Context.GetEntity(EntityIndex));
+		}
+	});
+
+	if (EntitiesToFold.Num() > 0)
+	{
+		EntityManager.BatchDestroyEntities(EntitiesToFold);
+		INC_DWORD_STAT_BY(STAT_MTGAggregateFolded, EntitiesToFold.Num());
+	}
+}
+
+void UMTGAggregateSubsystem::ExpandNearbyCells(const FVector& CameraLocation)
+{
+	const UWorld* World = GetWorld();
+	const UMassEntityConfigAsset* EntityConfig = WandererEntityConfig.LoadSynchronous();
+	UMassSpawnerSubsystem* SpawnerSubsystem = World->GetSubsystem<UMassSpawnerSubsystem>();
+	UMassEntitySubsystem* EntitySubsystem = World->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntityConfig) || !ensure(SpawnerSubsystem) || !ensure(EntitySubsystem))
+	{
+		return;
+	}
+
+	// Only visit the cells that can be within ExpandDistance
+	const int32 CameraCellIndex = GetClampedCellIndex(CameraLocation);
+	const int32 CameraX = CameraCellIndex % NumCells1D;
+	const int32 CameraY = CameraCellIndex / NumCells1D;
+	const int32 CellRadius = FMath::CeilToInt32(ExpandDistance / CellSize) + 1;
+	const FVector2D Camera2D(CameraLocation);
+
+	FMassTransformsSpawnData SpawnData;
+	SpawnData.bRandomize = false;  // Entity N must get transform N, to match SpawnVelocities
+	TArray<FVector2f, FMTGFrameArenaAllocator> SpawnVelocities;
+
+	for (int32 Y = FMath::Max(0, CameraY - CellRadius); Y <= FMath::Min(NumCells1D - 1, CameraY + CellRadius) && SpawnData.Transforms.Num() < MaxExpandsPerTick; ++Y)
+	{
+		for (int32 X = FMath::Max(0, CameraX - CellRadius); X <= FMath::Min(NumCells1D - 1, CameraX + CellRadius); ++X)
+		{
+			const int32 CellIndex = Y * NumCells1D + X;
+			const FVector2D CellCenter = GetCellCenter(CellIndex);
+			if (Population[CellIndex] < 1.f || FVector2D::Distance(CellCenter, Camera2D) > ExpandDistance)
+			{
+				continue;
+			}
+
+			// Whole wanderers only; the fraction stays aggregated
+			const int32 NumToSpawn = FMath::Min(FMath::FloorToInt32(Population[CellIndex]), MaxExpandsPerTick - SpawnData.Transforms.Num());
+			for (int32 Index = 0; Index < NumToSpawn; ++Index)
+			{
+				const FVector Location(
+					CellCenter.X + RandomStream.FRandRange(-0.5f, 0.5f) * CellSize,
+					CellCenter.Y + RandomStream.FRandRange(-0.5f, 0.5f) * CellSize,
+					0.);  // Wanderers live on the ground plane
+				SpawnData.Transforms.Add(FTransform(Location));
+				SpawnVelocities.Add(FlowVelocity[CellIndex]);
+			}
+			Population[CellIndex] -= NumToSpawn;
+
+			if (SpawnData.Transforms.Num() >= MaxExpandsPerTick)
+			{
+				break;
+			}
+		}
+	}
+
+	if (SpawnData.Transforms.Num() == 0)
+	{
+		return;
+	}
+
+	const FMassEntityTemplate& EntityTemplate = EntityConfig->GetOrCreateEntityTemplate(*World);
+
+	TArray<FMassEntityHandle> SpawnedEntities;
+	SpawnerSubsystem->SpawnEntities(EntityTemplate.GetTemplateID(), SpawnData.Transforms.Num(), FConstStructView::Make(SpawnData), UMassSpawnLocationProcessor::StaticClass(), SpawnedEntities);
+
+	// Keep the cell's flow so expanded wanderers don't all start from a standstill
+	FMassEntityManager& EntityManager = EntitySubsystem->GetMutableEntityManager();
+	for (int32 Index = 0; Index < SpawnedEntities.Num(); ++Index)
+	{
+		if (FMassVelocityFragment* Velocity = EntityManager.GetFragmentDataPtr<FMassVelocityFragment>(SpawnedEntities[Index]))
+		{
+			Velocity->Value = FVector(SpawnVelocities[Index].X, SpawnVelocities[Index].Y, 0.);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_MTGAggregateExpanded, SpawnedEntities.Num());
+}
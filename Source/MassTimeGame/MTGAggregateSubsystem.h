@@ -0,0 +1,162 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassEntityHandle.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGAggregateSubsystem.generated.h"
+
+class UMassEntityConfigAsset;
+class UMTGSimTimeSubsystem;
+
+/**
+ * MTG Aggregate Subsystem
+ *
+ * Aggregate LOD for wanderers far from the camera (mtg.AggregateLOD).
+ *
+ * Wanderers farther than AggregateDistance from the camera are folded into a
+ * coarse grid of per-cell populations, each with a mean flow velocity, and
+ * their entities are destroyed.  The grid is simulated every
+ * AggregateStepSeconds of sim time: population flows to neighboring cells
+ * along the mean velocity, diffuses a little (wanderers wander), and the
+ * flow slowly decays.
+ *
+ * When the camera comes within ExpandDistance of a cell, its whole-number
+ * population is spawned back as individual wanderers at random positions in
+ * the cell, moving with the cell's flow.  ExpandDistance < AggregateDistance
+ * gives hysteresis, so wanderers near the boundary don't thrash.
+ *
+ * Per-entity cost is only paid near the camera, so the total population can
+ * be far larger than what Mass could simulate individually; see
+ * mtg.SeedAggregatePopulation.
+ *
+ * Folding and expanding are budgeted per sim tick, and happen at the tick
+ * boundary (OnSimTickCompleted) when Mass is not processing.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Aggregate Subsystem"))
+class MASSTIMEGAME_API UMTGAggregateSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGAggregateSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 * Add population spread evenly over every cell that is beyond ExpandDistance of the camera
+	 * @param Count Number of wanderers to add
+	 */
+	void SeedPopulation(int64 Count);
+
+	/**
+	 * Get the total aggregated population
+	 * @return Number of wanderers represented by the grid (may be fractional)
+	 */
+	double GetTotalPopulation() const;
+
+	/** Log the aggregate population and grid stats */
+	void LogStats() const;
+
+protected:
+	/** Entity config used to spawn expanded wanderers */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	TSoftObjectPtr<UMassEntityConfigAsset> WandererEntityConfig;
+
+	/** Wanderers farther than this (cm) from the camera are folded into the grid */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ForceUnits="cm"))
+	float AggregateDistance;
+
+	/** Cells closer than this (cm) to the camera are expanded; must be less than AggregateDistance */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ForceUnits="cm"))
+	float ExpandDistance;
+
+	/** Size (cm) of each aggregate cell */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=100, ForceUnits="cm"))
+	float CellSize;
+
+	/** The grid covers the square from -GridHalfExtent to +GridHalfExtent on X and Y */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=100, ForceUnits="cm"))
+	float GridHalfExtent;
+
+	/** Sim time (seconds) between aggregate simulation steps */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0.01, ForceUnits="s"))
+	float AggregateStepSeconds;
+
+	/** Fraction of each cell's population that wanders into its 4 neighbors per second */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ClampMax=1))
+	float DiffusionRate;
+
+	/** Seconds for a cell's flow velocity to decay to ~37% */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0.01, ForceUnits="s"))
+	float FlowDecaySeconds;
+
+	/** Maximum wanderers folded per sim tick */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	int32 MaxFoldsPerTick;
+
+	/** Maximum wanderers expanded per sim tick */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	int32 MaxExpandsPerTick;
+
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/**
+	 * Advance the aggregate populations
+	 * @param DeltaTime Sim time (seconds) to advance
+	 */
+	void StepAggregate(float DeltaTime);
+
+	/**
+	 * Fold wanderers beyond AggregateDistance into the grid
+	 * @param CameraLocation Current camera location
+	 */
+	void FoldDistantWanderers(const FVector& CameraLocation);
+
+	/**
+	 * Spawn wanderers for cells within ExpandDistance
+	 * @param CameraLocation Current camera location
+	 */
+	void ExpandNearbyCells(const FVector& CameraLocation);
+
+	/** @return Index of the cell containing Location, clamped to the grid */
+	int32 GetClampedCellIndex(const FVector& Location) const;
+
+	/** @return World XY center of the cell */
+	FVector2D GetCellCenter(int32 CellIndex) const;
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem since we use it every tick */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** Number of cells along X and Y */
+	int32 NumCells1D = 0;
+
+	/** Aggregated population per cell */
+	TArray<float> Population;
+
+	/** Mean XY velocity of each cell's population */
+	TArray<FVector2f> FlowVelocity;
+
+	/** Sim time accumulated toward the next aggregate step */
+	double AccumulatedStepTime = 0.;
+
+	/** Positions of expanded wanderers; seeded from the world seed */
+	FRandomStream RandomStream;
+
+	/** Reused handle buffer */
+	TArray<FMassEntityHandle> EntitiesToFold;
+};
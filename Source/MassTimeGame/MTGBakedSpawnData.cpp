@@ -0,0 +1,34 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGBakedSpawnData.h"
+
+#include "Serialization/CustomVersion.h"
+
+const FGuid FMTGBakedSpawnDataVersion::GUID(0x6A1C52E4, 0x3F0B4D97, 0x9E27B8C1, 0x54D0A6F3);
+
+static FCustomVersionRegistration GRegisterMTGBakedSpawnDataVersion(FMTGBakedSpawnDataVersion::GUID, FMTGBakedSpawnDataVersion::LatestVersion, TEXT("MTGBakedSpawnData"));
+
+void UMTGBakedSpawnData::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	Ar.UsingCustomVersion(FMTGBakedSpawnDataVersion::GUID);
+
+	if (Ar.IsLoading() && Ar.CustomVer(FMTGBakedSpawnDataVersion::GUID) < FMTGBakedSpawnDataVersion::BakedTransforms)
+	{
+		// Old payload: a location and a yaw per entity
+		TArray<FVector3f> Locations;
+		TArray<float> Yaws;
+		Locations.BulkSerialize(Ar);
+		Yaws.BulkSerialize(Ar);
+
+		Transforms.Reset(Locations.Num());
+		for (int32 Index = 0; Index < Locations.Num(); ++Index)
+		{
+			Transforms.Emplace(FRotator(0., Yaws.IsValidIndex(Index) ? Yaws[Index] : 0.f, 0.), FVector(Locations[Index]));
+		}
+		return;
+	}
+
+	Transforms.BulkSerialize(Ar);
+}
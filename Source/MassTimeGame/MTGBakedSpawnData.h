@@ -0,0 +1,73 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Engine/DataAsset.h"
+#include "Misc/Guid.h"
+#include "MTGBakedSpawnData.generated.h"
+
+class UMassEntityConfigAsset;
+
+/**
+ * Custom version of the UMTGBakedSpawnData bulk payload
+ */
+struct FMTGBakedSpawnDataVersion
+{
+	enum Type : int32
+	{
+		/** Locations and yaws, before the custom version was added */
+		BeforeCustomVersionWasAdded = 0,
+
+		/** Whole transforms, laid out like FTransformFragment */
+		BakedTransforms,
+
+		// -----<new versions can be added above this line>-------------------------------------------------
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	/** The GUID for this custom version number */
+	static const FGuid GUID;
+
+private:
+	FMTGBakedSpawnDataVersion() = delete;
+};
+
+/**
+ * MTG Baked Spawn Data
+ *
+ * The initial wanderer population of a map, baked with mtg.BakeSpawnData so
+ * that UMTGBakedSpawnSubsystem can create it at startup without running the
+ * map's spawn point generators.
+ *
+ * The transforms are bulk serialized in the same layout as FTransformFragment,
+ * so loading 100k entities is one memcpy from the file and one memcpy per chunk.
+ */
+UCLASS(meta=(DisplayName="MTG Baked Spawn Data"))
+class MASSTIMEGAME_API UMTGBakedSpawnData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	//~Begin UObject interface
+	virtual void Serialize(FArchive& Ar) override;
+	//~End UObject interface
+
+	/** The map this data was baked from */
+	UPROPERTY(VisibleAnywhere, Category="Xist")
+	TSoftObjectPtr<UWorld> Map;
+
+	/** Entity config to create the entities with */
+	UPROPERTY(EditAnywhere, Category="Xist")
+	TSoftObjectPtr<UMassEntityConfigAsset> EntityConfig;
+
+	/** Names of the map's Mass spawners that this data replaces; they won't auto spawn */
+	UPROPERTY(VisibleAnywhere, Category="Xist")
+	TArray<FName> ReplacedSpawnerNames;
+
+	/** Initial transform of each entity, copied as is into the FTransformFragment of the chunks */
+	TArray<FTransform> Transforms;
+
+	/** @return Number of baked entities */
+	int32 Num() const { return Transforms.Num(); }
+};
@@ -0,0 +1,341 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGBakedSpawnSubsystem.h"
+
+#include "EngineUtils.h"
+#include "MassCommonFragments.h"
+#include "MassEntityConfigAsset.h"
+#include "MassEntityManager.h"
+#include "MassEntityQuery.h"
+#include "MassEntitySubsystem.h"
+#include "MassEntitySpawnDataGeneratorBase.h"
+#include "MassExecutionContext.h"
+#include "MassSpawner.h"
+#include "MassSpawnerSubsystem.h"
+#include "MassSpawnerTypes.h"
+#include "MassTimeGame.h"
+#include "MTGBakedSpawnData.h"
+#include "MTGSimTimeSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/Package.h"
+#if WITH_EDITOR
+#include "UObject/SavePackage.h"
+#endif
+
+DECLARE_CYCLE_STAT(TEXT("MTG Baked Spawn"), STAT_MTGBakedSpawn, STATGROUP_MassTimeGame);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("MTG Level Ready To First Sim Tick (ms)"), STAT_MTGLevelReadyToFirstSimTick, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::BakedSpawn
+{
+#if WITH_EDITOR
+	static FAutoConsoleCommandWithWorldAndArgs CmdBakeSpawnData(
+		TEXT("mtg.BakeSpawnData"),
+		TEXT("Bake the spawn data generated by this world's Mass spawners into a spawn data asset. Usage: mtg.BakeSpawnData /Game/Mass/DA_BakedSpawn_L_Default"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UMTGBakedSpawnSubsystem* BakedSpawnSubsystem = World ? World->GetSubsystem<UMTGBakedSpawnSubsystem>() : nullptr;
+			if (BakedSpawnSubsystem && Args.Num() > 0)
+			{
+				BakedSpawnSubsystem->BakeSpawnData(Args[0]);
+			}
+		}));
+#endif
+
+	/** @return Long package name of the world's map, without any PIE prefix */
+	static FString GetMapPackageName(const UWorld& World)
+	{
+		return UWorld::RemovePIEPrefix(World.GetOutermost()->GetName());
+	}
+
+#if WITH_EDITOR
+	/** Write the generated spawn data of a map into a baked spawn data asset, and save it */
+	static bool SaveBakedSpawnData(UWorld& World, const FString& PackageName, const TSoftObjectPtr<UMassEntityConfigAsset>& EntityConfig, const TArray<FName>& SpawnerNames, const TArray<TArray<FTransform>>& GeneratedTransforms);
+#endif
+}
+
+// Set Class Defaults
+UMTGBakedSpawnSubsystem::UMTGBakedSpawnSubsystem()
+{
+	SpawnBatchSize = 8192;
+}
+
+void UMTGBakedSpawnSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LevelReadyTime = FPlatformTime::Seconds();
+
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+	Collection.InitializeDependency<UMassSpawnerSubsystem>();
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+	}
+}
+
+void UMTGBakedSpawnSubsystem::Deinitialize()
+{
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+bool UMTGBakedSpawnSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMTGBakedSpawnSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const FString MapPackageName = UE::MTG::BakedSpawn::GetMapPackageName(InWorld);
+
+	for (const TSoftObjectPtr<UMTGBakedSpawnData>& SpawnDataPtr : BakedSpawnData)
+	{
+		const UMTGBakedSpawnData* SpawnData = SpawnDataPtr.LoadSynchronous();
+		if (!SpawnData || SpawnData->Map.ToSoftObjectPath().GetLongPackageName() != MapPackageName)
+		{
+			continue;
+		}
+
+		// This runs before the actors' BeginPlay, so the replaced spawners haven't spawned yet.
+		// bAutoSpawnOnBeginPlay isn't exposed to C++, so set it through reflection.
+		if (const FBoolProperty* AutoSpawnProperty = FindFProperty<FBoolProperty>(AMassSpawner::StaticClass(), TEXT("bAutoSpawnOnBeginPlay")))
+		{
+			for (TActorIterator<AMassSpawner> It(&InWorld); It; ++It)
+			{
+				if (SpawnData->ReplacedSpawnerNames.Contains(It->GetFName()))
+				{
+					AutoSpawnProperty->SetPropertyValue_InContainer(*It, false);
+				}
+			}
+		}
+
+		SpawnBakedEntities(*SpawnData);
+		break;
+	}
+}
+
+void UMTGBakedSpawnSubsystem::SpawnBakedEntities(const UMTGBakedSpawnData& SpawnData)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MTGBakedSpawn);
+
+	// The baked transforms are copied into the chunks as they are
+	static_assert(sizeof(FTransformFragment) == sizeof(FTransform), "FTransformFragment must be laid out like FTransform");
+
+	const UWorld* World = GetWorld();
+	const UMassEntityConfigAsset* EntityConfig = SpawnData.EntityConfig.LoadSynchronous();
+	UMassEntitySubsystem* EntitySubsystem = World->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntityConfig) || !ensure(EntitySubsystem))
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const FMassEntityTemplate& EntityTemplate = EntityConfig->GetOrCreateEntityTemplate(*World);
+	FMassEntityManager& EntityManager = EntitySubsystem->GetMutableEntityManager();
+
+	FMassEntityQuery Query(EntityManager.AsShared());
+	Query.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+
+	TArray<FMassEntityHandle> SpawnedEntities;
+
+	for (int32 Start = 0; Start < SpawnData.Num(); Start += SpawnBatchSize)
+	{
+		const int32 Count = FMath::Min(SpawnBatchSize, SpawnData.Num() - Start);
+		const FTransform* BatchTransforms = SpawnData.Transforms.GetData() + Start;
+
+		// Observers (initializers) run when the creation context is released, after the fragments are filled in
+		SpawnedEntities.Reset();
+		TSharedRef<FMassEntityManager::FEntityCreationContext> CreationContext = EntityManager.BatchCreateEntities(
+			EntityTemplate.GetArchetype(), EntityTemplate.GetSharedFragmentValues(), Count, SpawnedEntities);
+
+		const TConstArrayView<FMassArchetypeEntityCollection> Collections = CreationContext->GetEntityCollections(EntityManager);
+		EntityManager.BatchSetEntityFragmentValues(Collections, EntityTemplate.GetInitialFragmentValues());
+
+		// A batch fills the chunks in creation order, so each chunk holds a contiguous run of SpawnedEntities
+		int32 NextIndex = 0;
+		FMassExecutionContext ExecutionContext(EntityManager);
+		Query.ForEachEntityChunkInCollections(Collections, ExecutionContext, [&SpawnedEntities, &NextIndex, BatchTransforms](FMassExecutionContext& Context)
+		{
+			const TArrayView<FTransformFragment> Transforms = Context.GetMutableFragmentView<FTransformFragment>();
+			const FMassEntityHandle FirstEntity = Context.GetEntity(0);
+
+			const int32 FirstIndex = SpawnedEntities.IsValidIndex(NextIndex) && SpawnedEntities[NextIndex] == FirstEntity
+				? NextIndex
+				: SpawnedEntities.IndexOfByKey(FirstEntity);
+			if (!ensure(FirstIndex != INDEX_NONE && FirstIndex + Context.GetNumEntities() <= SpawnedEntities.Num()))
+			{
+				return;
+			}
+
+			FMemory::Memcpy(Transforms.GetData(), BatchTransforms + FirstIndex, Context.GetNumEntities() * sizeof(FTransformFragment));
+			NextIndex = FirstIndex + Context.GetNumEntities();
+		});
+	}
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Spawned %d baked entities in %.2f ms"), SpawnData.Num(), 1000. * (FPlatformTime::Seconds() - StartTime));
+}
+
+void UMTGBakedSpawnSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	if (LIKELY(SimTimeSubsystemIn->GetSimTickNumber() != 1))
+	{
+		return;
+	}
+
+	const float ElapsedMs = 1000. * (FPlatformTime::Seconds() - LevelReadyTime);
+	SET_FLOAT_STAT(STAT_MTGLevelReadyToFirstSimTick, ElapsedMs);
+	UE_LOG(LogMassTimeGame, Log, TEXT("Level ready to first sim tick: %.2f ms"), ElapsedMs);
+}
+
+#if WITH_EDITOR
+bool UMTGBakedSpawnSubsystem::BakeSpawnData(const FString& PackageName)
+{
+	using namespace UE::MTG::BakedSpawn;
+
+	UWorld* World = GetWorld();
+
+	// Neither is exposed to C++, so read them through reflection
+	const FArrayProperty* GeneratorsProperty = FindFProperty<FArrayProperty>(AMassSpawner::StaticClass(), TEXT("SpawnDataGenerators"));
+	const FArrayProperty* EntityTypesProperty = FindFProperty<FArrayProperty>(AMassSpawner::StaticClass(), TEXT("EntityTypes"));
+	if (!ensure(GeneratorsProperty) || !ensure(EntityTypesProperty))
+	{
+		return false;
+	}
+
+	/** Shared by every generator's completion callback; the last one to finish saves the asset */
+	struct FBakeState
+	{
+		TWeakObjectPtr<UWorld> World;
+		FString PackageName;
+		TSoftObjectPtr<UMassEntityConfigAsset> EntityConfig;
+		TArray<FName> SpawnerNames;
+
+		/** Transforms generated by each generator, in spawner and generator order */
+		TArray<TArray<FTransform>> GeneratedTransforms;
+		int32 NumPending = 1;
+	};
+	const TSharedRef<FBakeState> State = MakeShared<FBakeState>();
+	State->World = World;
+	State->PackageName = PackageName;
+
+	auto FinishOne = [State]()
+	{
+		if (--State->NumPending == 0 && State->World.IsValid())
+		{
+			SaveBakedSpawnData(*State->World, State->PackageName, State->EntityConfig, State->SpawnerNames, State->GeneratedTransforms);
+		}
+	};
+
+	for (TActorIterator<AMassSpawner> It(World); It; ++It)
+	{
+		AMassSpawner* Spawner = *It;
+		TArray<FMassSpawnDataGenerator>& Generators = *GeneratorsProperty->ContainerPtrToValuePtr<TArray<FMassSpawnDataGenerator>>(Spawner);
+		const TArray<FMassSpawnedEntityType>& EntityTypes = *EntityTypesProperty->ContainerPtrToValuePtr<TArray<FMassSpawnedEntityType>>(Spawner);
+		if (EntityTypes.Num() == 0)
+		{
+			continue;
+		}
+
+		// One entity config per asset: the first spawner's first entity type
+		if (State->EntityConfig.IsNull())
+		{
+			State->EntityConfig = EntityTypes[0].EntityConfig;
+		}
+		State->SpawnerNames.Add(Spawner->GetFName());
+
+		// Split the count over the generators the same way AMassSpawner::DoSpawning does
+		float TotalProportion = 0.f;
+		for (const FMassSpawnDataGenerator& Generator : Generators)
+		{
+			TotalProportion += Generator.GeneratorInstance ? Generator.Proportion : 0.f;
+		}
+
+		for (const FMassSpawnDataGenerator& Generator : Generators)
+		{
+			if (!Generator.GeneratorInstance || TotalProportion <= 0.f)
+			{
+				continue;
+			}
+
+			const int32 GeneratorIndex = State->GeneratedTransforms.AddDefaulted();
+			const int32 SpawnCount = FMath::CeilToInt32(Generator.Proportion / TotalProportion * Spawner->GetSpawnCount());
+			++State->NumPending;
+
+			// Generators may finish now or later (e.g. EQS), so results are kept per generator to keep the order stable
+			FFinishedGeneratingSpawnDataSignature OnFinished = FFinishedGeneratingSpawnDataSignature::CreateLambda(
+				[State, GeneratorIndex, FinishOne, EntityTypes](TConstArrayView<FMassEntitySpawnDataGeneratorResult> Results)
+				{
+					TArray<FTransform>& Transforms = State->GeneratedTransforms[GeneratorIndex];
+					for (const FMassEntitySpawnDataGeneratorResult& Result : Results)
+					{
+						const FMassTransformsSpawnData* SpawnData = Result.SpawnData.GetPtr<FMassTransformsSpawnData>();
+						if (!SpawnData
+							|| !EntityTypes.IsValidIndex(Result.EntityConfigIndex)
+							|| EntityTypes[Result.EntityConfigIndex].EntityConfig != State->EntityConfig)
+						{
+							UE_LOG(LogMassTimeGame, Warning, TEXT("Skipping %d generated entities that aren't transforms of [%s]"), Result.NumEntities, *State->EntityConfig.ToString());
+							continue;
+						}
+						Transforms.Append(SpawnData->Transforms);
+					}
+					FinishOne();
+				});
+			Generator.GeneratorInstance->Generate(*Spawner, EntityTypes, SpawnCount, OnFinished);
+		}
+	}
+
+	FinishOne();
+	return true;
+}
+
+bool UE::MTG::BakedSpawn::SaveBakedSpawnData(UWorld& World, const FString& PackageName, const TSoftObjectPtr<UMassEntityConfigAsset>& EntityConfig, const TArray<FName>& SpawnerNames, const TArray<TArray<FTransform>>& GeneratedTransforms)
+{
+	UPackage* Package = CreatePackage(*PackageName);
+	const FName AssetName(FPackageName::GetShortName(PackageName));
+
+	UMTGBakedSpawnData* SpawnData = FindObject<UMTGBakedSpawnData>(Package, *AssetName.ToString());
+	if (!SpawnData)
+	{
+		SpawnData = NewObject<UMTGBakedSpawnData>(Package, AssetName, RF_Public | RF_Standalone);
+	}
+
+	const FString MapPackageName = GetMapPackageName(World);
+	SpawnData->Map = TSoftObjectPtr<UWorld>(FSoftObjectPath(MapPackageName + TEXT(".") + FPackageName::GetShortName(MapPackageName)));
+	if (!EntityConfig.IsNull())
+	{
+		SpawnData->EntityConfig = EntityConfig;
+	}
+	SpawnData->ReplacedSpawnerNames = SpawnerNames;
+
+	SpawnData->Transforms.Reset();
+	for (const TArray<FTransform>& Transforms : GeneratedTransforms)
+	{
+		SpawnData->Transforms.Append(Transforms);
+	}
+
+	SpawnData->MarkPackageDirty();
+
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+	if (!UPackage::SavePackage(Package, SpawnData, *Filename, SaveArgs))
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Failed to save baked spawn data [%s]"), *Filename);
+		return false;
+	}
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Baked %d entities from %d spawners into [%s]; add it to MTGBakedSpawnSubsystem BakedSpawnData in DefaultMTG.ini"),
+		SpawnData->Num(), SpawnData->ReplacedSpawnerNames.Num(), *PackageName);
+	return true;
+}
+#endif
@@ -0,0 +1,86 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGBakedSpawnSubsystem.generated.h"
+
+class UMTGBakedSpawnData;
+class UMTGSimTimeSubsystem;
+
+/**
+ * MTG Baked Spawn Subsystem
+ *
+ * At BeginPlay, if one of the configured BakedSpawnData assets was baked from
+ * this map, its wanderers are created directly in batches of SpawnBatchSize:
+ * one BatchCreateEntities, the template's initial fragment values, and one
+ * memcpy of the baked transforms per chunk, like a sim save load.  No spawn
+ * location processor runs.  The Mass spawners it replaces are kept from auto
+ * spawning.
+ *
+ * Also measures "level ready to first sim tick": from world initialization
+ * to the end of the first sim tick, which includes all startup spawning.
+ *
+ * In the editor, mtg.BakeSpawnData runs the spawn data generators of the
+ * world's Mass spawners, exactly as the spawners would at BeginPlay, and saves
+ * what they generate into a UMTGBakedSpawnData asset.  It doesn't matter how
+ * long the world has been simulating.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Baked Spawn Subsystem"))
+class MASSTIMEGAME_API UMTGBakedSpawnSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGBakedSpawnSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~End UWorldSubsystem interface
+
+#if WITH_EDITOR
+	/**
+	 * Generate the spawn data of this world's Mass spawners and save it into an asset.
+	 * Generators may finish asynchronously (e.g. EQS); the asset is saved when the last one does.
+	 * @param PackageName Long package name of the asset, e.g. /Game/Mass/DA_BakedSpawn_L_Default
+	 * @return True if the generators were started, else False
+	 */
+	bool BakeSpawnData(const FString& PackageName);
+#endif
+
+protected:
+	/** Baked spawn data assets; the one whose Map is this world is used */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	TArray<TSoftObjectPtr<UMTGBakedSpawnData>> BakedSpawnData;
+
+	/** Entities created per batch */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	int32 SpawnBatchSize;
+
+	/**
+	 * Create the baked entities
+	 * @param SpawnData The baked data of this map
+	 */
+	void SpawnBakedEntities(const UMTGBakedSpawnData& SpawnData);
+
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** FPlatformTime::Seconds() when the world was initialized */
+	double LevelReadyTime = 0.;
+};
@@ -9,6 +9,9 @@
  * MTG Blueprint Helpers
  *
  * Thread-safe Animation Blueprint Helper library.
+ *
+ * Wanderer actor anims don't need to poll these every anim update; their
+ * freeze on pause and play rate are set by UMTGWandererAnimSubsystem.
  */
 UCLASS(meta=(BlueprintThreadSafe, DisplayName="MTG Blueprint Helpers"))
 class MASSTIMEGAME_API UMTGBlueprintHelpers : public UBlueprintFunctionLibrary
@@ -0,0 +1,256 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGChecksumSubsystem.h"
+
+#include "MassCommonFragments.h"
+#include "MassEntityManager.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutionContext.h"
+#include "MassMovementFragments.h"
+#include "MassTimeGame.h"
+#include "MTGMassFragments.h"
+#include "MTGSimTimeSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include <atomic>
+
+DECLARE_CYCLE_STAT(TEXT("MTG Checksum"), STAT_MTGChecksum, STATGROUP_MassTimeGame);
+
+// Log the checksums in their own category so they're easy to filter, or to silence
+DEFINE_LOG_CATEGORY_STATIC(LogMTGChecksum, Log, All);
+
+namespace UE::MTG::Checksum
+{
+	static bool bEnabled = false;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("mtg.Checksum"),
+		bEnabled,
+		TEXT("If true, log a checksum of all wanderer transforms and velocities every sim tick"));
+
+	static FAutoConsoleCommand CmdCompareChecksums(
+		TEXT("mtg.CompareChecksums"),
+		TEXT("Report the first sim tick at which 2 logs' SimChecksum lines differ. Usage: mtg.CompareChecksums LogA LogB"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.Num() == 2)
+			{
+				UMTGChecksumSubsystem::CompareChecksumLogs(Args[0], Args[1]);
+			}
+			else
+			{
+				UE_LOG(LogMTGChecksum, Error, TEXT("Usage: mtg.CompareChecksums LogA LogB"));
+			}
+		}));
+
+	/** Fold 64 bits into the hash */
+	FORCEINLINE uint64 Mix(uint64 Hash, const uint64 Bits)
+	{
+		Hash ^= Bits;
+		Hash *= 0x9E3779B97F4A7C15ull;
+		Hash ^= Hash >> 29;
+		return Hash;
+	}
+
+	/** Fold the exact bits of a double into the hash */
+	FORCEINLINE uint64 Mix(uint64 Hash, const double Value)
+	{
+		uint64 Bits;
+		FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+		return Mix(Hash, Bits);
+	}
+
+	/** Fold an entity's identity into the hash, so 2 entities swapping state changes it */
+	FORCEINLINE uint64 Mix(uint64 Hash, const FMassEntityHandle Entity)
+	{
+		return Mix(Hash, (static_cast<uint64>(static_cast<uint32>(Entity.SerialNumber)) << 32) | static_cast<uint32>(Entity.Index));
+	}
+
+	FORCEINLINE uint64 Mix(uint64 Hash, const FVector& Vector)
+	{
+		Hash = Mix(Hash, Vector.X);
+		Hash = Mix(Hash, Vector.Y);
+		return Mix(Hash, Vector.Z);
+	}
+
+	FORCEINLINE uint64 Mix(uint64 Hash, const FQuat& Quat)
+	{
+		Hash = Mix(Hash, Quat.X);
+		Hash = Mix(Hash, Quat.Y);
+		Hash = Mix(Hash, Quat.Z);
+		return Mix(Hash, Quat.W);
+	}
+
+	/** Parse all "SimChecksum Tick=N Hash=H" lines of a log into (Tick, Hash) pairs, in log order */
+	static bool ParseChecksumLog(const FString& Filename, TArray<TPair<uint64, FString>>& OutChecksums)
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *Filename))
+		{
+			UE_LOG(LogMTGChecksum, Error, TEXT("Failed to read checksum log [%s]"), *Filename);
+			return false;
+		}
+
+		for (const FString& Line : Lines)
+		{
+			if (!Line.Contains(TEXT("SimChecksum ")))
+			{
+				continue;
+			}
+
+			uint64 Tick = 0;
+			FString Hash;
+			if (FParse::Value(*Line, TEXT("Tick="), Tick)
+				&& FParse::Value(*Line, TEXT("Hash="), Hash))
+			{
+				OutChecksums.Emplace(Tick, MoveTemp(Hash));
+			}
+		}
+
+		return true;
+	}
+}
+
+void UMTGChecksumSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+	}
+}
+
+void UMTGChecksumSubsystem::Deinitialize()
+{
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+bool UMTGChecksumSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMTGChecksumSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	if (LIKELY(!UE::MTG::Checksum::bEnabled))
+	{
+		return;
+	}
+
+	int32 NumEntities = 0;
+	const uint64 Hash = ComputeChecksum(NumEntities);
+
+	UE_LOG(LogMTGChecksum, Log, TEXT("SimChecksum Tick=%llu Hash=%016llx Entities=%d"), SimTimeSubsystemIn->GetSimTickNumber(), Hash, NumEntities);
+}
+
+uint64 UMTGChecksumSubsystem::ComputeChecksum(int32& OutNumEntities) const
+{
+	using namespace UE::MTG::Checksum;
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGChecksum);
+
+	UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntitySubsystem))
+	{
+		OutNumEntities = 0;
+		return 0;
+	}
+
+	FMassEntityManager& EntityManager = EntitySubsystem->GetMutableEntityManager();
+
+	FMassEntityQuery Query(EntityManager.AsShared());
+	Query.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddRequirement<FMassVelocityFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+
+	// Addition is commutative, so each chunk can be hashed on any thread in any order;
+	// one atomic add per chunk is the only synchronization.  Each entity's hash starts
+	// from its handle, so swapped or renumbered entities still change the sum.
+	std::atomic<uint64> Sum {0};
+	std::atomic<int32> Count {0};
+
+	FMassExecutionContext ExecutionContext(EntityManager);
+	Query.ParallelForEachEntityChunk(ExecutionContext, [&Sum, &Count](FMassExecutionContext& Context)
+	{
+		const TConstArrayView<FMassEntityHandle> Entities = Context.GetEntities();
+		const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+		const TConstArrayView<FMassVelocityFragment> Velocities = Context.GetFragmentView<FMassVelocityFragment>();
+		const int32 NumEntities = Context.GetNumEntities();
+
+		uint64 ChunkSum = 0;
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			const FTransform& Transform = Transforms[EntityIndex].GetTransform();
+
+			uint64 EntityHash = 0xCBF29CE484222325ull;
+			EntityHash = Mix(EntityHash, Entities[EntityIndex]);
+			EntityHash = Mix(EntityHash, Transform.GetLocation());
+			EntityHash = Mix(EntityHash, Transform.GetRotation());
+			EntityHash = Mix(EntityHash, Transform.GetScale3D());
+			EntityHash = Mix(EntityHash, Velocities[EntityIndex].Value);
+
+			ChunkSum += EntityHash;
+		}
+
+		Sum.fetch_add(ChunkSum, std::memory_order_relaxed);
+		Count.fetch_add(NumEntities, std::memory_order_relaxed);
+	});
+
+	OutNumEntities = Count.load();
+	return Sum.load();
+}
+
+bool UMTGChecksumSubsystem::CompareChecksumLogs(const FString& LogFilenameA, const FString& LogFilenameB)
+{
+	using namespace UE::MTG::Checksum;
+
+	TArray<TPair<uint64, FString>> ChecksumsA;
+	TArray<TPair<uint64, FString>> ChecksumsB;
+
+	if (!ParseChecksumLog(LogFilenameA, ChecksumsA)
+		|| !ParseChecksumLog(LogFilenameB, ChecksumsB))
+	{
+		return false;
+	}
+
+	TMap<uint64, FString> HashesByTickB;
+	HashesByTickB.Reserve(ChecksumsB.Num());
+	for (const TPair<uint64, FString>& Checksum : ChecksumsB)
+	{
+		HashesByTickB.Add(Checksum.Key, Checksum.Value);
+	}
+
+	int32 NumCompared = 0;
+	for (const TPair<uint64, FString>& ChecksumA : ChecksumsA)
+	{
+		if (const FString* HashB = HashesByTickB.Find(ChecksumA.Key))
+		{
+			if (*HashB != ChecksumA.Value)
+			{
+				UE_LOG(LogMTGChecksum, Warning, TEXT("Runs DIVERGE at sim tick %llu (%s vs %s) after %d matching ticks"), ChecksumA.Key, *ChecksumA.Value, **HashB, NumCompared);
+				return false;
+			}
+			++NumCompared;
+		}
+	}
+
+	if (NumCompared == 0)
+	{
+		UE_LOG(LogMTGChecksum, Warning, TEXT("Logs have no sim ticks in common (%d vs %d checksums)"), ChecksumsA.Num(), ChecksumsB.Num());
+		return false;
+	}
+
+	UE_LOG(LogMTGChecksum, Log, TEXT("Runs match on all %d sim ticks they have in common"), NumCompared);
+	return true;
+}
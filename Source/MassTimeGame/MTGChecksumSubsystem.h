@@ -0,0 +1,70 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGChecksumSubsystem.generated.h"
+
+class UMTGSimTimeSubsystem;
+
+/**
+ * MTG Checksum Subsystem
+ *
+ * Optional determinism instrumentation.  When mtg.Checksum is enabled, once
+ * per sim tick this hashes the entity handle, transform and velocity of every
+ * wanderer and logs the result next to SimTickNumber:
+ *
+ *   SimChecksum Tick=1234 Hash=0123456789abcdef Entities=50000
+ *
+ * Run the same scenario twice (e.g. before/after an optimization, or with
+ * -nothreading vs. without) and then use mtg.CompareChecksums on the two
+ * logs to find the first tick where the simulations diverged.
+ *
+ * Each entity's hash includes its handle, and the per-entity hashes are
+ * summed, so the result does not depend on the order in which chunks are
+ * visited (which lets us reduce chunks in parallel) but does change if 2
+ * entities swap state.
+ */
+UCLASS(meta=(DisplayName="MTG Checksum Subsystem"))
+class MASSTIMEGAME_API UMTGChecksumSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 * Compute the checksum of all wanderer transforms and velocities right now.
+	 * MUST be called on the game thread while Mass is not processing.
+	 * @param OutNumEntities Number of entities that were hashed
+	 * @return The checksum
+	 */
+	uint64 ComputeChecksum(int32& OutNumEntities) const;
+
+	/**
+	 * Compare 2 logs containing SimChecksum lines, and log the first tick at which they diverge.
+	 * @param LogFilenameA The first log file
+	 * @param LogFilenameB The second log file
+	 * @return True if the runs match on every tick they have in common, else False
+	 */
+	static bool CompareChecksumLogs(const FString& LogFilenameA, const FString& LogFilenameB);
+
+protected:
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem so we can unregister */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+};
@@ -0,0 +1,207 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGCompactionSubsystem.h"
+
+#include "MassArchetypeData.h"
+#include "MassCommonFragments.h"
+#include "MassEntityManager.h"
+#include "MassEntityQuery.h"
+#include "MassEntitySubsystem.h"
+#include "MassTimeGame.h"
+#include "MTGSimTimeSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Chunk Compaction"), STAT_MTGChunkCompaction, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::Compaction
+{
+	static float TimeSliceMs = 0.5f;
+	static FAutoConsoleVariableRef CVarTimeSliceMs(
+		TEXT("mtg.Compaction.TimeSliceMs"),
+		TimeSliceMs,
+		TEXT("Milliseconds per sim tick that may be spent compacting archetype chunks while the sim is running. 0 disables time sliced compaction."));
+
+	/** Effectively unlimited; used when compacting while paused or on request */
+	static constexpr double UnlimitedSeconds = 3600.;
+
+	static FMassEntityManager* GetEntityManager(const UWorld* World)
+	{
+		UMassEntitySubsystem* EntitySubsystem = World ? World->GetSubsystem<UMassEntitySubsystem>() : nullptr;
+		return EntitySubsystem ? &EntitySubsystem->GetMutableEntityManager() : nullptr;
+	}
+
+	static FAutoConsoleCommandWithWorld CmdChunkOccupancy(
+		TEXT("mtg.ChunkOccupancy"),
+		TEXT("Log the chunk occupancy of every archetype with a transform"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (FMassEntityManager* EntityManager = GetEntityManager(World))
+			{
+				UMTGCompactionSubsystem::LogOccupancy(TEXT("Current"), UMTGCompactionSubsystem::GatherOccupancy(*EntityManager));
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorld CmdCompactMass(
+		TEXT("mtg.CompactMass"),
+		TEXT("Compact all archetype chunks now, and log occupancy before and after"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			FMassEntityManager* EntityManager = GetEntityManager(World);
+			UMTGCompactionSubsystem* CompactionSubsystem = World ? World->GetSubsystem<UMTGCompactionSubsystem>() : nullptr;
+			UMTGSimTimeSubsystem* SimTimeSubsystem = World ? World->GetSubsystem<UMTGSimTimeSubsystem>() : nullptr;
+			if (EntityManager && CompactionSubsystem && SimTimeSubsystem)
+			{
+				// Console commands run between frames, while pipelined processors or sim tick readers may still use the chunks
+				SimTimeSubsystem->FlushSimPipeline();
+
+				UMTGCompactionSubsystem::LogOccupancy(TEXT("Before"), UMTGCompactionSubsystem::GatherOccupancy(*EntityManager));
+
+				const double StartTime = FPlatformTime::Seconds();
+				CompactionSubsystem->Compact(UnlimitedSeconds);
+				UE_LOG(LogMassTimeGame, Log, TEXT("Compaction took %.2f ms"), 1000. * (FPlatformTime::Seconds() - StartTime));
+
+				UMTGCompactionSubsystem::LogOccupancy(TEXT("After"), UMTGCompactionSubsystem::GatherOccupancy(*EntityManager));
+			}
+		}));
+}
+
+// Set Class Defaults
+UMTGCompactionSubsystem::UMTGCompactionSubsystem()
+{
+	MinWastedChunks = 4;
+}
+
+void UMTGCompactionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+		SimTimeSubsystem->GetOnSimulationPaused().AddUObject(this, &ThisClass::NativeOnSimulationPaused);
+	}
+}
+
+void UMTGCompactionSubsystem::Deinitialize()
+{
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem->GetOnSimulationPaused().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+bool UMTGCompactionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TArray<FMTGArchetypeOccupancy> UMTGCompactionSubsystem::GatherOccupancy(FMassEntityManager& EntityManager)
+{
+	FMassEntityQuery Query(EntityManager.AsShared());
+	Query.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	Query.CacheArchetypes();
+
+	TArray<FMTGArchetypeOccupancy> Result;
+	for (const FMassArchetypeHandle& ArchetypeHandle : Query.GetArchetypes())
+	{
+		const FMassArchetypeData* ArchetypeData = FMassArchetypeHelper::ArchetypeDataFromHandle(ArchetypeHandle);
+		if (!ArchetypeData)
+		{
+			continue;
+		}
+
+		FMTGArchetypeOccupancy& Occupancy = Result.AddDefaulted_GetRef();
+#if WITH_MASSENTITY_DEBUG
+		Occupancy.Description = ArchetypeData->GetCompositionDescriptor().Fragments.DebugGetStringDesc();
+#else
+		Occupancy.Description = FString::Printf(TEXT("Archetype %08x"), GetTypeHash(ArchetypeHandle));
+#endif
+		Occupancy.NumEntities = ArchetypeData->GetNumEntities();
+		Occupancy.NumChunks = ArchetypeData->GetChunkCount();
+		Occupancy.EntitiesPerChunk = ArchetypeData->GetNumEntitiesPerChunk();
+	}
+
+	Result.Sort([](const FMTGArchetypeOccupancy& A, const FMTGArchetypeOccupancy& B)
+	{
+		return A.GetWastedChunks() > B.GetWastedChunks();
+	});
+
+	return Result;
+}
+
+void UMTGCompactionSubsystem::LogOccupancy(const TCHAR* Label, const TArray<FMTGArchetypeOccupancy>& Occupancy)
+{
+	int32 TotalChunks = 0;
+	int32 TotalWastedChunks = 0;
+
+	for (const FMTGArchetypeOccupancy& Archetype : Occupancy)
+	{
+		UE_LOG(LogMassTimeGame, Log, TEXT("%s: %6d entities in %5d chunks of %4d, occupancy %5.1f%%, %5d wasted chunks: %s"),
+			Label, Archetype.NumEntities, Archetype.NumChunks, Archetype.EntitiesPerChunk,
+			100.f * Archetype.GetOccupancy(), Archetype.GetWastedChunks(), *Archetype.Description);
+
+		TotalChunks += Archetype.NumChunks;
+		TotalWastedChunks += Archetype.GetWastedChunks();
+	}
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("%s: %d archetypes, %d chunks, %d wasted"), Label, Occupancy.Num(), TotalChunks, TotalWastedChunks);
+}
+
+void UMTGCompactionSubsystem::Compact(const double TimeAllowedSeconds)
+{
+	check(IsInGameThread());
+
+	FMassEntityManager* EntityManager = UE::MTG::Compaction::GetEntityManager(GetWorld());
+	if (!ensure(EntityManager) || !ensureMsgf(!EntityManager->IsProcessing(), TEXT("Cannot compact while Mass is processing")))
+	{
+		return;
+	}
+
+	// Background tasks don't count as Mass processing, but they do read and write chunks
+	if (!ensureMsgf(!SimTimeSubsystem || SimTimeSubsystem->IsSimPipelineIdle(), TEXT("Cannot compact while the sim pipeline is running; call FlushSimPipeline first")))
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGChunkCompaction);
+	EntityManager->DoEntityCompaction(TimeAllowedSeconds);
+}
+
+void UMTGCompactionSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	using namespace UE::MTG::Compaction;
+
+	if (TimeSliceMs <= 0.f || SimTimeSubsystemIn->ShouldYieldToInput())
+	{
+		return;
+	}
+
+	FMassEntityManager* EntityManager = GetEntityManager(GetWorld());
+	if (!EntityManager)
+	{
+		return;
+	}
+
+	// Only pay for compaction when there's a worthwhile amount of sparse memory
+	const TArray<FMTGArchetypeOccupancy> Occupancy = GatherOccupancy(*EntityManager);
+	if (Occupancy.Num() > 0 && Occupancy[0].GetWastedChunks() >= MinWastedChunks)
+	{
+		Compact(TimeSliceMs / 1000.);
+	}
+}
+
+void UMTGCompactionSubsystem::NativeOnSimulationPaused(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	// Nobody is waiting on the sim, so finish the job.  This can come at any time, so first
+	// wait for anything still using the chunks.
+	SimTimeSubsystemIn->FlushSimPipeline();
+	Compact(UE::MTG::Compaction::UnlimitedSeconds);
+}
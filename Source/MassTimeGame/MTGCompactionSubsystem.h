@@ -0,0 +1,112 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGCompactionSubsystem.generated.h"
+
+class UMTGSimTimeSubsystem;
+struct FMassEntityManager;
+
+/**
+ * Chunk occupancy of one Mass archetype
+ */
+struct FMTGArchetypeOccupancy
+{
+	/** Human readable description of the archetype */
+	FString Description;
+
+	int32 NumEntities = 0;
+	int32 NumChunks = 0;
+	int32 EntitiesPerChunk = 0;
+
+	/** @return Fewest chunks that could hold NumEntities */
+	int32 GetMinChunks() const { return EntitiesPerChunk > 0 ? FMath::DivideAndRoundUp(NumEntities, EntitiesPerChunk) : 0; }
+
+	/** @return Chunks that compaction could empty */
+	int32 GetWastedChunks() const { return FMath::Max(0, NumChunks - GetMinChunks()); }
+
+	/** @return Fraction (0..1) of chunk capacity in use */
+	float GetOccupancy() const { return NumChunks > 0 ? static_cast<float>(NumEntities) / (NumChunks * EntitiesPerChunk) : 1.f; }
+};
+
+/**
+ * MTG Compaction Subsystem
+ *
+ * Repacks partially filled archetype chunks after big spawn/despawn waves,
+ * so processors iterate dense memory again.
+ *
+ * Compaction is done by FMassEntityManager::DoEntityCompaction, which moves
+ * entities between chunks of the same archetype and updates each moved
+ * entity's handle mapping; FMassEntityHandles held elsewhere stay valid.
+ *
+ * It runs at sim tick boundaries only (never while Mass is processing):
+ * - While running, time sliced: at most mtg.Compaction.TimeSliceMs per tick,
+ *   and only while some archetype has at least MinWastedChunks to reclaim.
+ *   Ticks that yield to player input are skipped.
+ * - When the sim is paused, to completion.
+ *
+ * mtg.ChunkOccupancy reports per archetype occupancy, and mtg.CompactMass
+ * compacts immediately, reporting occupancy before and after.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Compaction Subsystem"))
+class MASSTIMEGAME_API UMTGCompactionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGCompactionSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 * Gather the chunk occupancy of every archetype with a transform
+	 * @param EntityManager The entity manager to inspect
+	 * @return One entry per archetype, most wasted chunks first
+	 */
+	static TArray<FMTGArchetypeOccupancy> GatherOccupancy(FMassEntityManager& EntityManager);
+
+	/**
+	 * Log an occupancy report
+	 * @param Label Prefix for the log lines (e.g. "Before")
+	 * @param Occupancy Result of GatherOccupancy
+	 */
+	static void LogOccupancy(const TCHAR* Label, const TArray<FMTGArchetypeOccupancy>& Occupancy);
+
+	/**
+	 * Compact now.  MUST be called on the game thread while Mass is not processing,
+	 * and after UMTGSimTimeSubsystem::FlushSimPipeline if outside of a sim tick boundary.
+	 * @param TimeAllowedSeconds Time budget; compaction resumes where it left off next time
+	 */
+	void Compact(double TimeAllowedSeconds);
+
+protected:
+	/** Only compact while running if some archetype could free at least this many chunks */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	int32 MinWastedChunks;
+
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/**
+	 * Callback from MTGSimTimeSubsystem when the sim pauses
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimulationPaused(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+};
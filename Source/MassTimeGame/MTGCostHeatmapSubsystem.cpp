@@ -0,0 +1,256 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGCostHeatmapSubsystem.h"
+
+#include "DrawDebugHelpers.h"
+#include "MassCommonFragments.h"
+#include "MassTimeGame.h"
+#include "MTGSimTimeSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTLS.h"
+#include <atomic>
+
+namespace UE::MTG::CostHeatmap
+{
+	static FAutoConsoleCommandWithWorld CmdCostHeatmap(
+		TEXT("mtg.CostHeatmap"),
+		TEXT("Toggle the Mass processing cost heatmap overlay"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (UMTGCostHeatmapSubsystem* HeatmapSubsystem = World ? World->GetSubsystem<UMTGCostHeatmapSubsystem>() : nullptr)
+			{
+				HeatmapSubsystem->SetOverlayVisible(!HeatmapSubsystem->IsOverlayVisible());
+			}
+		}));
+
+	/** Key for the on screen legend, so it replaces itself every frame */
+	static constexpr int32 LegendMessageKey = 0x4D544748;  // "MTGH"
+
+	/** Source of UMTGCostHeatmapSubsystem::PendingCyclesSerial; never 0, which no thread cache matches */
+	static std::atomic<uint32> NextPendingCyclesSerial {1};
+
+	/** Each thread remembers its pending cycles grid of the heatmap it last recorded to */
+	struct FThreadPendingCycles
+	{
+		uint32 Serial = 0;
+		TArray<double>* Cycles = nullptr;
+	};
+	static thread_local FThreadPendingCycles ThreadPendingCycles;
+}
+
+// Set Class Defaults
+UMTGCostHeatmapSubsystem::UMTGCostHeatmapSubsystem()
+{
+	CellSize = 1000.f;
+	GridHalfExtent = 50000.f;
+	SampleEveryNTicks = 4;
+	SmoothingFactor = 0.2f;
+	MinDrawFraction = 0.05f;
+	DrawHeight = 50.f;
+}
+
+void UMTGCostHeatmapSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	NumCells1D = FMath::Max(1, FMath::CeilToInt32(2.f * GridHalfExtent / CellSize));
+	CellCostMs.SetNumZeroed(NumCells1D * NumCells1D);
+	PendingCyclesSerial = UE::MTG::CostHeatmap::NextPendingCyclesSerial++;
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+		SimTimeSubsystem->GetOnTimeDilationChanged().AddUObject(this, &ThisClass::NativeOnTimeDilationChanged);
+	}
+}
+
+void UMTGCostHeatmapSubsystem::Deinitialize()
+{
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem->GetOnTimeDilationChanged().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	bIsSampling = false;
+	bOverlayVisible = false;
+
+	// No thread may keep using the freed grids
+	PendingCyclesSerial = UE::MTG::CostHeatmap::NextPendingCyclesSerial++;
+	PendingCycles.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UMTGCostHeatmapSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMTGCostHeatmapSubsystem::SetOverlayVisible(const bool bVisible)
+{
+	if (bOverlayVisible != bVisible)
+	{
+		bOverlayVisible = bVisible;
+		ResetHeatmap();
+
+		// Sampling starts/stops at the next tick boundary, so no processor sees it change mid-tick
+		UE_LOG(LogMassTimeGame, Log, TEXT("Cost heatmap %s"), bOverlayVisible ? TEXT("shown") : TEXT("hidden"));
+	}
+}
+
+TArray<double>& UMTGCostHeatmapSubsystem::GetThreadPendingCycles()
+{
+	using namespace UE::MTG::CostHeatmap;
+
+	if (LIKELY(ThreadPendingCycles.Serial == PendingCyclesSerial))
+	{
+		return *ThreadPendingCycles.Cycles;
+	}
+
+	// First record from this thread (or it last recorded to another heatmap); only now is there a lock
+	FScopeLock Lock(&PendingLock);
+	TUniquePtr<TArray<double>>& Cycles = PendingCycles.FindOrAdd(FPlatformTLS::GetCurrentThreadId());
+	if (!Cycles)
+	{
+		Cycles = MakeUnique<TArray<double>>();
+		Cycles->SetNumZeroed(NumCells1D * NumCells1D);
+	}
+
+	ThreadPendingCycles.Serial = PendingCyclesSerial;
+	ThreadPendingCycles.Cycles = Cycles.Get();
+	return *Cycles;
+}
+
+void UMTGCostHeatmapSubsystem::RecordCost(const TConstArrayView<FTransformFragment> Transforms, const uint64 Cycles)
+{
+	if (Transforms.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<double>& ThreadCycles = GetThreadPendingCycles();
+
+	const double InvCellSize = 1. / CellSize;
+	const double CyclesPerEntity = static_cast<double>(Cycles) / Transforms.Num();
+
+	for (const FTransformFragment& Transform : Transforms)
+	{
+		const FVector Location = Transform.GetTransform().GetLocation();
+		const int32 X = FMath::FloorToInt32((Location.X + GridHalfExtent) * InvCellSize);
+		const int32 Y = FMath::FloorToInt32((Location.Y + GridHalfExtent) * InvCellSize);
+		if (FMath::IsWithin(X, 0, NumCells1D) && FMath::IsWithin(Y, 0, NumCells1D))
+		{
+			ThreadCycles[Y * NumCells1D + X] += CyclesPerEntity;
+		}
+	}
+}
+
+void UMTGCostHeatmapSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	if (LIKELY(!bOverlayVisible))
+	{
+		bIsSampling = false;
+		return;
+	}
+
+	if (bIsSampling || bDiscardPendingCycles)
+	{
+		// No processor is running at the tick boundary, so the pending cycles are complete; merge the threads' grids
+		const double MsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000.;
+		for (int32 CellIndex = 0; CellIndex < CellCostMs.Num(); ++CellIndex)
+		{
+			double CellCycles = 0.;
+			for (const TPair<uint32, TUniquePtr<TArray<double>>>& Pair : PendingCycles)
+			{
+				CellCycles += (*Pair.Value)[CellIndex];
+			}
+
+			if (!bDiscardPendingCycles)
+			{
+				const float SampleMs = static_cast<float>(CellCycles * MsPerCycle);
+				CellCostMs[CellIndex] = FMath::Lerp(CellCostMs[CellIndex], SampleMs, SmoothingFactor);
+			}
+		}
+
+		for (const TPair<uint32, TUniquePtr<TArray<double>>>& Pair : PendingCycles)
+		{
+			FMemory::Memzero(Pair.Value->GetData(), Pair.Value->NumBytes());
+		}
+		bDiscardPendingCycles = false;
+	}
+
+	bIsSampling = (SimTimeSubsystemIn->GetSimTickNumber() + 1) % SampleEveryNTicks == 0;
+}
+
+void UMTGCostHeatmapSubsystem::NativeOnTimeDilationChanged(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	// Cost per tick depends on the sim speed; start over rather than blend two speeds together
+	ResetHeatmap();
+}
+
+void UMTGCostHeatmapSubsystem::ResetHeatmap()
+{
+	FMemory::Memzero(CellCostMs.GetData(), CellCostMs.NumBytes());
+
+	// Processors may still be recording into the pending cycles; they're dropped at the next tick boundary
+	bDiscardPendingCycles = true;
+}
+
+void UMTGCostHeatmapSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (UNLIKELY(bOverlayVisible))
+	{
+		DrawOverlay();
+	}
+}
+
+void UMTGCostHeatmapSubsystem::DrawOverlay() const
+{
+#if ENABLE_DRAW_DEBUG
+	const UWorld* World = GetWorld();
+
+	float MaxCostMs = 0.f;
+	float TotalCostMs = 0.f;
+	for (const float CostMs : CellCostMs)
+	{
+		MaxCostMs = FMath::Max(MaxCostMs, CostMs);
+		TotalCostMs += CostMs;
+	}
+
+	if (GEngine)
+	{
+		GEngine->AddOnScreenDebugMessage(UE::MTG::CostHeatmap::LegendMessageKey, 0.f, FColor::White,
+			FString::Printf(TEXT("Cost heatmap @ %.3fx: %.3f ms/tick sampled, hottest cell %.4f ms"),
+				SimTimeSubsystem ? SimTimeSubsystem->GetSimTimeDilation() : 1.f, TotalCostMs, MaxCostMs));
+	}
+
+	if (MaxCostMs <= 0.f)
+	{
+		return;
+	}
+
+	const FVector Extent(0.45 * CellSize, 0.45 * CellSize, 1.);
+	for (int32 Y = 0; Y < NumCells1D; ++Y)
+	{
+		for (int32 X = 0; X < NumCells1D; ++X)
+		{
+			const float Fraction = CellCostMs[Y * NumCells1D + X] / MaxCostMs;
+			if (Fraction < MinDrawFraction)
+			{
+				continue;
+			}
+
+			const FVector Center((X + 0.5) * CellSize - GridHalfExtent, (Y + 0.5) * CellSize - GridHalfExtent, DrawHeight);
+			const FColor Color = FLinearColor::LerpUsingHSV(FLinearColor::Blue, FLinearColor::Red, Fraction).CopyWithNewOpacity(0.5f).ToFColor(true);
+			DrawDebugSolidBox(World, Center, Extent, Color, false, -1.f, SDPG_Foreground);
+		}
+	}
+#endif
+}
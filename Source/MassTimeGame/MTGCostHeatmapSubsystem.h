@@ -0,0 +1,191 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassExternalSubsystemTraits.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGCostHeatmapSubsystem.generated.h"
+
+class UMTGSimTimeSubsystem;
+struct FTransformFragment;
+
+/**
+ * MTG Cost Heatmap Subsystem
+ *
+ * Shows where in the world the Mass processing time goes.
+ *
+ * While the overlay is visible, every SampleEveryNTicks'th sim tick the MTG
+ * processors time each chunk range they process (FMTGCostSampleScope) and
+ * report it here.  Each range's time is split evenly over its entities and
+ * added to the world-space cells they are in, so a crowd piled up at a click
+ * destination shows up as a hot spot no matter which chunks its entities
+ * happen to live in.  Every thread adds into its own partial grid without
+ * locking; the partial grids are merged at the sim tick boundary.
+ *
+ * The cells are smoothed over time and drawn as a debug overlay from above,
+ * scaled to the hottest cell.  The map resets when the sim speed changes, so
+ * it always shows the cost at the current speed.
+ *
+ * Toggle it with the sim control widget's HeatmapCheckBox, or mtg.CostHeatmap.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Cost Heatmap Subsystem"))
+class MASSTIMEGAME_API UMTGCostHeatmapSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGCostHeatmapSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	//~Begin UTickableWorldSubsystem interface
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UMTGCostHeatmapSubsystem, STATGROUP_Tickables); }
+	virtual void Tick(float DeltaTime) override;
+	//~End UTickableWorldSubsystem interface
+
+	/**
+	 * Is the overlay visible (and thus, is sampling enabled)?
+	 * @return True if visible, else False
+	 */
+	bool IsOverlayVisible() const { return bOverlayVisible; }
+
+	/**
+	 * Show or hide the overlay
+	 * @param bVisible True to show, False to hide
+	 */
+	void SetOverlayVisible(bool bVisible);
+
+	/**
+	 * Should processors time their chunks this sim tick?
+	 * Only changes at sim tick boundaries, so any thread may read it during processing.
+	 * @return True if sampling, else False
+	 */
+	bool IsSampling() const { return bIsSampling; }
+
+	/**
+	 * Attribute processing time to the cells of a range of entities.  Thread safe.
+	 * @param Transforms The entities that were processed
+	 * @param Cycles Time it took, in FPlatformTime cycles
+	 */
+	void RecordCost(TConstArrayView<FTransformFragment> Transforms, uint64 Cycles);
+
+protected:
+	/** Size (cm) of one heatmap cell */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=100))
+	float CellSize;
+
+	/** The grid covers -GridHalfExtent .. +GridHalfExtent in X and Y */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=100))
+	float GridHalfExtent;
+
+	/** Sample one sim tick out of this many, to keep the timing overhead low */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	int32 SampleEveryNTicks;
+
+	/** Weight (0..1) of each new sample in the smoothed cell cost */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0.01, ClampMax=1))
+	float SmoothingFactor;
+
+	/** Don't draw cells below this fraction of the hottest cell */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ClampMax=1))
+	float MinDrawFraction;
+
+	/** World Z at which the overlay is drawn */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	float DrawHeight;
+
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/**
+	 * Callback from MTGSimTimeSubsystem when the sim speed changes
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnTimeDilationChanged(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/** Clear the smoothed costs */
+	void ResetHeatmap();
+
+	/** Draw the overlay for this frame */
+	void DrawOverlay() const;
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** Cells per side of the grid */
+	int32 NumCells1D = 0;
+
+	/**
+	 * Cycles recorded this sim tick, per cell, one grid per recording thread (keyed by thread id),
+	 * so RecordCost never contends.  Summed and zeroed at the tick boundary.
+	 * The map itself is guarded by PendingLock; each grid is only written by its own thread.
+	 */
+	TMap<uint32, TUniquePtr<TArray<double>>> PendingCycles;
+	FCriticalSection PendingLock;
+
+	/** Identifies this subsystem's PendingCycles in each thread's cache; changes whenever they're freed */
+	uint32 PendingCyclesSerial = 0;
+
+	/** Should the next tick boundary drop the pending cycles instead of blending them in? */
+	bool bDiscardPendingCycles = false;
+
+	/** @return The calling thread's grid in PendingCycles, created on first use */
+	TArray<double>& GetThreadPendingCycles();
+
+	/** Smoothed cost (ms per sampled tick) per cell */
+	TArray<float> CellCostMs;
+
+	bool bOverlayVisible = false;
+	bool bIsSampling = false;
+};
+
+/** RecordCost is thread safe, so processors may use it from any thread */
+template<>
+struct TMassExternalSubsystemTraits<UMTGCostHeatmapSubsystem> final
+{
+	enum
+	{
+		GameThreadOnly = false,
+		ThreadSafeWrite = true,
+	};
+};
+
+/**
+ * Times a processor's work on a range of entities and reports it to the heatmap,
+ * if it is sampling this tick.  Otherwise this costs a null check.
+ */
+struct FMTGCostSampleScope
+{
+	FMTGCostSampleScope(UMTGCostHeatmapSubsystem* InHeatmap, TConstArrayView<FTransformFragment> InTransforms)
+		: Heatmap(InHeatmap && InHeatmap->IsSampling() ? InHeatmap : nullptr)
+		, Transforms(InTransforms)
+		, StartCycles(Heatmap ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FMTGCostSampleScope()
+	{
+		if (Heatmap)
+		{
+			Heatmap->RecordCost(Transforms, FPlatformTime::Cycles64() - StartCycles);
+		}
+	}
+
+private:
+	UMTGCostHeatmapSubsystem* Heatmap;
+	TConstArrayView<FTransformFragment> Transforms;
+	uint64 StartCycles;
+};
@@ -0,0 +1,153 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGCrowdDensityProcessor.h"
+
+#include "MassCommonFragments.h"
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+#include "MassMovementFragments.h"
+#include "MassTimeGame.h"
+#include "MTGCostHeatmapSubsystem.h"
+#include "MTGCrowdDensitySubsystem.h"
+#include "MTGMassFragments.h"
+#include "MTGSimTimeSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Crowd Density"), STAT_MTGCrowdDensity, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::CrowdDensity
+{
+	/** Entities per work item when splitting chunks */
+	static constexpr int32 RangeSize = 1024;
+
+	/** Most partial grids to accumulate into, however many workers there are; each is a full copy of the grid */
+	static constexpr int32 MaxPartialGrids = 8;
+
+	/** Fixed point scale of the velocity sums; integer sums are the same in any order */
+	static constexpr double VelocityScale = 256.;
+}
+
+// Set Class Defaults
+UMTGCrowdDensityProcessor::UMTGCrowdDensityProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+
+	// Everything that samples the grid runs in these groups
+	ExecutionOrder.ExecuteBefore.Add(UE::Mass::ProcessorGroupNames::Behavior);
+	ExecutionOrder.ExecuteBefore.Add(UE::Mass::ProcessorGroupNames::Movement);
+}
+
+void UMTGCrowdDensityProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FMassVelocityFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+	EntityQuery.AddSubsystemRequirement<UMTGCrowdDensitySubsystem>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddSubsystemRequirement<UMTGCostHeatmapSubsystem>(EMassFragmentAccess::ReadWrite);
+}
+
+void UMTGCrowdDensityProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	using namespace UE::MTG::CrowdDensity;
+
+	if (UMTGSimTimeSubsystem::IsDeferredToSimPipeline(Context.GetWorld()))
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGCrowdDensity);
+
+	UMTGCrowdDensitySubsystem* DensitySubsystem = Context.GetMutableSubsystem<UMTGCrowdDensitySubsystem>();
+	if (!ensure(DensitySubsystem))
+	{
+		return;
+	}
+
+	// Every scratch array below lives until the next tick boundary at most
+	FMTGFrameArenas* FrameArenas = UMTGSimTimeSubsystem::FindFrameArenas(Context.GetWorld());
+	FMTGFrameArenaScope ArenaScope(FrameArenas);
+
+	TArray<FEntityRange, FMTGFrameArenaAllocator> EntityRanges;
+
+	EntityQuery.ForEachEntityChunk(Context, [&EntityRanges](FMassExecutionContext& Context)
+	{
+		const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+		const TConstArrayView<FMassVelocityFragment> Velocities = Context.GetFragmentView<FMassVelocityFragment>();
+
+		const int32 NumEntities = Context.GetNumEntities();
+		for (int32 Start = 0; Start < NumEntities; Start += RangeSize)
+		{
+			FEntityRange& Range = EntityRanges.AddDefaulted_GetRef();
+			Range.Transforms = &Transforms[Start];
+			Range.Velocities = &Velocities[Start];
+			Range.Num = FMath::Min(RangeSize, NumEntities - Start);
+		}
+	});
+
+	FMTGCrowdDensityGrid& Grid = DensitySubsystem->BeginBuild();
+	const int32 NumCells = Grid.Num();
+
+	// A fixed number of bins, each with its own partial grid; each bin takes every NumBins'th range.
+	// More bins than MaxPartialGrids would cost more in zeroing and merging than they save.
+	const int32 MaxBins = FMath::Min(MaxPartialGrids, FTaskGraphInterface::Get().GetNumWorkerThreads() + 1);
+	const int32 NumBins = FMath::Clamp(EntityRanges.Num(), 1, MaxBins);
+	TArray<FPartialGrid, FMTGFrameArenaAllocator> PartialGrids;
+	PartialGrids.SetNum(NumBins);
+
+	UMTGCostHeatmapSubsystem* Heatmap = Context.GetMutableSubsystem<UMTGCostHeatmapSubsystem>();
+
+	ParallelFor(TEXT("MTGCrowdDensity.Accumulate"), NumBins, 1, [FrameArenas, &EntityRanges, &PartialGrids, &Grid, NumBins, NumCells, Heatmap](int32 BinIndex)
+	{
+		FMTGFrameArenaScope WorkerArenaScope(FrameArenas);
+
+		FPartialGrid& Partial = PartialGrids[BinIndex];
+		Partial.Count.SetNumUninitialized(NumCells);
+		Partial.VelocitySum.SetNumUninitialized(NumCells);
+		FMemory::Memzero(Partial.Count.GetData(), Partial.Count.NumBytes());
+		FMemory::Memzero(Partial.VelocitySum.GetData(), Partial.VelocitySum.NumBytes());
+
+		for (int32 RangeIndex = BinIndex; RangeIndex < EntityRanges.Num(); RangeIndex += NumBins)
+		{
+			const FEntityRange& Range = EntityRanges[RangeIndex];
+			FMTGCostSampleScope CostSample(Heatmap, TConstArrayView<FTransformFragment>(Range.Transforms, Range.Num));
+
+			for (int32 Index = 0; Index < Range.Num; ++Index)
+			{
+				const int32 CellIndex = Grid.GetCellIndex(Range.Transforms[Index].GetTransform().GetLocation());
+				if (CellIndex != INDEX_NONE)
+				{
+					const FVector& Velocity = Range.Velocities[Index].Value;
+					Partial.Count[CellIndex] += 1;
+					Partial.VelocitySum[CellIndex] += FInt64Vector2(FMath::RoundToInt64(Velocity.X * VelocityScale), FMath::RoundToInt64(Velocity.Y * VelocityScale));
+				}
+			}
+		}
+	});
+
+	// Merge, one grid row per work item. Cost is cells x bins, independent of entity count or clustering.
+	ParallelFor(TEXT("MTGCrowdDensity.Merge"), Grid.NumY, 1, [&PartialGrids, &Grid, NumBins](int32 Y)
+	{
+		const int32 RowStart = Y * Grid.NumX;
+		for (int32 CellIndex = RowStart; CellIndex < RowStart + Grid.NumX; ++CellIndex)
+		{
+			int32 Count = 0;
+			FInt64Vector2 VelocitySum(0, 0);
+			for (int32 BinIndex = 0; BinIndex < NumBins; ++BinIndex)
+			{
+				Count += PartialGrids[BinIndex].Count[CellIndex];
+				VelocitySum += PartialGrids[BinIndex].VelocitySum[CellIndex];
+			}
+
+			const double VelocityDivisor = Count * VelocityScale;
+			Grid.Density[CellIndex] = static_cast<float>(Count);
+			Grid.AverageVelocity[CellIndex] = Count > 0
+				? FVector2f(static_cast<float>(VelocitySum.X / VelocityDivisor), static_cast<float>(VelocitySum.Y / VelocityDivisor))
+				: FVector2f::ZeroVector;
+		}
+	});
+
+	DensitySubsystem->EndBuild();
+}
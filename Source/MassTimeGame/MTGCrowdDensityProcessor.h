@@ -0,0 +1,63 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassProcessor.h"
+#include "MTGFrameArena.h"
+#include "MTGCrowdDensityProcessor.generated.h"
+
+struct FMassVelocityFragment;
+struct FTransformFragment;
+
+/**
+ * MTG Crowd Density Processor
+ *
+ * Rebuilds the UMTGCrowdDensitySubsystem grid once per sim tick, before
+ * behavior and movement run.
+ *
+ * The entities are split over a fixed number of bins (MaxPartialGrids, fewer
+ * on machines with fewer workers).  Each bin accumulates its share into a
+ * private partial grid, then the partial grids are summed cell by cell.  There
+ * are no atomics and no shared cells, so the cost per entity is the same no
+ * matter how many entities pile into one cell, and the scratch memory is
+ * bounded by the grid size, not the core count.
+ *
+ * Partial sums are integers (velocities in fixed point), so the result doesn't
+ * depend on how many workers there are or which entities each one got: the
+ * grid is bit identical from run to run and machine to machine.
+ */
+UCLASS()
+class MASSTIMEGAME_API UMTGCrowdDensityProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGCrowdDensityProcessor();
+
+protected:
+	//~Begin UMassProcessor interface
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+	//~End UMassProcessor interface
+
+	FMassEntityQuery EntityQuery;
+
+private:
+	/** A contiguous run of entities, all from the same chunk */
+	struct FEntityRange
+	{
+		const FTransformFragment* Transforms = nullptr;
+		const FMassVelocityFragment* Velocities = nullptr;
+		int32 Num = 0;
+	};
+
+	/** One bin's private accumulation grid, in its worker's frame arena */
+	struct FPartialGrid
+	{
+		TArray<int32, FMTGFrameArenaAllocator> Count;
+
+		/** Sum of velocities in 1/VelocityScale cm/s */
+		TArray<FInt64Vector2, FMTGFrameArenaAllocator> VelocitySum;
+	};
+};
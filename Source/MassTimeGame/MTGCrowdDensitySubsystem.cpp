@@ -0,0 +1,108 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGCrowdDensitySubsystem.h"
+
+#include "MassTimeGame.h"
+
+void FMTGCrowdDensityGrid::Init(const FVector2D& InOrigin, double InCellSize, int32 InNumX, int32 InNumY)
+{
+	Origin = InOrigin;
+	CellSize = InCellSize;
+	NumX = InNumX;
+	NumY = InNumY;
+
+	// SetNumZeroed wouldn't clear the existing elements when rebuilding at the same size
+	Density.SetNumUninitialized(Num(), EAllowShrinking::No);
+	AverageVelocity.SetNumUninitialized(Num(), EAllowShrinking::No);
+	FMemory::Memzero(Density.GetData(), Density.NumBytes());
+	FMemory::Memzero(AverageVelocity.GetData(), AverageVelocity.NumBytes());
+}
+
+float FMTGCrowdDensityGrid::GetDensity(const FVector& Location) const
+{
+	const int32 CellIndex = GetCellIndex(Location);
+	return CellIndex != INDEX_NONE ? Density[CellIndex] : 0.f;
+}
+
+FVector2f FMTGCrowdDensityGrid::GetAverageVelocity(const FVector& Location) const
+{
+	const int32 CellIndex = GetCellIndex(Location);
+	return CellIndex != INDEX_NONE ? AverageVelocity[CellIndex] : FVector2f::ZeroVector;
+}
+
+FVector2f FMTGCrowdDensityGrid::GetDensityGradient(const FVector& Location) const
+{
+	const int32 X = FMath::FloorToInt32((Location.X - Origin.X) / CellSize);
+	const int32 Y = FMath::FloorToInt32((Location.Y - Origin.Y) / CellSize);
+
+	if (!IsValidCell(X, Y))
+	{
+		return FVector2f::ZeroVector;
+	}
+
+	auto DensityAt = [this](int32 CellX, int32 CellY)
+	{
+		// Clamp at the grid border (one-sided difference)
+		CellX = FMath::Clamp(CellX, 0, NumX - 1);
+		CellY = FMath::Clamp(CellY, 0, NumY - 1);
+		return Density[CellY * NumX + CellX];
+	};
+
+	const float InvTwoCells = 1.f / static_cast<float>(2. * CellSize);
+	return FVector2f(
+		(DensityAt(X + 1, Y) - DensityAt(X - 1, Y)) * InvTwoCells,
+		(DensityAt(X, Y + 1) - DensityAt(X, Y - 1)) * InvTwoCells);
+}
+
+// Set Class Defaults
+UMTGCrowdDensitySubsystem::UMTGCrowdDensitySubsystem()
+{
+	CellSize = 1000.f;
+	GridHalfExtent = 50000.f;
+	MaxCellsPerSide = 256;
+}
+
+void UMTGCrowdDensitySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// The cells can't be so small that the grid exceeds MaxCellsPerSide
+	const double MinCellSize = 2. * GridHalfExtent / FMath::Max(1, MaxCellsPerSide);
+	double GridCellSize = CellSize;
+	if (GridCellSize < MinCellSize)
+	{
+		UE_LOG(LogMassTimeGame, Warning, TEXT("Crowd density CellSize %.0f cm would need more than %d cells per side; using %.0f cm"), CellSize, MaxCellsPerSide, MinCellSize);
+		GridCellSize = MinCellSize;
+	}
+
+	// Start with an empty (but valid) grid so it's always safe to sample
+	const int32 NumCells = FMath::Clamp(FMath::CeilToInt32(2. * GridHalfExtent / GridCellSize), 1, FMath::Max(1, MaxCellsPerSide));
+	Grids[0].Init(FVector2D(-GridHalfExtent), GridCellSize, NumCells, NumCells);
+	Grids[1].Init(FVector2D(-GridHalfExtent), GridCellSize, NumCells, NumCells);
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Crowd density grid is %dx%d cells of %.0f cm"), NumCells, NumCells, GridCellSize);
+}
+
+FMTGCrowdDensityGrid& UMTGCrowdDensitySubsystem::BeginBuild()
+{
+	FMTGCrowdDensityGrid& BackGrid = Grids[1 - FrontGridIndex];
+	BackGrid.Init(BackGrid.Origin, BackGrid.CellSize, BackGrid.NumX, BackGrid.NumY);
+	return BackGrid;
+}
+
+void UMTGCrowdDensitySubsystem::EndBuild()
+{
+	FMTGCrowdDensityGrid& BackGrid = Grids[1 - FrontGridIndex];
+	for (const FMTGCrowdDensityHaloCell& Cell : HaloCells)
+	{
+		if (BackGrid.Density.IsValidIndex(Cell.CellIndex) && Cell.Density > 0.f)
+		{
+			float& Density = BackGrid.Density[Cell.CellIndex];
+			FVector2f& AverageVelocity = BackGrid.AverageVelocity[Cell.CellIndex];
+			AverageVelocity = (AverageVelocity * Density + Cell.AverageVelocity * Cell.Density) / (Density + Cell.Density);
+			Density += Cell.Density;
+		}
+	}
+
+	FrontGridIndex = 1 - FrontGridIndex;
+}
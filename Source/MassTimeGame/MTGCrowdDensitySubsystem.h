@@ -0,0 +1,167 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassExternalSubsystemTraits.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGCrowdDensitySubsystem.generated.h"
+
+/**
+ * A coarse 2D grid of crowd density (entities per cell) and average velocity.
+ *
+ * Cell (0,0) has its min corner at Origin.  Locations outside the grid
+ * sample as empty.
+ */
+struct MASSTIMEGAME_API FMTGCrowdDensityGrid
+{
+	/** World XY of the min corner of cell (0,0) */
+	FVector2D Origin = FVector2D::ZeroVector;
+
+	/** Size (cm) of each square cell */
+	double CellSize = 1000.;
+
+	/** Number of cells along X and Y */
+	int32 NumX = 0;
+	int32 NumY = 0;
+
+	/** Number of entities in each cell */
+	TArray<float> Density;
+
+	/** Average XY velocity of the entities in each cell */
+	TArray<FVector2f> AverageVelocity;
+
+	/** (Re)allocate the grid, filling it with zeros */
+	void Init(const FVector2D& InOrigin, double InCellSize, int32 InNumX, int32 InNumY);
+
+	/** @return Index of the cell containing Location, or INDEX_NONE if it's outside the grid */
+	int32 GetCellIndex(const FVector& Location) const
+	{
+		const int32 X = FMath::FloorToInt32((Location.X - Origin.X) / CellSize);
+		const int32 Y = FMath::FloorToInt32((Location.Y - Origin.Y) / CellSize);
+		return IsValidCell(X, Y) ? Y * NumX + X : INDEX_NONE;
+	}
+
+	/** @return True if (X,Y) is inside the grid */
+	bool IsValidCell(int32 X, int32 Y) const { return X >= 0 && Y >= 0 && X < NumX && Y < NumY; }
+
+	/** @return Number of entities in the cell containing Location */
+	float GetDensity(const FVector& Location) const;
+
+	/** @return Average velocity of the entities in the cell containing Location */
+	FVector2f GetAverageVelocity(const FVector& Location) const;
+
+	/**
+	 * Central difference of density around the cell containing Location.
+	 * Points toward increasing density, in entities per cell per cm.
+	 */
+	FVector2f GetDensityGradient(const FVector& Location) const;
+
+	/** @return Total number of cells */
+	int32 Num() const { return NumX * NumY; }
+};
+
+/**
+ * One cell of a neighboring shard's density grid, see UMTGShardSubsystem
+ */
+struct FMTGCrowdDensityHaloCell
+{
+	/** Index of the cell; every shard has the same grid layout */
+	int32 CellIndex = INDEX_NONE;
+
+	float Density = 0.f;
+	FVector2f AverageVelocity = FVector2f::ZeroVector;
+
+	friend FArchive& operator<<(FArchive& Ar, FMTGCrowdDensityHaloCell& Cell)
+	{
+		return Ar << Cell.CellIndex << Cell.Density << Cell.AverageVelocity;
+	}
+};
+
+/**
+ * MTG Crowd Density Subsystem
+ *
+ * Holds the crowd density grid that UMTGCrowdDensityProcessor rebuilds once
+ * per sim tick.
+ *
+ * Avoidance (UMTGWanderSteeringProcessor) and destination selection
+ * (FMTGFindRandomDestinationTask) sample this grid instead of querying
+ * neighbors, so their cost doesn't grow as wanderers cluster together.
+ *
+ * The grid is double buffered: the processor builds into the back buffer and
+ * swaps when done, so game thread code can sample the front buffer at any time.
+ *
+ * When the world is split over shard processes, the cells just across the
+ * region boundary come from the neighboring shards (SetHaloCells) and are
+ * added to every grid that's built, so avoidance works across the boundary.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Crowd Density Subsystem"))
+class MASSTIMEGAME_API UMTGCrowdDensitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGCrowdDensitySubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	//~End USubsystem interface
+
+	/**
+	 * Get the most recently completed grid
+	 * @return Density grid to sample
+	 */
+	const FMTGCrowdDensityGrid& GetGrid() const { return Grids[FrontGridIndex]; }
+
+	/**
+	 * Get the grid to build into; only UMTGCrowdDensityProcessor should use this.
+	 * It is reset to the configured size and zeroed.
+	 * @return Density grid to write
+	 */
+	FMTGCrowdDensityGrid& BeginBuild();
+
+	/** Publish the grid returned by BeginBuild */
+	void EndBuild();
+
+	/**
+	 * Set the cells of neighboring shards to add to the grids built from now on.
+	 * Game thread, outside of Mass processing.
+	 * @param Cells Neighbor cells; replaces the previous halo
+	 */
+	void SetHaloCells(TArray<FMTGCrowdDensityHaloCell>&& Cells) { HaloCells = MoveTemp(Cells); }
+
+protected:
+	/** Size (cm) of each grid cell. Smaller is more precise but costs more memory and merge time. */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=50, ForceUnits="cm"))
+	float CellSize;
+
+	/** The grid covers the square from -GridHalfExtent to +GridHalfExtent on X and Y */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=100, ForceUnits="cm"))
+	float GridHalfExtent;
+
+	/**
+	 * Most cells along each side of the grid.  If CellSize is too small for GridHalfExtent,
+	 * the cells are made bigger to fit.  The processor keeps several partial copies of the
+	 * grid every tick, so this bounds its scratch memory and merge time.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1, ClampMax=1024))
+	int32 MaxCellsPerSide;
+
+private:
+	FMTGCrowdDensityGrid Grids[2];
+	int32 FrontGridIndex = 0;
+
+	/** Cells of neighboring shards, added to each grid in EndBuild */
+	TArray<FMTGCrowdDensityHaloCell> HaloCells;
+};
+
+/** The grid is only written by UMTGCrowdDensityProcessor, so Mass may use it off the game thread */
+template<>
+struct TMassExternalSubsystemTraits<UMTGCrowdDensitySubsystem> final
+{
+	enum
+	{
+		GameThreadOnly = false,
+		ThreadSafeWrite = false,
+	};
+};
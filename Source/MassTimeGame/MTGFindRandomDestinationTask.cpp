@@ -0,0 +1,55 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGFindRandomDestinationTask.h"
+
+#include "MassCommonFragments.h"
+#include "MTGCrowdDensitySubsystem.h"
+#include "MTGMassFragments.h"
+#include "StateTreeExecutionContext.h"
+#include "StateTreeLinker.h"
+
+bool FMTGFindRandomDestinationTask::Link(FStateTreeLinker& Linker)
+{
+	Linker.LinkExternalData(TransformHandle);
+	Linker.LinkExternalData(RandomStreamHandle);
+	Linker.LinkExternalData(WanderTargetHandle);
+	Linker.LinkExternalData(CrowdDensityHandle);
+	return true;
+}
+
+EStateTreeRunStatus FMTGFindRandomDestinationTask::EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const
+{
+	const FTransformFragment& TransformFragment = Context.GetExternalData(TransformHandle);
+	FMTGRandomStreamFragment& RandomStreamFragment = Context.GetExternalData(RandomStreamHandle);
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+
+	const FVector Location = TransformFragment.GetTransform().GetLocation();
+	const UMTGCrowdDensitySubsystem* CrowdDensitySubsystem = Context.GetExternalDataPtr(CrowdDensityHandle);
+	const int32 NumCandidates = FMath::Max(1, InstanceData.NumCandidates);
+
+	float BestDensity = TNumericLimits<float>::Max();
+	for (int32 CandidateIndex = 0; CandidateIndex < NumCandidates; ++CandidateIndex)
+	{
+		// Always draw exactly 2 values per candidate, so the stream stays in lockstep across runs
+		const float Angle = RandomStreamFragment.Stream.FRandRange(0.f, UE_TWO_PI);
+		const float Distance = RandomStreamFragment.Stream.FRandRange(InstanceData.MinDistance, FMath::Max(InstanceData.MinDistance, InstanceData.MaxDistance));
+
+		const FVector Candidate = Location + FVector(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 0.);
+		const float Density = CrowdDensitySubsystem ? CrowdDensitySubsystem->GetGrid().GetDensity(Candidate) : 0.f;
+
+		// Strictly less, so ties keep the earliest candidate
+		if (Density < BestDensity)
+		{
+			BestDensity = Density;
+			InstanceData.Destination = Candidate;
+		}
+	}
+
+	if (FMTGWanderTargetFragment* WanderTargetFragment = Context.GetExternalDataPtr(WanderTargetHandle))
+	{
+		WanderTargetFragment->Destination = InstanceData.Destination;
+		WanderTargetFragment->bHasDestination = true;
+	}
+
+	return EStateTreeRunStatus::Succeeded;
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassStateTreeTypes.h"
+#include "MTGFindRandomDestinationTask.generated.h"
+
+class UMTGCrowdDensitySubsystem;
+struct FMTGRandomStreamFragment;
+struct FMTGWanderTargetFragment;
+struct FTransformFragment;
+
+USTRUCT()
+struct MASSTIMEGAME_API FMTGFindRandomDestinationTaskInstanceData
+{
+	GENERATED_BODY()
+
+	/** Minimum distance (cm) from the entity's current location */
+	UPROPERTY(EditAnywhere, Category=Parameter, meta=(ClampMin=0))
+	float MinDistance = 500.f;
+
+	/** Maximum distance (cm) from the entity's current location */
+	UPROPERTY(EditAnywhere, Category=Parameter, meta=(ClampMin=0))
+	float MaxDistance = 2000.f;
+
+	/**
+	 * Number of random candidates to consider; the one in the least crowded
+	 * crowd density cell wins.  1 means purely random.
+	 */
+	UPROPERTY(EditAnywhere, Category=Parameter, meta=(ClampMin=1, ClampMax=16))
+	int32 NumCandidates = 1;
+
+	/** The destination that was picked; bind this to the move task's target */
+	UPROPERTY(EditAnywhere, Category=Output)
+	FVector Destination = FVector::ZeroVector;
+};
+
+/**
+ * MTG Find Random Destination
+ *
+ * Picks a random destination around the entity using its own
+ * FMTGRandomStreamFragment, so the sequence of destinations an entity picks
+ * is fully determined by the world seed.
+ *
+ * If the entity has the MTG Wander Steering trait, the destination is also
+ * written to its FMTGWanderTargetFragment so it starts moving there.
+ *
+ * With NumCandidates > 1, several destinations are drawn and the one with
+ * the lowest UMTGCrowdDensitySubsystem density is picked, which spreads the
+ * wanderers out over time.
+ */
+USTRUCT(meta=(DisplayName="MTG Find Random Destination"))
+struct MASSTIMEGAME_API FMTGFindRandomDestinationTask : public FMassStateTreeTaskBase
+{
+	GENERATED_BODY()
+
+	using FInstanceDataType = FMTGFindRandomDestinationTaskInstanceData;
+
+protected:
+	//~Begin FStateTreeNodeBase interface
+	virtual bool Link(FStateTreeLinker& Linker) override;
+	virtual const UStruct* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
+	//~End FStateTreeNodeBase interface
+
+	//~Begin FStateTreeTaskBase interface
+	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, const FStateTreeTransitionResult& Transition) const override;
+	//~End FStateTreeTaskBase interface
+
+	TStateTreeExternalDataHandle<FTransformFragment> TransformHandle;
+	TStateTreeExternalDataHandle<FMTGRandomStreamFragment> RandomStreamHandle;
+	TStateTreeExternalDataHandle<FMTGWanderTargetFragment, EStateTreeExternalDataRequirement::Optional> WanderTargetHandle;
+	TStateTreeExternalDataHandle<UMTGCrowdDensitySubsystem, EStateTreeExternalDataRequirement::Optional> CrowdDensityHandle;
+};
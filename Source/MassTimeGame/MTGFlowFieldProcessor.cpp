@@ -0,0 +1,77 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGFlowFieldProcessor.h"
+
+#include "MassCommonFragments.h"
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+#include "MassTimeGame.h"
+#include "MTGCostHeatmapSubsystem.h"
+#include "MTGFlowFieldSubsystem.h"
+#include "MTGMassFragments.h"
+#include "MTGSimTimeSubsystem.h"
+#include "MTGWanderSteeringProcessor.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Flow Field Follow"), STAT_MTGFlowFieldFollow, STATGROUP_MassTimeGame);
+
+// Set Class Defaults
+UMTGFlowFieldProcessor::UMTGFlowFieldProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Movement;
+	ExecutionOrder.ExecuteBefore.Add(UMTGWanderSteeringProcessor::StaticClass()->GetFName());
+}
+
+void UMTGFlowFieldProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FMTGWanderTargetFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+	EntityQuery.AddSubsystemRequirement<UMTGFlowFieldSubsystem>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddSubsystemRequirement<UMTGCostHeatmapSubsystem>(EMassFragmentAccess::ReadWrite);
+}
+
+void UMTGFlowFieldProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	if (UMTGSimTimeSubsystem::IsDeferredToSimPipeline(Context.GetWorld()))
+	{
+		return;
+	}
+
+	const UMTGFlowFieldSubsystem* FlowFieldSubsystem = Context.GetSubsystem<UMTGFlowFieldSubsystem>();
+	const FMTGFlowField* FlowField = FlowFieldSubsystem ? FlowFieldSubsystem->GetActiveFlowField() : nullptr;
+	if (LIKELY(FlowField == nullptr))
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGFlowFieldFollow);
+
+	const double LookAheadDistance = FlowFieldSubsystem->GetLookAheadDistance();
+	UMTGCostHeatmapSubsystem* Heatmap = Context.GetMutableSubsystem<UMTGCostHeatmapSubsystem>();
+	FMTGFrameArenas* FrameArenas = UMTGSimTimeSubsystem::FindFrameArenas(Context.GetWorld());
+
+	EntityQuery.ParallelForEachEntityChunk(Context, [FrameArenas, FlowField, LookAheadDistance, Heatmap](FMassExecutionContext& Context)
+	{
+		FMTGFrameArenaScope WorkerArenaScope(FrameArenas);
+
+		const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+		const TArrayView<FMTGWanderTargetFragment> Targets = Context.GetMutableFragmentView<FMTGWanderTargetFragment>();
+		FMTGCostSampleScope CostSample(Heatmap, Transforms);
+
+		const int32 NumEntities = Context.GetNumEntities();
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			const FVector Location = Transforms[EntityIndex].GetTransform().GetLocation();
+
+			FVector2f Direction;
+			if (FlowField->Sample(Location, Direction))
+			{
+				FMTGWanderTargetFragment& Target = Targets[EntityIndex];
+				Target.Destination = Location + FVector(Direction.X, Direction.Y, 0.) * LookAheadDistance;
+				Target.bHasDestination = true;
+			}
+		}
+	});
+}
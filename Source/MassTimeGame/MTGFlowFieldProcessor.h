@@ -0,0 +1,34 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassProcessor.h"
+#include "MTGFlowFieldProcessor.generated.h"
+
+/**
+ * MTG Flow Field Processor
+ *
+ * While UMTGFlowFieldSubsystem has an active flow field, every wanderer
+ * inside it gets its FMTGWanderTargetFragment pointed a short way along the
+ * field.  This runs after behavior, so it overrides whatever destination the
+ * StateTree picked for the duration of the reaction.
+ *
+ * Each wanderer does one grid lookup; there are no per-entity path requests.
+ */
+UCLASS()
+class MASSTIMEGAME_API UMTGFlowFieldProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGFlowFieldProcessor();
+
+protected:
+	//~Begin UMassProcessor interface
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+	//~End UMassProcessor interface
+
+	FMassEntityQuery EntityQuery;
+};
@@ -0,0 +1,278 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGFlowFieldSubsystem.h"
+
+#include "MassTimeGame.h"
+#include "MTGSimTimeSubsystem.h"
+#include "NavigationData.h"
+#include "NavigationSystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Tasks/Task.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Flow Field Build"), STAT_MTGFlowFieldBuild, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::FlowField
+{
+	static int32 ClickReaction = 0;
+	static FAutoConsoleVariableRef CVarClickReaction(
+		TEXT("mtg.ClickReaction"),
+		ClickReaction,
+		TEXT("How wanderers react to player clicks: 0=ignore, 1=move toward the click, 2=flee from the click"));
+
+	/** Vertical half extent (cm) used when projecting cell centers onto the nav mesh */
+	static constexpr double NavProjectionHalfHeight = 500.;
+
+	/** 8-connected neighbor offsets, and the cost of stepping to each (in cells) */
+	static constexpr int32 NeighborDX[] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	static constexpr int32 NeighborDY[] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+	static constexpr float NeighborCost[] = { 1.f, 1.f, 1.f, 1.f, UE_SQRT_2, UE_SQRT_2, UE_SQRT_2, UE_SQRT_2 };
+}
+
+bool FMTGFlowField::Sample(const FVector& Location, FVector2f& OutDirection) const
+{
+	if (FVector2D::DistSquared(FVector2D(Location), FVector2D(Goal)) > FMath::Square(Radius))
+	{
+		return false;
+	}
+
+	const int32 X = FMath::FloorToInt32((Location.X - Origin.X) / CellSize);
+	const int32 Y = FMath::FloorToInt32((Location.Y - Origin.Y) / CellSize);
+	if (X < 0 || Y < 0 || X >= NumX || Y >= NumY)
+	{
+		return false;
+	}
+
+	OutDirection = Directions[Y * NumX + X];
+	return !OutDirection.IsZero();
+}
+
+TSharedRef<FMTGFlowField> FMTGFlowField::Build(const FVector& Goal, const EMTGFlowFieldMode Mode, const double Radius, const double CellSize, const ANavigationData* NavData)
+{
+	using namespace UE::MTG::FlowField;
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGFlowFieldBuild);
+
+	TSharedRef<FMTGFlowField> Field = MakeShared<FMTGFlowField>();
+	Field->Goal = Goal;
+	Field->Mode = Mode;
+	Field->CellSize = CellSize;
+	Field->Radius = Radius;
+
+	// Square grid centered on the goal cell
+	const int32 HalfCells = FMath::CeilToInt32(Radius / CellSize);
+	Field->NumX = Field->NumY = 2 * HalfCells + 1;
+	Field->Origin = FVector2D(Goal) - FVector2D((HalfCells + 0.5) * CellSize);
+
+	const int32 NumX = Field->NumX;
+	const int32 NumCells = Field->NumX * Field->NumY;
+	const int32 GoalCellIndex = HalfCells * NumX + HalfCells;
+
+	auto GetCellCenter = [&Field, NumX](const int32 CellIndex)
+	{
+		return FVector2D(Field->Origin.X + (CellIndex % NumX + 0.5) * Field->CellSize, Field->Origin.Y + (CellIndex / NumX + 0.5) * Field->CellSize);
+	};
+
+	// Walkability: every cell whose center projects onto the nav mesh. Without nav data everything is walkable.
+	TBitArray<> Walkable(true, NumCells);
+	if (NavData)
+	{
+		const FVector ProjectionExtent(CellSize * 0.5, CellSize * 0.5, NavProjectionHalfHeight);
+		for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+		{
+			const FVector2D Center = GetCellCenter(CellIndex);
+			FNavLocation NavLocation;
+			Walkable[CellIndex] = NavData->ProjectPoint(FVector(Center.X, Center.Y, Goal.Z), NavLocation, ProjectionExtent);
+		}
+	}
+	Walkable[GoalCellIndex] = true;
+
+	// Dijkstra from the goal cell
+	TArray<float> Cost;
+	Cost.Init(TNumericLimits<float>::Max(), NumCells);
+	Cost[GoalCellIndex] = 0.f;
+
+	using FOpenCell = TPair<float, int32>;
+	TArray<FOpenCell> OpenCells;
+	OpenCells.HeapPush(FOpenCell(0.f, GoalCellIndex), TLess<FOpenCell>());
+
+	while (OpenCells.Num() > 0)
+	{
+		FOpenCell Current;
+		OpenCells.HeapPop(Current, TLess<FOpenCell>(), EAllowShrinking::No);
+
+		const int32 CellIndex = Current.Value;
+		if (Current.Key > Cost[CellIndex])
+		{
+			continue;  // Stale entry
+		}
+
+		const int32 X = CellIndex % NumX;
+		const int32 Y = CellIndex / NumX;
+		for (int32 Neighbor = 0; Neighbor < UE_ARRAY_COUNT(NeighborDX); ++Neighbor)
+		{
+			const int32 NX = X + NeighborDX[Neighbor];
+			const int32 NY = Y + NeighborDY[Neighbor];
+			if (NX < 0 || NY < 0 || NX >= NumX || NY >= Field->NumY)
+			{
+				continue;
+			}
+
+			const int32 NeighborIndex = NY * NumX + NX;
+			const float NewCost = Current.Key + NeighborCost[Neighbor];
+			if (Walkable[NeighborIndex] && NewCost < Cost[NeighborIndex])
+			{
+				Cost[NeighborIndex] = NewCost;
+				OpenCells.HeapPush(FOpenCell(NewCost, NeighborIndex), TLess<FOpenCell>());
+			}
+		}
+	}
+
+	// Directions: toward the cheapest neighbor to attract, toward the most expensive reachable neighbor to flee
+	Field->Directions.SetNumZeroed(NumCells);
+	for (int32 CellIndex = 0; CellIndex < NumCells; ++CellIndex)
+	{
+		const float CellCost = Cost[CellIndex];
+		if (CellCost == TNumericLimits<float>::Max())
+		{
+			continue;  // Blocked or unreachable
+		}
+
+		const int32 X = CellIndex % NumX;
+		const int32 Y = CellIndex / NumX;
+
+		int32 BestIndex = INDEX_NONE;
+		float BestCost = CellCost;
+		for (int32 Neighbor = 0; Neighbor < UE_ARRAY_COUNT(NeighborDX); ++Neighbor)
+		{
+			const int32 NX = X + NeighborDX[Neighbor];
+			const int32 NY = Y + NeighborDY[Neighbor];
+			if (NX < 0 || NY < 0 || NX >= NumX || NY >= Field->NumY)
+			{
+				continue;
+			}
+
+			const int32 NeighborIndex = NY * NumX + NX;
+			const float NeighborCellCost = Cost[NeighborIndex];
+			if (NeighborCellCost == TNumericLimits<float>::Max())
+			{
+				continue;
+			}
+
+			const bool bIsBetter = Mode == EMTGFlowFieldMode::Attract ? NeighborCellCost < BestCost : NeighborCellCost > BestCost;
+			if (bIsBetter)
+			{
+				BestCost = NeighborCellCost;
+				BestIndex = NeighborIndex;
+			}
+		}
+
+		if (BestIndex != INDEX_NONE)
+		{
+			Field->Directions[CellIndex] = FVector2f((GetCellCenter(BestIndex) - GetCellCenter(CellIndex)).GetSafeNormal());
+		}
+	}
+
+	// When attracting, the goal cell has no cheaper neighbor, so it stays zero and wanderers that reach it stop reacting
+
+	return Field;
+}
+
+// Set Class Defaults
+UMTGFlowFieldSubsystem::UMTGFlowFieldSubsystem()
+{
+	ReactionRadius = 3000.f;
+	CellSize = 200.f;
+	ReactionDurationSeconds = 10.f;
+}
+
+void UMTGFlowFieldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+	}
+}
+
+void UMTGFlowFieldSubsystem::Deinitialize()
+{
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	// The build task may reference the nav data; don't let it outlive the world
+	if (BuildTask.IsValid())
+	{
+		BuildTask.Wait();
+		BuildTask = {};
+	}
+
+	ActiveFlowField.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UMTGFlowFieldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMTGFlowFieldSubsystem::NotifyPlayerClicked(const FVector& Location)
+{
+	switch (UE::MTG::FlowField::ClickReaction)
+	{
+	case 1:
+		RequestFlowField(Location, EMTGFlowFieldMode::Attract);
+		break;
+	case 2:
+		RequestFlowField(Location, EMTGFlowFieldMode::Flee);
+		break;
+	default:
+		break;
+	}
+}
+
+void UMTGFlowFieldSubsystem::RequestFlowField(const FVector& Goal, const EMTGFlowFieldMode Mode)
+{
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	const ANavigationData* NavData = NavSys ? NavSys->GetDefaultNavDataInstance() : nullptr;
+
+	// The nav data is a world actor that outlives any build, since Deinitialize waits for the task.
+	// Nav mesh queries are read-only and already run on workers for async path finding.
+	const double Radius = ReactionRadius;
+	const double FieldCellSize = CellSize;
+	BuildTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Goal, Mode, Radius, FieldCellSize, NavData]() -> TSharedPtr<const FMTGFlowField>
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		TSharedRef<FMTGFlowField> Field = FMTGFlowField::Build(Goal, Mode, Radius, FieldCellSize, NavData);
+
+		UE_LOG(LogMassTimeGame, Log, TEXT("Built %s flow field of %dx%d cells in %.2f ms"),
+			Mode == EMTGFlowFieldMode::Attract ? TEXT("attract") : TEXT("flee"),
+			Field->NumX, Field->NumY, 1000. * (FPlatformTime::Seconds() - StartTime));
+
+		return Field;
+	});
+}
+
+void UMTGFlowFieldSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	const double SimTimeElapsed = SimTimeSubsystemIn->GetSimTimeElapsed();
+
+	if (ActiveFlowField && SimTimeElapsed >= ActiveFlowFieldExpireTime)
+	{
+		ActiveFlowField.Reset();
+	}
+
+	// Publish a finished build; the next sim tick's wanderers will all see it
+	if (BuildTask.IsValid() && BuildTask.IsCompleted())
+	{
+		ActiveFlowField = BuildTask.GetResult();
+		ActiveFlowFieldExpireTime = SimTimeElapsed + ReactionDurationSeconds;
+		BuildTask = {};
+	}
+}
@@ -0,0 +1,170 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassExternalSubsystemTraits.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "MTGFlowFieldSubsystem.generated.h"
+
+class ANavigationData;
+class UMTGSimTimeSubsystem;
+
+/** Whether reacting wanderers move toward or away from the flow field goal */
+UENUM()
+enum class EMTGFlowFieldMode : uint8
+{
+	Attract,
+	Flee,
+};
+
+/**
+ * A 2D flow field around a goal location.
+ *
+ * Every walkable cell stores the unit XY direction to move in: down the
+ * distance-to-goal field when attracting, up it when fleeing.  Blocked and
+ * unreachable cells store a zero direction.
+ */
+struct MASSTIMEGAME_API FMTGFlowField
+{
+	/** The location the field was built from */
+	FVector Goal = FVector::ZeroVector;
+
+	EMTGFlowFieldMode Mode = EMTGFlowFieldMode::Attract;
+
+	/** World XY of the min corner of cell (0,0) */
+	FVector2D Origin = FVector2D::ZeroVector;
+
+	/** Size (cm) of each square cell */
+	double CellSize = 200.;
+
+	/** Only locations within this distance (cm) of Goal react */
+	double Radius = 0.;
+
+	/** Number of cells along X and Y */
+	int32 NumX = 0;
+	int32 NumY = 0;
+
+	/** Unit direction to move in for each cell */
+	TArray<FVector2f> Directions;
+
+	/**
+	 * Sample the field
+	 * @param Location World location to sample
+	 * @param OutDirection Unit XY direction to move in
+	 * @return True if Location is inside the field's radius on a reachable cell, else False
+	 */
+	bool Sample(const FVector& Location, FVector2f& OutDirection) const;
+
+	/**
+	 * Build a flow field around Goal.  Safe to call from a worker thread.
+	 *
+	 * Cells are marked walkable by projecting their centers onto NavData (if
+	 * any), then a Dijkstra pass from the goal cell computes the distance
+	 * field that the directions follow.
+	 */
+	static TSharedRef<FMTGFlowField> Build(const FVector& Goal, EMTGFlowFieldMode Mode, double Radius, double CellSize, const ANavigationData* NavData);
+};
+
+/**
+ * MTG Flow Field Subsystem
+ *
+ * Crowd reactions to player clicks.  A click builds ONE flow field on a
+ * background task, and UMTGFlowFieldProcessor steers every wanderer inside
+ * its radius by sampling it, so a click costs one field build no matter how
+ * many wanderers react.
+ *
+ * mtg.ClickReaction selects the reaction (0=off, 1=attract, 2=flee).
+ *
+ * A finished build is published at the next sim tick boundary and stays
+ * active for ReactionDurationSeconds of sim time.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Flow Field Subsystem"))
+class MASSTIMEGAME_API UMTGFlowFieldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGFlowFieldSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 * Called when the player clicks a destination.
+	 * Starts a crowd reaction if mtg.ClickReaction is enabled.
+	 * @param Location Clicked world location
+	 */
+	void NotifyPlayerClicked(const FVector& Location);
+
+	/**
+	 * Start building a flow field in the background.
+	 * Replaces any build already in progress, and the active field once done.
+	 * @param Goal World location to attract to or flee from
+	 * @param Mode Attract or Flee
+	 */
+	void RequestFlowField(const FVector& Goal, EMTGFlowFieldMode Mode);
+
+	/**
+	 * Get the active flow field, if any
+	 * @return The active field, or nullptr if no reaction is active
+	 */
+	const FMTGFlowField* GetActiveFlowField() const { return ActiveFlowField.Get(); }
+
+	/**
+	 * Distance (cm) ahead along the field that reacting wanderers are steered to
+	 * @return Look ahead distance
+	 */
+	float GetLookAheadDistance() const { return 2.f * CellSize; }
+
+protected:
+	/** Radius (cm) around the click in which wanderers react */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=100, ForceUnits="cm"))
+	float ReactionRadius;
+
+	/** Size (cm) of each flow field cell */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=25, ForceUnits="cm"))
+	float CellSize;
+
+	/** Sim time (seconds) a reaction lasts once its field is published */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ForceUnits="s"))
+	float ReactionDurationSeconds;
+
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem since we use it every tick */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** The background build of the next field, if any */
+	UE::Tasks::TTask<TSharedPtr<const FMTGFlowField>> BuildTask;
+
+	/** The field wanderers are currently reacting to; only changed at sim tick boundaries */
+	TSharedPtr<const FMTGFlowField> ActiveFlowField;
+
+	/** SimTimeElapsed at which the active field expires */
+	double ActiveFlowFieldExpireTime = 0.;
+};
+
+/** The active field is only replaced on the game thread between sim ticks, so Mass may read it from any thread */
+template<>
+struct TMassExternalSubsystemTraits<UMTGFlowFieldSubsystem> final
+{
+	enum
+	{
+		GameThreadOnly = false,
+		ThreadSafeWrite = false,
+	};
+};
@@ -0,0 +1,313 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGFrameArena.h"
+
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/ScopeLock.h"
+
+namespace UE::MTG::FrameArena
+{
+	/** Source of FMTGFrameArenas::Serial; 0 is never used */
+	static std::atomic<uint32> NextSerial = 1;
+
+	/** Transient allocations made outside any scope */
+	static std::atomic<int32> NumHeapFallbacks = 0;
+
+	/** The innermost scope's arenas on this thread */
+	static thread_local FMTGFrameArenas* CurrentArenas = nullptr;
+
+	/** This thread's arena of the FMTGFrameArenas with CachedSerial, to skip the lookup */
+	static thread_local uint32 CachedSerial = 0;
+	static thread_local FMTGFrameArena* CachedArena = nullptr;
+
+	/** Blocks are at least this big */
+	static constexpr SIZE_T MinBlockSize = 64 * 1024;
+
+	/** Heap allocations made on a thread in a scope, counted by FScopedHeapAllocCounter */
+	static std::atomic<int32> NumScopedHeapAllocs = 0;
+
+	/** Set once FScopedHeapAllocCounter wraps GMalloc */
+	static bool bIsCountingScopedHeapAllocs = false;
+
+	/**
+	 * Forwards everything to the real allocator, counting the allocations made
+	 * while the calling thread is in a FMTGFrameArenaScope.  That is all of the
+	 * sim tick's heap traffic, ours and the engine's, so a steady state tick
+	 * should count zero.
+	 */
+	class FScopedHeapAllocCounter final : public FMalloc
+	{
+	public:
+		explicit FScopedHeapAllocCounter(FMalloc* InInner)
+			: Inner(InInner)
+		{
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAlloc();
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAlloc();
+			}
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("MTGScopedHeapAllocCounter"); }
+
+	private:
+		static void CountAlloc()
+		{
+			if (CurrentArenas)
+			{
+				NumScopedHeapAllocs.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		FMalloc* Inner;
+	};
+}
+
+FMTGFrameArena::FMTGFrameArena(const SIZE_T InMinBlockSize)
+	: MinBlockSize(InMinBlockSize)
+{
+}
+
+FMTGFrameArena::~FMTGFrameArena()
+{
+	for (const FBlock& Block : Blocks)
+	{
+		FMemory::Free(Block.Data);
+	}
+}
+
+void* FMTGFrameArena::Allocate(const SIZE_T Size, const uint32 Alignment)
+{
+	check(FMath::IsPowerOfTwo(Alignment) && Alignment <= PLATFORM_CACHE_LINE_SIZE);
+
+	if (BlockIndex != INDEX_NONE)
+	{
+		const FBlock& Block = Blocks[BlockIndex];
+		const SIZE_T AlignedOffset = Align(Offset, Alignment);
+		if (AlignedOffset + Size <= Block.Size)
+		{
+			UsedBytes += AlignedOffset + Size - Offset;
+			Offset = AlignedOffset + Size;
+			return Block.Data + AlignedOffset;
+		}
+	}
+
+	// Blocks are allocated with the max alignment anybody uses, so a fresh block only needs Size
+	NextBlock(Size);
+
+	UsedBytes += Size;
+	Offset = Size;
+	return Blocks[BlockIndex].Data;
+}
+
+void FMTGFrameArena::NextBlock(const SIZE_T Size)
+{
+	// The rest of the current block is wasted; count it so the coalesced block is big enough
+	if (BlockIndex != INDEX_NONE)
+	{
+		UsedBytes += Blocks[BlockIndex].Size - Offset;
+	}
+
+	for (++BlockIndex; BlockIndex < Blocks.Num(); ++BlockIndex)
+	{
+		if (Blocks[BlockIndex].Size >= Size)
+		{
+			Offset = 0;
+			return;
+		}
+	}
+
+	FBlock& Block = Blocks.AddDefaulted_GetRef();
+	Block.Size = FMath::Max(MinBlockSize, Size);
+	Block.Data = static_cast<uint8*>(FMemory::Malloc(Block.Size, PLATFORM_CACHE_LINE_SIZE));
+	BlockIndex = Blocks.Num() - 1;
+	Offset = 0;
+	++NumBlocksAllocated;
+}
+
+void FMTGFrameArena::Reset()
+{
+	HighWaterBytes = FMath::Max(HighWaterBytes, UsedBytes);
+
+	// Steady state is one block that fits the biggest tick
+	if (Blocks.Num() > 1)
+	{
+		for (const FBlock& Block : Blocks)
+		{
+			FMemory::Free(Block.Data);
+		}
+		Blocks.Reset();
+
+		FBlock& Block = Blocks.AddDefaulted_GetRef();
+		Block.Size = Align(FMath::Max(MinBlockSize, HighWaterBytes), MinBlockSize);
+		Block.Data = static_cast<uint8*>(FMemory::Malloc(Block.Size, PLATFORM_CACHE_LINE_SIZE));
+		++NumBlocksAllocated;
+	}
+
+	BlockIndex = Blocks.Num() > 0 ? 0 : INDEX_NONE;
+	Offset = 0;
+	UsedBytes = 0;
+}
+
+SIZE_T FMTGFrameArena::GetReservedBytes() const
+{
+	SIZE_T ReservedBytes = 0;
+	for (const FBlock& Block : Blocks)
+	{
+		ReservedBytes += Block.Size;
+	}
+	return ReservedBytes;
+}
+
+FMTGFrameArenas::FMTGFrameArenas()
+	: Serial(UE::MTG::FrameArena::NextSerial++)
+{
+}
+
+FMTGFrameArena& FMTGFrameArenas::GetThreadArena()
+{
+	using namespace UE::MTG::FrameArena;
+
+	if (LIKELY(CachedSerial == Serial))
+	{
+		return *CachedArena;
+	}
+
+	FScopeLock Lock(&ArenasLock);
+
+	TUniquePtr<FMTGFrameArena>& Arena = ArenasByThreadId.FindOrAdd(FPlatformTLS::GetCurrentThreadId());
+	if (!Arena)
+	{
+		Arena = MakeUnique<FMTGFrameArena>(MinBlockSize);
+	}
+
+	CachedSerial = Serial;
+	CachedArena = Arena.Get();
+	return *Arena;
+}
+
+void FMTGFrameArenas::ResetAll()
+{
+	check(IsInGameThread());
+	ensureMsgf(NumActiveScopes.load() == 0, TEXT("Resetting the frame arenas while %d threads are using them"), NumActiveScopes.load());
+
+	FScopeLock Lock(&ArenasLock);
+	for (const TPair<uint32, TUniquePtr<FMTGFrameArena>>& Pair : ArenasByThreadId)
+	{
+		Pair.Value->Reset();
+	}
+}
+
+FMTGFrameArenaStats FMTGFrameArenas::GetStats() const
+{
+	FMTGFrameArenaStats Stats;
+
+	FScopeLock Lock(&ArenasLock);
+	for (const TPair<uint32, TUniquePtr<FMTGFrameArena>>& Pair : ArenasByThreadId)
+	{
+		const FMTGFrameArena& Arena = *Pair.Value;
+		++Stats.NumArenas;
+		Stats.UsedBytes += Arena.GetUsedBytes();
+		Stats.HighWaterBytes += FMath::Max(Arena.GetHighWaterBytes(), Arena.GetUsedBytes());
+		Stats.ReservedBytes += Arena.GetReservedBytes();
+		Stats.NumBlocksAllocated += Arena.GetNumBlocksAllocated();
+	}
+
+	return Stats;
+}
+
+FMTGFrameArenas* FMTGFrameArenas::GetCurrent()
+{
+	return UE::MTG::FrameArena::CurrentArenas;
+}
+
+void* FMTGFrameArenas::AllocateTransient(const SIZE_T Size, const uint32 Alignment, bool& bOutFromHeap)
+{
+	if (FMTGFrameArenas* Arenas = GetCurrent())
+	{
+		bOutFromHeap = false;
+		return Arenas->GetThreadArena().Allocate(Size, FMath::Max<uint32>(Alignment, 1));
+	}
+
+	++UE::MTG::FrameArena::NumHeapFallbacks;
+	bOutFromHeap = true;
+	return FMemory::Malloc(Size, Alignment);
+}
+
+int32 FMTGFrameArenas::ConsumeNumHeapFallbacks()
+{
+	return UE::MTG::FrameArena::NumHeapFallbacks.exchange(0);
+}
+
+void FMTGFrameArenas::InstallScopedHeapAllocCounter()
+{
+	using namespace UE::MTG::FrameArena;
+
+	check(IsInGameThread());
+	if (bIsCountingScopedHeapAllocs || !ensure(GMalloc))
+	{
+		return;
+	}
+
+	// Never uninstalled: memory allocated through it may be freed at any time until exit
+	GMalloc = new FScopedHeapAllocCounter(GMalloc);
+	bIsCountingScopedHeapAllocs = true;
+}
+
+bool FMTGFrameArenas::IsCountingScopedHeapAllocs()
+{
+	return UE::MTG::FrameArena::bIsCountingScopedHeapAllocs;
+}
+
+int32 FMTGFrameArenas::ConsumeNumScopedHeapAllocs()
+{
+	return UE::MTG::FrameArena::NumScopedHeapAllocs.exchange(0);
+}
+
+FMTGFrameArenaScope::FMTGFrameArenaScope(FMTGFrameArenas& InArenas)
+	: FMTGFrameArenaScope(&InArenas)
+{
+}
+
+FMTGFrameArenaScope::FMTGFrameArenaScope(FMTGFrameArenas* InArenas)
+	: Arenas(InArenas)
+	, PreviousArenas(UE::MTG::FrameArena::CurrentArenas)
+{
+	if (Arenas)
+	{
+		UE::MTG::FrameArena::CurrentArenas = Arenas;
+		++Arenas->NumActiveScopes;
+	}
+}
+
+FMTGFrameArenaScope::~FMTGFrameArenaScope()
+{
+	if (Arenas)
+	{
+		--Arenas->NumActiveScopes;
+		UE::MTG::FrameArena::CurrentArenas = PreviousArenas;
+	}
+}
@@ -0,0 +1,321 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/ContainerAllocationPolicies.h"
+#include "Containers/Map.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/UniquePtr.h"
+#include <atomic>
+
+/**
+ * Linear (bump) allocator for one thread's transient allocations during one sim tick.
+ *
+ * Allocating just moves an offset, freeing does nothing, and Reset rewinds
+ * everything at once.  If a tick needed more than one block, Reset replaces
+ * them with a single block big enough for the high water mark, so once the
+ * arena has seen its largest tick it never touches the heap again.
+ */
+class MASSTIMEGAME_API FMTGFrameArena
+{
+public:
+	explicit FMTGFrameArena(SIZE_T InMinBlockSize);
+	~FMTGFrameArena();
+
+	FMTGFrameArena(const FMTGFrameArena&) = delete;
+	FMTGFrameArena& operator=(const FMTGFrameArena&) = delete;
+
+	/**
+	 * Allocate memory that stays valid until the next Reset
+	 * @param Size Bytes to allocate
+	 * @param Alignment Power of 2 alignment
+	 * @return The memory; never null
+	 */
+	void* Allocate(SIZE_T Size, uint32 Alignment);
+
+	/** Release every allocation at once.  Nothing may be using them. */
+	void Reset();
+
+	/** @return Bytes allocated since the last Reset, including alignment padding */
+	SIZE_T GetUsedBytes() const { return UsedBytes; }
+
+	/** @return Most bytes ever allocated between two Resets */
+	SIZE_T GetHighWaterBytes() const { return HighWaterBytes; }
+
+	/** @return Bytes of blocks held */
+	SIZE_T GetReservedBytes() const;
+
+	/** @return Number of blocks allocated from the heap so far */
+	int32 GetNumBlocksAllocated() const { return NumBlocksAllocated; }
+
+private:
+	struct FBlock
+	{
+		uint8* Data = nullptr;
+		SIZE_T Size = 0;
+	};
+
+	/** Start allocating from a block with at least Size bytes free */
+	void NextBlock(SIZE_T Size);
+
+	TArray<FBlock> Blocks;
+	int32 BlockIndex = INDEX_NONE;
+	SIZE_T Offset = 0;
+
+	SIZE_T MinBlockSize = 0;
+	SIZE_T UsedBytes = 0;
+	SIZE_T HighWaterBytes = 0;
+	int32 NumBlocksAllocated = 0;
+};
+
+/**
+ * Counters of every arena of a FMTGFrameArenas
+ */
+struct FMTGFrameArenaStats
+{
+	/** Number of threads that have an arena */
+	int32 NumArenas = 0;
+
+	/** Bytes allocated from all arenas since the last reset */
+	SIZE_T UsedBytes = 0;
+
+	/** Sum of each arena's high water mark */
+	SIZE_T HighWaterBytes = 0;
+
+	/** Bytes of blocks held by all arenas */
+	SIZE_T ReservedBytes = 0;
+
+	/** Number of blocks all arenas have allocated from the heap */
+	int32 NumBlocksAllocated = 0;
+};
+
+/**
+ * One FMTGFrameArena per thread that allocates from it, all reset together.
+ *
+ * UMTGSimTimeSubsystem owns one and resets it at every sim tick boundary.
+ * Code allocates from it inside a FMTGFrameArenaScope, usually through
+ * FMTGFrameArenaAllocator.
+ */
+class MASSTIMEGAME_API FMTGFrameArenas
+{
+public:
+	FMTGFrameArenas();
+
+	FMTGFrameArenas(const FMTGFrameArenas&) = delete;
+	FMTGFrameArenas& operator=(const FMTGFrameArenas&) = delete;
+
+	/**
+	 * Get the calling thread's arena, creating it the first time
+	 * @return This thread's arena
+	 */
+	FMTGFrameArena& GetThreadArena();
+
+	/** Reset every arena.  Game thread; nothing may be in a scope or using arena memory. */
+	void ResetAll();
+
+	/** @return Counters summed over every arena */
+	FMTGFrameArenaStats GetStats() const;
+
+	/**
+	 * Get the arenas of the innermost FMTGFrameArenaScope on this thread
+	 * @return The arenas, or nullptr if this thread isn't in a scope
+	 */
+	static FMTGFrameArenas* GetCurrent();
+
+	/**
+	 * Allocate from the current scope's arena, or the heap if there is none
+	 * @param Size Bytes to allocate
+	 * @param Alignment Power of 2 alignment
+	 * @param bOutFromHeap Set if the caller must FMemory::Free it
+	 * @return The memory
+	 */
+	static void* AllocateTransient(SIZE_T Size, uint32 Alignment, bool& bOutFromHeap);
+
+	/** @return Number of transient allocations made outside any scope since the last call */
+	static int32 ConsumeNumHeapFallbacks();
+
+	/**
+	 * Count every heap allocation made on a thread that is in a scope, whatever allocates it.
+	 * Wraps GMalloc, so call it once at startup (the module does for -MTGCountSimAllocs).
+	 */
+	static void InstallScopedHeapAllocCounter();
+
+	/** @return True if InstallScopedHeapAllocCounter was called */
+	static bool IsCountingScopedHeapAllocs();
+
+	/** @return Number of heap allocations made inside a scope since the last call; always 0 without the counter */
+	static int32 ConsumeNumScopedHeapAllocs();
+
+private:
+	friend class FMTGFrameArenaScope;
+
+	/** Unique among every FMTGFrameArenas ever made, so a thread's cached arena can't match a new one at a reused address */
+	uint32 Serial = 0;
+
+	/** Threads in a scope of these arenas */
+	std::atomic<int32> NumActiveScopes = 0;
+
+	/** Guards ArenasByThreadId */
+	mutable FCriticalSection ArenasLock;
+	TMap<uint32, TUniquePtr<FMTGFrameArena>> ArenasByThreadId;
+};
+
+/**
+ * Makes FMTGFrameArenaAllocator containers on this thread allocate from Arenas.
+ * Scopes nest; ParallelFor workers are separate threads and need their own.
+ */
+class MASSTIMEGAME_API FMTGFrameArenaScope
+{
+public:
+	explicit FMTGFrameArenaScope(FMTGFrameArenas& Arenas);
+
+	/** Does nothing if Arenas is null, e.g. a processor in a world without UMTGSimTimeSubsystem */
+	explicit FMTGFrameArenaScope(FMTGFrameArenas* Arenas);
+
+	~FMTGFrameArenaScope();
+
+	FMTGFrameArenaScope(const FMTGFrameArenaScope&) = delete;
+	FMTGFrameArenaScope& operator=(const FMTGFrameArenaScope&) = delete;
+
+private:
+	FMTGFrameArenas* Arenas = nullptr;
+	FMTGFrameArenas* PreviousArenas = nullptr;
+};
+
+/**
+ * TArray allocator that takes its memory from the current FMTGFrameArenaScope.
+ *
+ * Only for local containers that are gone by the end of the sim tick; the
+ * memory is reused at the next tick boundary.  Outside of any scope it falls
+ * back to the heap (counted by "MTG Frame Arena Heap Fallbacks"), so it's
+ * always safe, just not free.
+ *
+ * Usage: TArray<FVector, FMTGFrameArenaAllocator> Scratch;
+ */
+template<uint32 Alignment = 16>
+class TMTGFrameArenaAllocator
+{
+public:
+	using SizeType = int32;
+
+	enum { NeedsElementType = true };
+	enum { RequireRangeCheck = true };
+
+	class ForAnyElementType
+	{
+	public:
+		ForAnyElementType() = default;
+
+		ForAnyElementType(const ForAnyElementType&) = delete;
+		ForAnyElementType& operator=(const ForAnyElementType&) = delete;
+
+		~ForAnyElementType()
+		{
+			if (bFromHeap)
+			{
+				FMemory::Free(Data);
+			}
+		}
+
+		void MoveToEmpty(ForAnyElementType& Other)
+		{
+			checkSlow(this != &Other);
+
+			if (bFromHeap)
+			{
+				FMemory::Free(Data);
+			}
+
+			Data = Other.Data;
+			bFromHeap = Other.bFromHeap;
+			Other.Data = nullptr;
+			Other.bFromHeap = false;
+		}
+
+		FScriptContainerElement* GetAllocation() const
+		{
+			return Data;
+		}
+
+		void ResizeAllocation(const SizeType CurrentNum, const SizeType NewMax, const SIZE_T NumBytesPerElement)
+		{
+			FScriptContainerElement* NewData = nullptr;
+			bool bNewFromHeap = false;
+
+			if (NewMax > 0)
+			{
+				NewData = static_cast<FScriptContainerElement*>(FMTGFrameArenas::AllocateTransient(static_cast<SIZE_T>(NewMax) * NumBytesPerElement, Alignment, bNewFromHeap));
+
+				// The old allocation isn't freed (unless it came from the heap), so always copy
+				if (Data && CurrentNum > 0)
+				{
+					FMemory::Memcpy(NewData, Data, static_cast<SIZE_T>(FMath::Min(CurrentNum, NewMax)) * NumBytesPerElement);
+				}
+			}
+
+			if (bFromHeap)
+			{
+				FMemory::Free(Data);
+			}
+
+			Data = NewData;
+			bFromHeap = bNewFromHeap;
+		}
+
+		SizeType CalculateSlackReserve(const SizeType NewMax, const SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackReserve(NewMax, NumBytesPerElement, false, Alignment);
+		}
+
+		SizeType CalculateSlackShrink(const SizeType NewMax, const SizeType CurrentMax, const SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackShrink(NewMax, CurrentMax, NumBytesPerElement, false, Alignment);
+		}
+
+		SizeType CalculateSlackGrow(const SizeType NewMax, const SizeType CurrentMax, const SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackGrow(NewMax, CurrentMax, NumBytesPerElement, false, Alignment);
+		}
+
+		SIZE_T GetAllocatedSize(const SizeType CurrentMax, const SIZE_T NumBytesPerElement) const
+		{
+			return static_cast<SIZE_T>(CurrentMax) * NumBytesPerElement;
+		}
+
+		bool HasAllocation() const
+		{
+			return Data != nullptr;
+		}
+
+		SizeType GetInitialCapacity() const
+		{
+			return 0;
+		}
+
+	private:
+		FScriptContainerElement* Data = nullptr;
+
+		/** Did Data come from the heap (no scope when it was allocated)? */
+		bool bFromHeap = false;
+	};
+
+	template<typename ElementType>
+	class ForElementType : public ForAnyElementType
+	{
+	public:
+		ElementType* GetAllocation() const
+		{
+			return reinterpret_cast<ElementType*>(ForAnyElementType::GetAllocation());
+		}
+	};
+};
+
+template<uint32 Alignment>
+struct TAllocatorTraits<TMTGFrameArenaAllocator<Alignment>> : TAllocatorTraitsBase<TMTGFrameArenaAllocator<Alignment>>
+{
+	enum { IsZeroConstruct = true };
+};
+
+/** Frame arena allocator with the default alignment */
+using FMTGFrameArenaAllocator = TMTGFrameArenaAllocator<>;
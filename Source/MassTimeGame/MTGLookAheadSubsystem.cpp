@@ -0,0 +1,449 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGLookAheadSubsystem.h"
+
+#include "DrawDebugHelpers.h"
+#include "MassCommonFragments.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutionContext.h"
+#include "MassMovementFragments.h"
+#include "MassTimeGame.h"
+#include "MTGCrowdDensitySubsystem.h"
+#include "MTGMassFragments.h"
+#include "MTGSimTimeSubsystem.h"
+#include "MTGWanderSteeringProcessor.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Tasks/Task.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Look Ahead Fork"), STAT_MTGLookAheadFork, STATGROUP_MassTimeGame);
+DECLARE_CYCLE_STAT(TEXT("MTG Look Ahead Step"), STAT_MTGLookAheadStep, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Look Ahead Forked Entities"), STAT_MTGLookAheadForkedEntities, STATGROUP_MassTimeGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("MTG Look Ahead Forks Taken"), STAT_MTGLookAheadForksTaken, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::LookAhead
+{
+	static bool bEnabled = false;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("mtg.LookAhead"),
+		bEnabled,
+		TEXT("If true, preview where the wanderers near the cursor will be a few sim seconds from now"));
+
+	/** Ghosts are drawn a little above the ground so they aren't hidden by it */
+	static constexpr double GhostHeight = 20.;
+}
+
+/**
+ * A private copy of the wanderers near the focus, stepped forward in time.
+ *
+ * Built on the game thread by TakeFork, then only touched by one worker slice
+ * at a time until it's complete, after which it's read only.
+ */
+struct FMTGLookAheadFork
+{
+	/** Focus and sim time when the fork was taken */
+	FVector Focus = FVector::ZeroVector;
+	double ForkSimTime = 0.;
+
+	/** The live entity each forked entity was copied from */
+	TArray<FMassEntityHandle> Entities;
+
+	/** Forked fragments, one per entity; never resized once Ranges point into them */
+	TArray<FTransformFragment> Transforms;
+	TArray<FMassVelocityFragment> Velocities;
+	TArray<FMTGWanderTargetFragment> Targets;
+	TArray<FMTGWanderSteeringParameters> Parameters;
+
+	/** The part of the density grid the forked entities can reach, frozen at fork time */
+	FMTGCrowdDensityGrid DensityGrid;
+
+	/** Steering work items, one per forked chunk */
+	TArray<UE::MTG::WanderSteering::FEntityRange> Ranges;
+
+	float StepSeconds = 0.f;
+	int32 NumSteps = 0;
+	int32 StepsDone = 0;
+
+	/** Predicted locations, [Sample * Entities.Num() + EntityIndex]; sample 0 is the fork time, the last is the horizon */
+	int32 NumSamples = 0;
+	TArray<FVector> Paths;
+
+	bool IsComplete() const { return StepsDone >= NumSteps; }
+
+	/** @return Step after which Sample is recorded */
+	int32 GetSampleStep(const int32 Sample) const
+	{
+		return FMath::RoundToInt32(static_cast<double>(Sample) * NumSteps / (NumSamples - 1));
+	}
+
+	/** Append the current locations as the next path sample */
+	void RecordSample()
+	{
+		for (const FTransformFragment& Transform : Transforms)
+		{
+			Paths.Add(Transform.GetTransform().GetLocation());
+		}
+	}
+
+	/**
+	 * Step forward until complete or the budget runs out.  Always makes at
+	 * least one step, so a too small budget is slow rather than stuck.
+	 * @param BudgetSeconds Wall time this slice may take
+	 */
+	void Step(const double BudgetSeconds)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_MTGLookAheadStep);
+
+		const double StartTime = FPlatformTime::Seconds();
+		do
+		{
+			for (const UE::MTG::WanderSteering::FEntityRange& Range : Ranges)
+			{
+				UE::MTG::WanderSteering::SteerAndIntegrate(Range, StepSeconds);
+			}
+
+			++StepsDone;
+			while (Paths.Num() < NumSamples * Entities.Num() && StepsDone >= GetSampleStep(Paths.Num() / Entities.Num()))
+			{
+				RecordSample();
+			}
+		}
+		while (!IsComplete() && FPlatformTime::Seconds() - StartTime < BudgetSeconds);
+	}
+
+	/**
+	 * Get where the fork predicts an entity is, some time after the fork was taken
+	 * @param EntityIndex Index into Entities
+	 * @param Seconds Sim seconds since ForkSimTime
+	 * @return Predicted location, interpolated between path samples
+	 */
+	FVector GetPredictedLocation(const int32 EntityIndex, const double Seconds) const
+	{
+		const double Alpha = FMath::Clamp(Seconds / (NumSteps * StepSeconds), 0., 1.) * (NumSamples - 1);
+		const int32 Sample = FMath::Min(FMath::FloorToInt32(Alpha), NumSamples - 2);
+		const int32 NumEntities = Entities.Num();
+		return FMath::Lerp(Paths[Sample * NumEntities + EntityIndex], Paths[(Sample + 1) * NumEntities + EntityIndex], Alpha - Sample);
+	}
+};
+
+// Set Class Defaults
+UMTGLookAheadSubsystem::UMTGLookAheadSubsystem()
+{
+	LookAheadSeconds = 5.f;
+	StepSeconds = 1.f / 30.f;
+	FocusRadius = 3000.f;
+	MaxForkedEntities = 1024;
+	FrameBudgetMs = 1.f;
+	NumPathSamples = 6;
+	DivergenceTolerance = 50.f;
+	NumDivergenceSamples = 16;
+	RefocusDistance = 500.f;
+}
+
+void UMTGLookAheadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+	}
+}
+
+void UMTGLookAheadSubsystem::Deinitialize()
+{
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	SliceTask.Wait();
+	RunningFork.Reset();
+	Result.Reset();
+	bHasFocus = false;
+
+	Super::Deinitialize();
+}
+
+bool UMTGLookAheadSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UMTGLookAheadSubsystem::IsEnabled()
+{
+	return UE::MTG::LookAhead::bEnabled;
+}
+
+void UMTGLookAheadSubsystem::SetFocus(const FVector& Location)
+{
+	FocusLocation = Location;
+	bHasFocus = true;
+}
+
+void UMTGLookAheadSubsystem::ClearFocus()
+{
+	// A running slice keeps its own reference to the fork, so it's safe to drop ours
+	bHasFocus = false;
+	RunningFork.Reset();
+	Result.Reset();
+}
+
+void UMTGLookAheadSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	if (LIKELY(!IsEnabled() || !bHasFocus))
+	{
+		return;
+	}
+
+	if (Result && !IsResultValid())
+	{
+		Result.Reset();
+	}
+
+	if (!Result && !RunningFork)
+	{
+		TakeFork();
+	}
+}
+
+void UMTGLookAheadSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (LIKELY(!IsEnabled()))
+	{
+		if (bHasFocus)
+		{
+			ClearFocus();
+		}
+		return;
+	}
+
+	// There are no sim tick boundaries while paused, so fork here instead
+	if (bHasFocus && !Result && !RunningFork && SimTimeSubsystem && SimTimeSubsystem->IsPaused())
+	{
+		SimTimeSubsystem->FlushSimPipeline();
+		TakeFork();
+	}
+
+	if (RunningFork && SliceTask.IsCompleted())
+	{
+		if (RunningFork->IsComplete())
+		{
+			Result = MoveTemp(RunningFork);
+		}
+		else
+		{
+			// One slice per frame, so the fork never costs more than FrameBudgetMs of worker time per frame
+			SliceTask = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+				[Fork = RunningFork.ToSharedRef(), BudgetSeconds = FrameBudgetMs / 1000.]()
+				{
+					Fork->Step(BudgetSeconds);
+				});
+		}
+	}
+
+	if (Result)
+	{
+		DrawGhosts();
+	}
+}
+
+void UMTGLookAheadSubsystem::TakeFork()
+{
+	check(IsInGameThread());
+	check(SimTimeSubsystem);
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGLookAheadFork);
+
+	UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntitySubsystem))
+	{
+		return;
+	}
+
+	FMassEntityManager& EntityManager = EntitySubsystem->GetMutableEntityManager();
+
+	const TSharedRef<FMTGLookAheadFork, ESPMode::ThreadSafe> Fork = MakeShared<FMTGLookAheadFork, ESPMode::ThreadSafe>();
+	Fork->Focus = FocusLocation;
+	Fork->ForkSimTime = SimTimeSubsystem->GetSimTimeElapsed();
+	Fork->StepSeconds = StepSeconds;
+	Fork->NumSteps = FMath::Max(1, FMath::CeilToInt32(LookAheadSeconds / StepSeconds));
+
+	// Sampling and ghost drawing divide by NumSamples - 1. ClampMin only guards the editor, not a hand edited ini.
+	ensureMsgf(NumPathSamples >= 2, TEXT("NumPathSamples must be at least 2, not %d"), NumPathSamples);
+	Fork->NumSamples = FMath::Clamp(NumPathSamples, 2, Fork->NumSteps + 1);
+
+	FMassEntityQuery Query(EntityManager.AsShared());
+	Query.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddRequirement<FMassVelocityFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddRequirement<FMTGWanderTargetFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddConstSharedRequirement<FMTGWanderSteeringParameters>();
+	Query.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+
+	// Chunk ranges as offsets, since the arrays may still grow; turned into pointers once they're final
+	struct FForkedChunk
+	{
+		int32 Start = 0;
+		int32 Num = 0;
+		int32 ParametersIndex = 0;
+	};
+	TArray<FForkedChunk> ForkedChunks;
+	TMap<const FMTGWanderSteeringParameters*, int32> ParametersIndices;
+
+	const double RadiusSquared = FMath::Square(FocusRadius);
+	float MaxSpeed = 0.f;
+
+	FMassExecutionContext ExecutionContext(EntityManager);
+	Query.ForEachEntityChunk(ExecutionContext, [this, &Fork, &ForkedChunks, &ParametersIndices, RadiusSquared, &MaxSpeed](FMassExecutionContext& Context)
+	{
+		const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+		const TConstArrayView<FMassVelocityFragment> Velocities = Context.GetFragmentView<FMassVelocityFragment>();
+		const TConstArrayView<FMTGWanderTargetFragment> Targets = Context.GetFragmentView<FMTGWanderTargetFragment>();
+		const TConstArrayView<FMassEntityHandle> Entities = Context.GetEntities();
+		const FMTGWanderSteeringParameters& Parameters = Context.GetConstSharedFragment<FMTGWanderSteeringParameters>();
+
+		const int32 Start = Fork->Entities.Num();
+		const int32 NumEntities = Context.GetNumEntities();
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities && Fork->Entities.Num() < MaxForkedEntities; ++EntityIndex)
+		{
+			if (FVector::DistSquaredXY(Transforms[EntityIndex].GetTransform().GetLocation(), FocusLocation) <= RadiusSquared)
+			{
+				Fork->Entities.Add(Entities[EntityIndex]);
+				Fork->Transforms.Add(Transforms[EntityIndex]);
+				Fork->Velocities.Add(Velocities[EntityIndex]);
+				Fork->Targets.Add(Targets[EntityIndex]);
+			}
+		}
+
+		const int32 NumForked = Fork->Entities.Num() - Start;
+		if (NumForked > 0)
+		{
+			int32* ParametersIndex = ParametersIndices.Find(&Parameters);
+			if (!ParametersIndex)
+			{
+				ParametersIndex = &ParametersIndices.Add(&Parameters, Fork->Parameters.Add(Parameters));
+			}
+
+			ForkedChunks.Add({Start, NumForked, *ParametersIndex});
+			MaxSpeed = FMath::Max(MaxSpeed, Parameters.MaxSpeed);
+		}
+	});
+
+	if (Fork->Entities.Num() == 0)
+	{
+		return;
+	}
+
+	// Copy only the density cells the forked entities can reach before the horizon
+	const UMTGCrowdDensitySubsystem* DensitySubsystem = GetWorld()->GetSubsystem<UMTGCrowdDensitySubsystem>();
+	const FMTGCrowdDensityGrid* LiveGrid = DensitySubsystem ? &DensitySubsystem->GetGrid() : nullptr;
+	if (LiveGrid && LiveGrid->Num() > 0)
+	{
+		const double Reach = FocusRadius + MaxSpeed * LookAheadSeconds + LiveGrid->CellSize;
+		const int32 MinX = FMath::Clamp(FMath::FloorToInt32((FocusLocation.X - Reach - LiveGrid->Origin.X) / LiveGrid->CellSize), 0, LiveGrid->NumX - 1);
+		const int32 MinY = FMath::Clamp(FMath::FloorToInt32((FocusLocation.Y - Reach - LiveGrid->Origin.Y) / LiveGrid->CellSize), 0, LiveGrid->NumY - 1);
+		const int32 MaxX = FMath::Clamp(FMath::FloorToInt32((FocusLocation.X + Reach - LiveGrid->Origin.X) / LiveGrid->CellSize), 0, LiveGrid->NumX - 1);
+		const int32 MaxY = FMath::Clamp(FMath::FloorToInt32((FocusLocation.Y + Reach - LiveGrid->Origin.Y) / LiveGrid->CellSize), 0, LiveGrid->NumY - 1);
+
+		FMTGCrowdDensityGrid& Grid = Fork->DensityGrid;
+		Grid.Init(LiveGrid->Origin + FVector2D(MinX, MinY) * LiveGrid->CellSize, LiveGrid->CellSize, MaxX - MinX + 1, MaxY - MinY + 1);
+		for (int32 Y = 0; Y < Grid.NumY; ++Y)
+		{
+			const int32 LiveRow = (MinY + Y) * LiveGrid->NumX + MinX;
+			FMemory::Memcpy(&Grid.Density[Y * Grid.NumX], &LiveGrid->Density[LiveRow], Grid.NumX * sizeof(float));
+			FMemory::Memcpy(&Grid.AverageVelocity[Y * Grid.NumX], &LiveGrid->AverageVelocity[LiveRow], Grid.NumX * sizeof(FVector2f));
+		}
+	}
+
+	for (const FForkedChunk& Chunk : ForkedChunks)
+	{
+		UE::MTG::WanderSteering::FEntityRange& Range = Fork->Ranges.AddDefaulted_GetRef();
+		Range.Transforms = &Fork->Transforms[Chunk.Start];
+		Range.Velocities = &Fork->Velocities[Chunk.Start];
+		Range.Targets = &Fork->Targets[Chunk.Start];
+		Range.Parameters = &Fork->Parameters[Chunk.ParametersIndex];
+		Range.DensityGrid = Fork->DensityGrid.Num() > 0 ? &Fork->DensityGrid : nullptr;
+		Range.Num = Chunk.Num;
+	}
+
+	Fork->Paths.Reserve(Fork->NumSamples * Fork->Entities.Num());
+	Fork->RecordSample();
+
+	SET_DWORD_STAT(STAT_MTGLookAheadForkedEntities, Fork->Entities.Num());
+	INC_DWORD_STAT(STAT_MTGLookAheadForksTaken);
+
+	RunningFork = Fork;
+}
+
+bool UMTGLookAheadSubsystem::IsResultValid() const
+{
+	check(Result);
+
+	if (FVector::DistSquaredXY(Result->Focus, FocusLocation) > FMath::Square(RefocusDistance))
+	{
+		return false;
+	}
+
+	// Retake it while there's still time left to show
+	const double Elapsed = SimTimeSubsystem->GetSimTimeElapsed() - Result->ForkSimTime;
+	if (Elapsed > 0.5 * LookAheadSeconds)
+	{
+		return false;
+	}
+
+	const UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	if (!EntitySubsystem)
+	{
+		return false;
+	}
+
+	const FMassEntityManager& EntityManager = EntitySubsystem->GetEntityManager();
+	const int32 NumEntities = Result->Entities.Num();
+	const int32 Stride = FMath::Max(1, NumEntities / NumDivergenceSamples);
+	const double ToleranceSquared = FMath::Square(DivergenceTolerance);
+
+	for (int32 EntityIndex = 0; EntityIndex < NumEntities; EntityIndex += Stride)
+	{
+		// Despawned entities are parked far away, so they diverge too
+		const FMassEntityHandle Entity = Result->Entities[EntityIndex];
+		const FTransformFragment* Transform = EntityManager.IsEntityActive(Entity) ? EntityManager.GetFragmentDataPtr<FTransformFragment>(Entity) : nullptr;
+		if (!Transform
+			|| FVector::DistSquaredXY(Transform->GetTransform().GetLocation(), Result->GetPredictedLocation(EntityIndex, Elapsed)) > ToleranceSquared)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UMTGLookAheadSubsystem::DrawGhosts() const
+{
+#if ENABLE_DRAW_DEBUG
+	const UWorld* World = GetWorld();
+	const FMTGLookAheadFork& Fork = *Result;
+	const int32 NumEntities = Fork.Entities.Num();
+	const double Elapsed = SimTimeSubsystem ? SimTimeSubsystem->GetSimTimeElapsed() - Fork.ForkSimTime : 0.;
+	const double SampleSeconds = Fork.NumSteps * Fork.StepSeconds / (Fork.NumSamples - 1);
+	const FVector Lift(0., 0., UE::MTG::LookAhead::GhostHeight);
+	const FColor PathColor(80, 200, 255, 128);
+
+	// Draw the rest of each predicted path, from where the entity should be now to the horizon
+	const int32 FirstSample = FMath::Clamp(FMath::FloorToInt32(Elapsed / SampleSeconds) + 1, 1, Fork.NumSamples - 1);
+	for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+	{
+		FVector Start = Fork.GetPredictedLocation(EntityIndex, Elapsed) + Lift;
+		for (int32 Sample = FirstSample; Sample < Fork.NumSamples; ++Sample)
+		{
+			const FVector End = Fork.Paths[Sample * NumEntities + EntityIndex] + Lift;
+			DrawDebugLine(World, Start, End, PathColor, false, -1.f, SDPG_World, 1.f);
+			Start = End;
+		}
+		DrawDebugPoint(World, Start, 8.f, FColor::Cyan, false, -1.f, SDPG_World);
+	}
+#endif
+}
@@ -0,0 +1,149 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "MTGLookAheadSubsystem.generated.h"
+
+class UMTGSimTimeSubsystem;
+struct FMTGLookAheadFork;
+
+/**
+ * MTG Look Ahead Subsystem
+ *
+ * Previews where the wanderers near the cursor will be a few sim seconds from
+ * now, while the player hovers or holds a destination.
+ *
+ * At a sim tick boundary, the wanderers within FocusRadius of the cursor are
+ * copied out of their chunks into a private fork, along with the part of the
+ * crowd density grid they can reach.  The fork is stepped forward with the
+ * same steering kernel as UMTGWanderSteeringProcessor, on a worker task, in
+ * slices of at most FrameBudgetMs per frame.  The live world, its entities
+ * and its SimTickNumber are never touched.
+ *
+ * Once the fork reaches LookAheadSeconds, its predicted paths are drawn as
+ * ghosts.  The result is reused until the live state diverges from it: at
+ * every sim tick a few of the forked entities are compared with where the
+ * fork predicted they'd be by now.  A fork is also retaken when the cursor
+ * moves away or half of the look ahead time has played out.
+ *
+ * Only steering and movement are forked; StateTree doesn't run in the fork,
+ * so wanderers that reach their destination stop there instead of picking a
+ * new one.
+ *
+ * Toggle it with mtg.LookAhead.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Look Ahead Subsystem"))
+class MASSTIMEGAME_API UMTGLookAheadSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGLookAheadSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	//~Begin UTickableWorldSubsystem interface
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UMTGLookAheadSubsystem, STATGROUP_Tickables); }
+	virtual void Tick(float DeltaTime) override;
+	//~End UTickableWorldSubsystem interface
+
+	/**
+	 * Is the look ahead preview enabled?
+	 * @return True if enabled, else False
+	 */
+	static bool IsEnabled();
+
+	/**
+	 * Set the location to preview around.  Call every frame while the player hovers or holds a destination.
+	 * @param Location World location under the cursor
+	 */
+	void SetFocus(const FVector& Location);
+
+	/** Stop previewing; the current ghosts are discarded */
+	void ClearFocus();
+
+protected:
+	/** Sim seconds to look ahead */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0.1, ForceUnits="s"))
+	float LookAheadSeconds;
+
+	/** Fixed sim DeltaTime used to step the fork */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0.005, ForceUnits="s"))
+	float StepSeconds;
+
+	/** Wanderers within this distance (cm) of the focus are forked */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=100, ForceUnits="cm"))
+	float FocusRadius;
+
+	/** Never fork more than this many wanderers, so a single step stays well inside the budget */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	int32 MaxForkedEntities;
+
+	/** Worker CPU time (ms) the fork may use per frame */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0.01, ForceUnits="ms"))
+	float FrameBudgetMs;
+
+	/** Predicted locations recorded per entity over LookAheadSeconds; also the ghost path resolution */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=2))
+	int32 NumPathSamples;
+
+	/** The fork is retaken when a sampled live entity is further than this (cm) from its prediction */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1, ForceUnits="cm"))
+	float DivergenceTolerance;
+
+	/** Number of forked entities compared with the live world each sim tick */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	int32 NumDivergenceSamples;
+
+	/** The fork is retaken when the focus moves further than this (cm) from where it was taken */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ForceUnits="cm"))
+	float RefocusDistance;
+
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/**
+	 * Copy the wanderers around the focus into a new fork.  Game thread, sim tick boundary.
+	 */
+	void TakeFork();
+
+	/**
+	 * Is the finished fork still a good prediction of the live world?
+	 * @return True if it can be reused, else False
+	 */
+	bool IsResultValid() const;
+
+	/** Draw the finished fork's predicted paths */
+	void DrawGhosts() const;
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** Where the player is looking, if bHasFocus */
+	FVector FocusLocation = FVector::ZeroVector;
+	bool bHasFocus = false;
+
+	/** The fork being stepped by the worker slices, if any; defined in the .cpp */
+	TSharedPtr<FMTGLookAheadFork, ESPMode::ThreadSafe> RunningFork;
+
+	/** The last finished fork, drawn until it's invalidated */
+	TSharedPtr<FMTGLookAheadFork, ESPMode::ThreadSafe> Result;
+
+	/** The worker slice currently stepping RunningFork */
+	UE::Tasks::FTask SliceTask;
+};
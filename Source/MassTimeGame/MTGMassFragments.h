@@ -0,0 +1,138 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassEntityTypes.h"
+#include "MassLODTypes.h"
+#include "Math/RandomStream.h"
+#include "MTGMassFragments.generated.h"
+
+/**
+ * Per-entity deterministic random stream.
+ *
+ * Seeded by UMTGRandomStreamInitializer from the world seed plus the entity's
+ * creation index.  Anything that wants reproducible randomness for an entity
+ * (StateTree tasks, processors) should draw from this instead of FMath::Rand,
+ * so results don't depend on processing order or thread count.
+ */
+USTRUCT()
+struct MASSTIMEGAME_API FMTGRandomStreamFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FRandomStream Stream;
+};
+
+/**
+ * Marks a despawned entity that UMTGSpawnerSubsystem keeps for reuse.
+ *
+ * Recycled entities are parked far away and must be ignored by every MTG
+ * processor and query that treats entities as live wanderers.
+ */
+USTRUCT()
+struct MASSTIMEGAME_API FMTGRecycledTag : public FMassTag
+{
+	GENERATED_BODY()
+};
+
+/**
+ * What UMTGStateTreeProfilerProcessor saw of this entity's StateTree last tick,
+ * so it can count the entity's state transitions since then.
+ * Added by UMTGStateTreeProfilerTrait.
+ */
+USTRUCT()
+struct MASSTIMEGAME_API FMTGStateTreeProfileFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** FStateTreeExecutionState::StateChangeCount at the last sample */
+	UPROPERTY()
+	uint16 LastStateChangeCount = 0;
+
+	/** Profiling session of the last sample; LastStateChangeCount is stale if it isn't the current one */
+	UPROPERTY()
+	uint16 SampleGeneration = 0;
+};
+
+/**
+ * The representation LOD that UMTGLODHysteresisProcessor lets this entity have,
+ * and the change the LOD processor has been asking for.
+ * Added by UMTGRepresentationLODHysteresisTrait.
+ */
+USTRUCT()
+struct MASSTIMEGAME_API FMTGRepresentationLODHoldFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** LOD the representation is using */
+	UPROPERTY()
+	TEnumAsByte<EMassLOD::Type> LOD = EMassLOD::Max;
+
+	/** LOD the LOD processor wants instead, or Max if it agrees with LOD */
+	UPROPERTY()
+	TEnumAsByte<EMassLOD::Type> PendingLOD = EMassLOD::Max;
+
+	/** GFrameCounter of the last update; a gap (e.g. the entity was recycled) starts over */
+	UPROPERTY()
+	uint32 LastFrameNumber = 0;
+
+	/** Viewer distance (cm) when PendingLOD was first wanted */
+	UPROPERTY()
+	float PendingDistance = 0.f;
+
+	/** Real time (seconds) when PendingLOD was first wanted */
+	UPROPERTY()
+	double PendingSinceTime = 0.;
+
+	/** Real time (seconds) when LOD last changed */
+	UPROPERTY()
+	double LastSwitchTime = 0.;
+};
+
+/**
+ * Where a wanderer steered by UMTGWanderSteeringProcessor is heading.
+ *
+ * Set by FMTGFindRandomDestinationTask (or anything else that wants to move the entity).
+ */
+USTRUCT()
+struct MASSTIMEGAME_API FMTGWanderTargetFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** World location to steer toward */
+	UPROPERTY()
+	FVector Destination = FVector::ZeroVector;
+
+	/** When false, the entity brakes to a stop instead of steering toward Destination */
+	UPROPERTY()
+	bool bHasDestination = false;
+};
+
+/**
+ * Movement limits for UMTGWanderSteeringProcessor, shared by all entities of a config
+ */
+USTRUCT()
+struct MASSTIMEGAME_API FMTGWanderSteeringParameters : public FMassConstSharedFragment
+{
+	GENERATED_BODY()
+
+	/** Maximum speed (cm/s) */
+	UPROPERTY(EditAnywhere, Category="Movement", meta=(ClampMin=0, ForceUnits="cm/s"))
+	float MaxSpeed = 200.f;
+
+	/** Maximum change of velocity per second (cm/s^2) */
+	UPROPERTY(EditAnywhere, Category="Movement", meta=(ClampMin=0))
+	float MaxAcceleration = 400.f;
+
+	/** Distance (cm) from the destination at which the entity starts slowing down to arrive */
+	UPROPERTY(EditAnywhere, Category="Movement", meta=(ClampMin=1, ForceUnits="cm"))
+	float SlowdownRadius = 150.f;
+
+	/**
+	 * Speed (cm/s) added away from crowds, per entity of density difference
+	 * between the neighboring crowd density cells.  0 disables avoidance.
+	 */
+	UPROPERTY(EditAnywhere, Category="Movement", meta=(ClampMin=0, ForceUnits="cm/s"))
+	float DensityAvoidanceStrength = 10.f;
+};
@@ -0,0 +1,231 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGMassMemReport.h"
+
+#include "MassArchetypeData.h"
+#include "MassCommonFragments.h"
+#include "MassDebugger.h"
+#include "MassEntityManager.h"
+#include "MassEntityQuery.h"
+#include "MassEntitySubsystem.h"
+#include "MassTimeGame.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace UE::MTG::MassMemReport
+{
+	/** The report from the previous mtg.MassMemReport in this session, to diff against */
+	static TArray<FMTGArchetypeMemory> PreviousReport;
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdMassMemReport(
+		TEXT("mtg.MassMemReport"),
+		TEXT("Log memory per Mass archetype, diffed against the previous report (or the given CSV), and save it as CSV. Usage: mtg.MassMemReport [PreviousCsv]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			const UMassEntitySubsystem* EntitySubsystem = World ? World->GetSubsystem<UMassEntitySubsystem>() : nullptr;
+			if (!EntitySubsystem)
+			{
+				return;
+			}
+
+			TArray<FMTGArchetypeMemory> Previous;
+			if (Args.Num() > 0)
+			{
+				LoadCsv(Args[0], Previous);
+			}
+			else
+			{
+				Previous = PreviousReport;
+			}
+
+			TArray<FMTGArchetypeMemory> Report = Gather(EntitySubsystem->GetEntityManager());
+			Log(Report, Previous.Num() > 0 ? &Previous : nullptr);
+			SaveCsv(Report, MakeReportFilename());
+
+			PreviousReport = MoveTemp(Report);
+		}));
+
+	/** Gather every archetype handle we can see */
+	static TArray<FMassArchetypeHandle> GetAllArchetypes(const FMassEntityManager& EntityManager)
+	{
+#if WITH_MASSENTITY_DEBUG
+		return FMassDebugger::GetAllArchetypes(EntityManager);
+#else
+		// Without the debugger we can only see archetypes a query can match; every simulated entity has a transform
+		FMassEntityQuery Query(const_cast<FMassEntityManager&>(EntityManager).AsShared());
+		Query.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+		Query.CacheArchetypes();
+		return Query.GetArchetypes();
+#endif
+	}
+
+	static FString JoinTypeNames(TArray<const UScriptStruct*> Types)
+	{
+		Types.Sort([](const UScriptStruct& A, const UScriptStruct& B) { return A.GetName() < B.GetName(); });
+
+		FString Result;
+		for (const UScriptStruct* Type : Types)
+		{
+			Result += Result.IsEmpty() ? Type->GetName() : TEXT("+") + Type->GetName();
+		}
+		return Result;
+	}
+
+	TArray<FMTGArchetypeMemory> Gather(const FMassEntityManager& EntityManager)
+	{
+		TArray<FMTGArchetypeMemory> Report;
+
+		for (const FMassArchetypeHandle& ArchetypeHandle : GetAllArchetypes(EntityManager))
+		{
+			const FMassArchetypeData* ArchetypeData = FMassArchetypeHelper::ArchetypeDataFromHandle(ArchetypeHandle);
+			if (!ArchetypeData)
+			{
+				continue;
+			}
+
+			const FMassArchetypeCompositionDescriptor& Composition = ArchetypeData->GetCompositionDescriptor();
+
+			TArray<const UScriptStruct*> FragmentTypes;
+			TArray<const UScriptStruct*> TagTypes;
+			TArray<const UScriptStruct*> SharedTypes;
+			Composition.Fragments.ExportTypes(FragmentTypes);
+			Composition.Tags.ExportTypes(TagTypes);
+			Composition.SharedFragments.ExportTypes(SharedTypes);
+			Composition.ConstSharedFragments.ExportTypes(SharedTypes);
+
+			FMTGArchetypeMemory& Archetype = Report.AddDefaulted_GetRef();
+			Archetype.Key = JoinTypeNames(FragmentTypes) + TEXT("|") + JoinTypeNames(TagTypes);
+			Archetype.NumEntities = ArchetypeData->GetNumEntities();
+			Archetype.NumChunks = ArchetypeData->GetChunkCount();
+			Archetype.ChunkBytes = ArchetypeData->GetChunkAllocSize();
+
+			// Every entity also stores its handle in the chunk
+			Archetype.Fragments.Add({TEXT("FMassEntityHandle"), static_cast<int32>(sizeof(FMassEntityHandle))});
+			for (const UScriptStruct* FragmentType : FragmentTypes)
+			{
+				Archetype.Fragments.Add({FragmentType->GetName(), Align(FragmentType->GetStructureSize(), FragmentType->GetMinAlignment())});
+			}
+
+			Archetype.Fragments.Sort([](const FMTGFragmentMemory& A, const FMTGFragmentMemory& B) { return A.BytesPerEntity > B.BytesPerEntity; });
+			for (const FMTGFragmentMemory& Fragment : Archetype.Fragments)
+			{
+				Archetype.BytesPerEntity += Fragment.BytesPerEntity;
+			}
+
+			for (const UScriptStruct* SharedType : SharedTypes)
+			{
+				const int64 PerEntityBytes = static_cast<int64>(Archetype.NumEntities) * SharedType->GetStructureSize();
+				const int64 PerChunkBytes = static_cast<int64>(Archetype.NumChunks) * SharedType->GetStructureSize();
+				Archetype.SharedDedupSavings += FMath::Max<int64>(0, PerEntityBytes - PerChunkBytes);
+			}
+		}
+
+		Report.Sort([](const FMTGArchetypeMemory& A, const FMTGArchetypeMemory& B) { return A.GetTotalBytes() > B.GetTotalBytes(); });
+		return Report;
+	}
+
+	void Log(const TArray<FMTGArchetypeMemory>& Report, const TArray<FMTGArchetypeMemory>* Previous)
+	{
+		auto FindPrevious = [Previous](const FString& Key) -> const FMTGArchetypeMemory*
+		{
+			return Previous ? Previous->FindByPredicate([&Key](const FMTGArchetypeMemory& Archetype) { return Archetype.Key == Key; }) : nullptr;
+		};
+
+		int64 TotalBytes = 0;
+		int64 TotalDedupSavings = 0;
+		int32 TotalEntities = 0;
+
+		for (const FMTGArchetypeMemory& Archetype : Report)
+		{
+			const FMTGArchetypeMemory* Before = FindPrevious(Archetype.Key);
+			const FString Delta = Before
+				? FString::Printf(TEXT(" (%+lld KiB, %+d entities)"), (Archetype.GetTotalBytes() - Before->GetTotalBytes()) / 1024, Archetype.NumEntities - Before->NumEntities)
+				: (Previous ? TEXT(" (new)") : TEXT(""));
+
+			UE_LOG(LogMassTimeGame, Log, TEXT("MassMem %8lld KiB%s: %d entities, %d chunks of %d bytes, %d bytes/entity, shared dedup saves >= %lld KiB"),
+				Archetype.GetTotalBytes() / 1024, *Delta, Archetype.NumEntities, Archetype.NumChunks, Archetype.ChunkBytes,
+				Archetype.BytesPerEntity, Archetype.SharedDedupSavings / 1024);
+			UE_LOG(LogMassTimeGame, Log, TEXT("    %s"), *Archetype.Key);
+
+			for (const FMTGFragmentMemory& Fragment : Archetype.Fragments)
+			{
+				UE_LOG(LogMassTimeGame, Log, TEXT("    %5d B/entity %8lld KiB  %s"), Fragment.BytesPerEntity, static_cast<int64>(Fragment.BytesPerEntity) * Archetype.NumEntities / 1024, *Fragment.Name);
+			}
+
+			TotalBytes += Archetype.GetTotalBytes();
+			TotalDedupSavings += Archetype.SharedDedupSavings;
+			TotalEntities += Archetype.NumEntities;
+		}
+
+		if (Previous)
+		{
+			for (const FMTGArchetypeMemory& Before : *Previous)
+			{
+				if (!Report.ContainsByPredicate([&Before](const FMTGArchetypeMemory& Archetype) { return Archetype.Key == Before.Key; }))
+				{
+					UE_LOG(LogMassTimeGame, Log, TEXT("MassMem (gone, was %lld KiB, %d entities): %s"), Before.GetTotalBytes() / 1024, Before.NumEntities, *Before.Key);
+				}
+			}
+		}
+
+		UE_LOG(LogMassTimeGame, Log, TEXT("MassMem total: %d archetypes, %d entities, %lld KiB in chunks, shared dedup saves >= %lld KiB"),
+			Report.Num(), TotalEntities, TotalBytes / 1024, TotalDedupSavings / 1024);
+	}
+
+	bool SaveCsv(const TArray<FMTGArchetypeMemory>& Report, const FString& Filename)
+	{
+		TArray<FString> Lines;
+		Lines.Add(TEXT("Key,NumEntities,NumChunks,ChunkBytes,BytesPerEntity,SharedDedupSavings"));
+		for (const FMTGArchetypeMemory& Archetype : Report)
+		{
+			Lines.Add(FString::Printf(TEXT("%s,%d,%d,%d,%d,%lld"), *Archetype.Key, Archetype.NumEntities, Archetype.NumChunks, Archetype.ChunkBytes, Archetype.BytesPerEntity, Archetype.SharedDedupSavings));
+		}
+
+		if (!FFileHelper::SaveStringArrayToFile(Lines, *Filename))
+		{
+			UE_LOG(LogMassTimeGame, Error, TEXT("Failed to write Mass memory report [%s]"), *Filename);
+			return false;
+		}
+
+		UE_LOG(LogMassTimeGame, Log, TEXT("Saved Mass memory report [%s]"), *Filename);
+		return true;
+	}
+
+	bool LoadCsv(const FString& Filename, TArray<FMTGArchetypeMemory>& OutReport)
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *Filename))
+		{
+			UE_LOG(LogMassTimeGame, Error, TEXT("Failed to read Mass memory report [%s]"), *Filename);
+			return false;
+		}
+
+		OutReport.Reset();
+		for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)  // Skip the header
+		{
+			TArray<FString> Columns;
+			if (Lines[LineIndex].ParseIntoArray(Columns, TEXT(","), false) != 6)
+			{
+				continue;
+			}
+
+			FMTGArchetypeMemory& Archetype = OutReport.AddDefaulted_GetRef();
+			Archetype.Key = Columns[0];
+			Archetype.NumEntities = FCString::Atoi(*Columns[1]);
+			Archetype.NumChunks = FCString::Atoi(*Columns[2]);
+			Archetype.ChunkBytes = FCString::Atoi(*Columns[3]);
+			Archetype.BytesPerEntity = FCString::Atoi(*Columns[4]);
+			Archetype.SharedDedupSavings = FCString::Atoi64(*Columns[5]);
+		}
+
+		return true;
+	}
+
+	FString MakeReportFilename()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("MTG") / FString::Printf(TEXT("MassMemReport-%s.csv"), *FDateTime::Now().ToString());
+	}
+}
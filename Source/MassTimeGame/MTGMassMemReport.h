@@ -0,0 +1,87 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMassEntityManager;
+
+/**
+ * Memory used by one fragment type in one archetype
+ */
+struct FMTGFragmentMemory
+{
+	FString Name;
+
+	/** Bytes each entity pays for this fragment */
+	int32 BytesPerEntity = 0;
+};
+
+/**
+ * Memory used by one Mass archetype
+ */
+struct FMTGArchetypeMemory
+{
+	/** Fragment and tag names; identifies the archetype across reports */
+	FString Key;
+
+	int32 NumEntities = 0;
+	int32 NumChunks = 0;
+	int32 ChunkBytes = 0;
+
+	/** Per-entity fragments, largest first */
+	TArray<FMTGFragmentMemory> Fragments;
+
+	/** Sum of Fragments[].BytesPerEntity */
+	int32 BytesPerEntity = 0;
+
+	/**
+	 * Minimum bytes saved by storing shared/const shared fragments once per
+	 * value instead of once per entity.  Values are per chunk at most, so this
+	 * assumes one value per chunk.
+	 */
+	int64 SharedDedupSavings = 0;
+
+	/** All chunk memory of this archetype */
+	int64 GetTotalBytes() const { return static_cast<int64>(NumChunks) * ChunkBytes; }
+};
+
+/**
+ * Mass memory report, as produced by mtg.MassMemReport and the
+ * MTGMassMemReport commandlet.
+ */
+namespace UE::MTG::MassMemReport
+{
+	/**
+	 * Gather the memory use of every archetype, most expensive first
+	 * @param EntityManager The entity manager to inspect
+	 * @return One entry per archetype
+	 */
+	MASSTIMEGAME_API TArray<FMTGArchetypeMemory> Gather(const FMassEntityManager& EntityManager);
+
+	/**
+	 * Log a report, optionally with the change since a previous one
+	 * @param Report The current report
+	 * @param Previous A previous report to diff against, or nullptr
+	 */
+	MASSTIMEGAME_API void Log(const TArray<FMTGArchetypeMemory>& Report, const TArray<FMTGArchetypeMemory>* Previous);
+
+	/**
+	 * Save a report as CSV, one line per archetype
+	 * @param Report The report to save
+	 * @param Filename Full path of the file to write
+	 * @return True if written, else False
+	 */
+	MASSTIMEGAME_API bool SaveCsv(const TArray<FMTGArchetypeMemory>& Report, const FString& Filename);
+
+	/**
+	 * Load a report written by SaveCsv.  Only the per archetype totals are restored.
+	 * @param Filename Full path of the file to read
+	 * @param OutReport The loaded report
+	 * @return True if loaded, else False
+	 */
+	MASSTIMEGAME_API bool LoadCsv(const FString& Filename, TArray<FMTGArchetypeMemory>& OutReport);
+
+	/** @return A new timestamped filename under Saved/MTG */
+	MASSTIMEGAME_API FString MakeReportFilename();
+}
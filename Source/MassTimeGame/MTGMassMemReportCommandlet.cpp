@@ -0,0 +1,114 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGMassMemReportCommandlet.h"
+
+#include "MassEntityQuery.h"
+#include "MassEntitySubsystem.h"
+#include "MassTimeGame.h"
+#include "MTGMassFragments.h"
+#include "MTGMassMemReport.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Misc/Parse.h"
+#include "UObject/Package.h"
+
+// Set Class Defaults
+UMTGMassMemReportCommandlet::UMTGMassMemReportCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+bool UMTGMassMemReportCommandlet::HasWanderers(const FMassEntityManager& EntityManager)
+{
+	FMassEntityQuery Query(const_cast<FMassEntityManager&>(EntityManager).AsShared());
+	Query.AddRequirement<FMTGWanderTargetFragment>(EMassFragmentAccess::None);
+	Query.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+	return Query.GetNumMatchingEntities() > 0;
+}
+
+int32 UMTGMassMemReportCommandlet::Main(const FString& Params)
+{
+	using namespace UE::MTG::MassMemReport;
+
+	FString MapName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Usage: -run=MTGMassMemReport -Map=/Game/Maps/MyMap [-Frames=300] [-Out=Report.csv] [-Diff=Previous.csv]"));
+		return 1;
+	}
+
+	int32 NumFrames = 300;
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+
+	FString OutFilename = MakeReportFilename();
+	FParse::Value(*Params, TEXT("Out="), OutFilename);
+
+	FString DiffFilename;
+	FParse::Value(*Params, TEXT("Diff="), DiffFilename);
+
+	UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World)
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Failed to load map [%s]"), *MapName);
+		return 1;
+	}
+
+	// Bring the world up as a game world, so our (Game/PIE only) subsystems and the Mass spawners run
+	World->AddToRoot();
+	World->WorldType = EWorldType::Game;
+
+	// The game mode is created through the world's game instance
+	UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.OwningGameInstance = GameInstance;
+	WorldContext.SetCurrentWorld(World);
+	World->SetGameInstance(GameInstance);
+
+	// Without a game mode, BeginPlay never reaches the actors (StartPlay) and the spawners never spawn
+	const FURL URL;
+	World->InitWorld();
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	constexpr float FrameSeconds = 1.f / 30.f;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		World->Tick(LEVELTICK_All, FrameSeconds);
+	}
+
+	int32 Result = 1;
+	const UMassEntitySubsystem* EntitySubsystem = World->GetSubsystem<UMassEntitySubsystem>();
+	if (!EntitySubsystem)
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Map [%s] has no MassEntitySubsystem"), *MapName);
+	}
+	else if (!HasWanderers(EntitySubsystem->GetEntityManager()))
+	{
+		// A report of an empty world would diff as a huge (and meaningless) saving
+		UE_LOG(LogMassTimeGame, Error, TEXT("No wanderers spawned in map [%s] after %d frames; nothing to report"), *MapName, NumFrames);
+	}
+	else
+	{
+		TArray<FMTGArchetypeMemory> Previous;
+		const bool bHasPrevious = !DiffFilename.IsEmpty() && LoadCsv(DiffFilename, Previous);
+
+		const TArray<FMTGArchetypeMemory> Report = Gather(EntitySubsystem->GetEntityManager());
+		Log(Report, bHasPrevious ? &Previous : nullptr);
+		Result = SaveCsv(Report, OutFilename) ? 0 : 1;
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	GameInstance->RemoveFromRoot();
+
+	return Result;
+}
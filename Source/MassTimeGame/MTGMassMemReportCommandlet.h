@@ -0,0 +1,42 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "MTGMassMemReportCommandlet.generated.h"
+
+struct FMassEntityManager;
+
+/**
+ * MTG Mass Memory Report Commandlet
+ *
+ * Loads a map as a game world (with a game instance and game mode, so the
+ * actors begin play), runs it for a number of frames so the spawners create
+ * their entities, then writes the mtg.MassMemReport CSV and logs it,
+ * optionally diffed against a previous CSV.  Fails if no wanderers spawned.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd MassTimeGame.uproject -run=MTGMassMemReport
+ *     -Map=/Game/Maps/MyMap [-Frames=300] [-Out=Report.csv] [-Diff=Previous.csv]
+ */
+UCLASS()
+class UMTGMassMemReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGMassMemReportCommandlet();
+
+	//~Begin UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+	//~End UCommandlet interface
+
+protected:
+	/**
+	 * Are there any live (not recycled) wanderers?
+	 * @param EntityManager Entity manager of the loaded world
+	 * @return True if at least one wanderer exists, else False
+	 */
+	static bool HasWanderers(const FMassEntityManager& EntityManager);
+};
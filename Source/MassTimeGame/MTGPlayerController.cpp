@@ -5,6 +5,8 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "MassTimeGame.h"
+#include "MTGFlowFieldSubsystem.h"
+#include "MTGLookAheadSubsystem.h"
 #include "MTGSimControlWidget.h"
 #include "MTGSimTimeSubsystem.h"
 #include "NiagaraComponent.h"
@@ -83,6 +85,23 @@ void AMTGPlayerController::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 
+	// Preview where the crowd under the cursor is going; holding a destination keeps the focus on it
+	if (UNLIKELY(UMTGLookAheadSubsystem::IsEnabled()) && !bIsTouch && FollowTime <= 0.f)
+	{
+		if (UMTGLookAheadSubsystem* LookAheadSubsystem = GetWorld()->GetSubsystem<UMTGLookAheadSubsystem>())
+		{
+			FHitResult Hit;
+			if (GetHitResultUnderCursor(ECollisionChannel::ECC_Visibility, true, Hit))
+			{
+				LookAheadSubsystem->SetFocus(Hit.Location);
+			}
+			else
+			{
+				LookAheadSubsystem->ClearFocus();
+			}
+		}
+	}
+
 	// Since we're dilating global time, Niagara particles will dilate as well.
 	// In the case of the Cursor FX system, we don't want that.
 	//
@@ -199,6 +218,11 @@ void AMTGPlayerController::OnSetDestinationTriggered()
 	if (bHitSuccessful)
 	{
 		CachedDestination = Hit.Location;
+
+		if (UMTGLookAheadSubsystem* LookAheadSubsystem = UMTGLookAheadSubsystem::IsEnabled() ? World->GetSubsystem<UMTGLookAheadSubsystem>() : nullptr)
+		{
+			LookAheadSubsystem->SetFocus(CachedDestination);
+		}
 	}
 	
 	// Move towards mouse pointer or touch
@@ -218,6 +242,15 @@ void AMTGPlayerController::OnSetDestinationReleased()
 		// We move there and spawn some particles
 		UAIBlueprintHelperLibrary::SimpleMoveToLocation(this, CachedDestination);
 
+		// Measure how long until the sim shows the effect of this click
+		SimTimeSubsystem->RequestSimInput(EMTGSimInput::SetDestination);
+
+		// Let the crowd react to the click, if enabled
+		if (UMTGFlowFieldSubsystem* FlowFieldSubsystem = GetWorld()->GetSubsystem<UMTGFlowFieldSubsystem>())
+		{
+			FlowFieldSubsystem->NotifyPlayerClicked(CachedDestination);
+		}
+
 		// Spawn the Niagara cursor component
 		UNiagaraComponent* NewFXComponent = UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, FXCursor, CachedDestination, FRotator::ZeroRotator, FVector(1.f, 1.f, 1.f), true, true, ENCPoolMethod::None, true);
 		NewFXComponent->SetForceSolo(true);  // Force it into solo mode so we can tick it
@@ -245,21 +278,28 @@ void AMTGPlayerController::OnTouchReleased()
 {
 	bIsTouch = false;
 	OnSetDestinationReleased();
+
+	// There's no hover on touch screens, so the preview ends with the touch
+	if (UMTGLookAheadSubsystem* LookAheadSubsystem = GetWorld()->GetSubsystem<UMTGLookAheadSubsystem>())
+	{
+		LookAheadSubsystem->ClearFocus();
+	}
 }
 
 void AMTGPlayerController::Input_TogglePlayPause()
 {
-	SimTimeSubsystem->TogglePlayPause();
+	// Applied at the next tick boundary, before the next Mass phase starts
+	SimTimeSubsystem->RequestSimInput(EMTGSimInput::TogglePlayPause);
 }
 
 void AMTGPlayerController::Input_IncreaseSimSpeed()
 {
-	SimTimeSubsystem->IncreaseSimSpeed();
+	SimTimeSubsystem->RequestSimInput(EMTGSimInput::IncreaseSimSpeed);
 }
 
 void AMTGPlayerController::Input_DecreaseSimSpeed()
 {
-	SimTimeSubsystem->DecreaseSimSpeed();
+	SimTimeSubsystem->RequestSimInput(EMTGSimInput::DecreaseSimSpeed);
 }
 
 #undef DEBUG_MTG_NIAGARA_SYSTEMS
@@ -0,0 +1,49 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGRandomStreamTrait.h"
+
+#include "MassEntityTemplateRegistry.h"
+#include "MassExecutionContext.h"
+#include "MTGMassFragments.h"
+#include "MTGRandomSubsystem.h"
+#include "Engine/World.h"
+
+void UMTGRandomStreamTrait::BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const
+{
+	BuildContext.AddFragment<FMTGRandomStreamFragment>();
+}
+
+// Set Class Defaults
+UMTGRandomStreamInitializer::UMTGRandomStreamInitializer()
+	: EntityQuery(*this)
+{
+	ObservedType = FMTGRandomStreamFragment::StaticStruct();
+	Operation = EMassObservedOperation::Add;
+
+	// Seeds MUST be allocated in entity creation order, so no parallel execution
+	bRequiresGameThreadExecution = true;
+}
+
+void UMTGRandomStreamInitializer::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FMTGRandomStreamFragment>(EMassFragmentAccess::ReadWrite);
+}
+
+void UMTGRandomStreamInitializer::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	UMTGRandomSubsystem* RandomSubsystem = UWorld::GetSubsystem<UMTGRandomSubsystem>(EntityManager.GetWorld());
+	if (!ensureMsgf(RandomSubsystem, TEXT("MTGRandomSubsystem is required")))
+	{
+		return;
+	}
+
+	EntityQuery.ForEachEntityChunk(Context, [RandomSubsystem](FMassExecutionContext& Context)
+	{
+		const TArrayView<FMTGRandomStreamFragment> RandomStreams = Context.GetMutableFragmentView<FMTGRandomStreamFragment>();
+
+		for (int32 EntityIndex = 0; EntityIndex < Context.GetNumEntities(); ++EntityIndex)
+		{
+			RandomStreams[EntityIndex].Stream.Initialize(RandomSubsystem->AllocateEntityStreamSeed());
+		}
+	});
+}
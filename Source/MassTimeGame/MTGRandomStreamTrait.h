@@ -0,0 +1,50 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassEntityTraitBase.h"
+#include "MassObserverProcessor.h"
+#include "MTGRandomStreamTrait.generated.h"
+
+/**
+ * MTG Random Stream Trait
+ *
+ * Add this to an entity config (e.g. MEC_Wanderer) to give each entity its own
+ * deterministic FMTGRandomStreamFragment.
+ */
+UCLASS(meta=(DisplayName="MTG Random Stream"))
+class MASSTIMEGAME_API UMTGRandomStreamTrait : public UMassEntityTraitBase
+{
+	GENERATED_BODY()
+
+protected:
+	//~Begin UMassEntityTraitBase interface
+	virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+	//~End UMassEntityTraitBase interface
+};
+
+/**
+ * MTG Random Stream Initializer
+ *
+ * Seeds the FMTGRandomStreamFragment of every newly created entity.
+ *
+ * This runs on the game thread so that entities are seeded in creation order,
+ * which is what makes the seeds stable from run to run.
+ */
+UCLASS()
+class MASSTIMEGAME_API UMTGRandomStreamInitializer : public UMassObserverProcessor
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGRandomStreamInitializer();
+
+protected:
+	//~Begin UMassProcessor interface
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+	//~End UMassProcessor interface
+
+	FMassEntityQuery EntityQuery;
+};
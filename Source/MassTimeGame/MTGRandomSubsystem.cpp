@@ -0,0 +1,31 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGRandomSubsystem.h"
+
+#include "MassTimeGame.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+// Set Class Defaults
+UMTGRandomSubsystem::UMTGRandomSubsystem()
+{
+	WorldSeed = 0x4D5447;  // "MTG"
+}
+
+void UMTGRandomSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Allow benchmark scripts to choose the seed without editing config
+	FParse::Value(FCommandLine::Get(), TEXT("MTGSeed="), WorldSeed);
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("World random seed is %d"), WorldSeed);
+}
+
+int32 UMTGRandomSubsystem::AllocateEntityStreamSeed()
+{
+	check(IsInGameThread());
+
+	const uint32 EntityIndex = NumAllocatedStreams++;
+	return static_cast<int32>(HashCombineFast(GetTypeHash(WorldSeed), GetTypeHash(EntityIndex)));
+}
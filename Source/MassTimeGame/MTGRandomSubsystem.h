@@ -0,0 +1,59 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGRandomSubsystem.generated.h"
+
+/**
+ * MTG Random Subsystem
+ *
+ * Owns the world random seed, and hands out a deterministic seed for each
+ * entity's FMTGRandomStreamFragment.
+ *
+ * Entity seeds are derived from the world seed and the order in which the
+ * entities were created, NOT from their entity handles, so the same seed
+ * gives the same per-entity random sequences on every run, regardless of
+ * how many threads Mass uses to process them.
+ *
+ * The seed is read from Config, and can be overridden on the command line
+ * with -MTGSeed=12345
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Random Subsystem"))
+class MASSTIMEGAME_API UMTGRandomSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGRandomSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	//~End USubsystem interface
+
+	/**
+	 * Get the seed of this world
+	 * @return World random seed
+	 */
+	int32 GetWorldSeed() const { return WorldSeed; }
+
+	/**
+	 * Allocate the seed for the next entity random stream.
+	 *
+	 * MUST be called in a deterministic order (e.g. from a game thread observer
+	 * processor, in entity creation order).
+	 *
+	 * @return Seed to use for the next entity's FRandomStream
+	 */
+	int32 AllocateEntityStreamSeed();
+
+protected:
+	/** Seed from which all entity random streams are derived */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	int32 WorldSeed;
+
+private:
+	/** Number of entity streams allocated so far; this is the stable entity index */
+	uint32 NumAllocatedStreams = 0;
+};
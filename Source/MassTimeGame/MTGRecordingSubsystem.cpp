@@ -0,0 +1,969 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGRecordingSubsystem.h"
+
+#include "MassCommonFragments.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutionContext.h"
+#include "MassMovementFragments.h"
+#include "MassTimeGame.h"
+#include "MTGMassFragments.h"
+#include "MTGSimTimeSubsystem.h"
+#include "MTGSpawnerSubsystem.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Compression.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Recording Gather"), STAT_MTGRecordingGather, STATGROUP_MassTimeGame);
+DECLARE_CYCLE_STAT(TEXT("MTG Recording Encode"), STAT_MTGRecordingEncode, STATGROUP_MassTimeGame);
+DECLARE_CYCLE_STAT(TEXT("MTG Playback Decode"), STAT_MTGPlaybackDecode, STATGROUP_MassTimeGame);
+DECLARE_CYCLE_STAT(TEXT("MTG Playback Apply"), STAT_MTGPlaybackApply, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Recording Frame Bytes"), STAT_MTGRecordingFrameBytes, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Playback Frames Decoded"), STAT_MTGPlaybackFramesDecoded, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::Recording
+{
+	static constexpr uint32 FileMagic = 0x5247544D;  // "MTGR"
+	static constexpr uint32 FileVersion = 1;
+
+	/** One wanderer in one frame, quantized */
+	struct FSample
+	{
+		/** FMassEntityHandle::Index */
+		int32 Id = 0;
+
+		/** Location / PositionQuantum */
+		int32 X = 0;
+		int32 Y = 0;
+		int32 Z = 0;
+
+		/** Yaw in 1/65536 turns */
+		uint16 Yaw = 0;
+	};
+
+	struct FFileHeader
+	{
+		uint32 Magic = FileMagic;
+		uint32 Version = FileVersion;
+		float PositionQuantum = 1.f;
+		int32 KeyframeInterval = 1;
+
+		friend FArchive& operator<<(FArchive& Ar, FFileHeader& Header)
+		{
+			return Ar << Header.Magic << Header.Version << Header.PositionQuantum << Header.KeyframeInterval;
+		}
+	};
+
+	/**
+	 * Precedes each frame's payload.
+	 * The payload is LZ4 compressed if and only if StoredSize < RawSize.
+	 */
+	struct FFrameHeader
+	{
+		uint64 SimTickNumber = 0;
+		double SimTimeElapsed = 0.;
+		float SimTimeDilation = 1.f;
+		int32 NumEntities = 0;
+		bool bKeyframe = false;
+		int32 StoredSize = 0;
+		int32 RawSize = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FFrameHeader& Header)
+		{
+			return Ar << Header.SimTickNumber << Header.SimTimeElapsed << Header.SimTimeDilation
+				<< Header.NumEntities << Header.bKeyframe << Header.StoredSize << Header.RawSize;
+		}
+	};
+
+	/** Footer index entry of one keyframe */
+	struct FKeyframeEntry
+	{
+		double SimTimeElapsed = 0.;
+		int64 Offset = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FKeyframeEntry& Entry)
+		{
+			return Ar << Entry.SimTimeElapsed << Entry.Offset;
+		}
+	};
+
+	/**
+	 * Last bytes of a finished recording.  The footer (keyframe index, end time)
+	 * starts at FooterOffset.  A recording without it (e.g. the game crashed) is
+	 * scanned frame by frame instead.
+	 */
+	struct FTrailer
+	{
+		int64 FooterOffset = 0;
+		uint32 Magic = FileMagic;
+
+		static constexpr int64 Size = sizeof(int64) + sizeof(uint32);
+
+		friend FArchive& operator<<(FArchive& Ar, FTrailer& Trailer)
+		{
+			return Ar << Trailer.FooterOffset << Trailer.Magic;
+		}
+	};
+
+	static uint32 ZigZag(const int32 Value) { return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31); }
+	static int32 UnZigZag(const uint32 Value) { return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1); }
+
+	static void WriteVarUint(TArray<uint8>& Out, uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.Add(static_cast<uint8>(Value) | 0x80);
+			Value >>= 7;
+		}
+		Out.Add(static_cast<uint8>(Value));
+	}
+
+	/** @return False if the payload ended mid value */
+	static bool ReadVarUint(const uint8*& Data, const uint8* End, uint32& OutValue)
+	{
+		OutValue = 0;
+		for (int32 Shift = 0; Shift < 35 && Data < End; Shift += 7)
+		{
+			const uint8 Byte = *Data++;
+			OutValue |= static_cast<uint32>(Byte & 0x7F) << Shift;
+			if (!(Byte & 0x80))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * Encode a frame's samples (sorted by Id) against the previous frame's.
+	 * Each sample is: Id gap, then X, Y, Z and Yaw deltas from the same Id in
+	 * Previous (or from zero if it's not there), all as zigzag varints.
+	 */
+	static void EncodeFrame(TConstArrayView<FSample> Samples, TConstArrayView<FSample> Previous, TArray<uint8>& Out)
+	{
+		static const FSample Zero;
+
+		int32 LastId = -1;
+		int32 PreviousIndex = 0;
+
+		for (const FSample& Sample : Samples)
+		{
+			while (PreviousIndex < Previous.Num() && Previous[PreviousIndex].Id < Sample.Id)
+			{
+				++PreviousIndex;
+			}
+			const FSample& Base = PreviousIndex < Previous.Num() && Previous[PreviousIndex].Id == Sample.Id ? Previous[PreviousIndex] : Zero;
+
+			WriteVarUint(Out, static_cast<uint32>(Sample.Id - LastId - 1));
+			WriteVarUint(Out, ZigZag(Sample.X - Base.X));
+			WriteVarUint(Out, ZigZag(Sample.Y - Base.Y));
+			WriteVarUint(Out, ZigZag(Sample.Z - Base.Z));
+			WriteVarUint(Out, ZigZag(static_cast<int16>(Sample.Yaw - Base.Yaw)));
+			LastId = Sample.Id;
+		}
+	}
+
+	/** Inverse of EncodeFrame */
+	static bool DecodeFrame(const uint8* Data, const uint8* End, const int32 NumEntities, TConstArrayView<FSample> Previous, TArray<FSample>& OutSamples)
+	{
+		static const FSample Zero;
+
+		OutSamples.SetNumUninitialized(NumEntities);
+
+		int32 LastId = -1;
+		int32 PreviousIndex = 0;
+
+		for (FSample& Sample : OutSamples)
+		{
+			uint32 IdGap, DX, DY, DZ, DYaw;
+			if (!ReadVarUint(Data, End, IdGap) || !ReadVarUint(Data, End, DX) || !ReadVarUint(Data, End, DY)
+				|| !ReadVarUint(Data, End, DZ) || !ReadVarUint(Data, End, DYaw))
+			{
+				return false;
+			}
+
+			Sample.Id = LastId + 1 + static_cast<int32>(IdGap);
+			LastId = Sample.Id;
+
+			while (PreviousIndex < Previous.Num() && Previous[PreviousIndex].Id < Sample.Id)
+			{
+				++PreviousIndex;
+			}
+			const FSample& Base = PreviousIndex < Previous.Num() && Previous[PreviousIndex].Id == Sample.Id ? Previous[PreviousIndex] : Zero;
+
+			Sample.X = Base.X + UnZigZag(DX);
+			Sample.Y = Base.Y + UnZigZag(DY);
+			Sample.Z = Base.Z + UnZigZag(DZ);
+			Sample.Yaw = static_cast<uint16>(Base.Yaw + UnZigZag(DYaw));
+		}
+
+		return true;
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdRecord(
+		TEXT("mtg.Record"),
+		TEXT("Start/stop recording the wanderer transforms. Usage: mtg.Record [Filename]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UMTGRecordingSubsystem* RecordingSubsystem = World ? World->GetSubsystem<UMTGRecordingSubsystem>() : nullptr)
+			{
+				if (RecordingSubsystem->IsRecording())
+				{
+					RecordingSubsystem->StopRecording();
+				}
+				else
+				{
+					RecordingSubsystem->StartRecording(Args.Num() > 0 ? Args[0] : UMTGRecordingSubsystem::GetDefaultRecordingFilename());
+				}
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdPlayback(
+		TEXT("mtg.Playback"),
+		TEXT("Start/stop playing back a recording instead of simulating. Usage: mtg.Playback [Filename]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UMTGRecordingSubsystem* RecordingSubsystem = World ? World->GetSubsystem<UMTGRecordingSubsystem>() : nullptr)
+			{
+				if (RecordingSubsystem->IsPlayingBack())
+				{
+					RecordingSubsystem->StopPlayback();
+				}
+				else
+				{
+					RecordingSubsystem->StartPlayback(Args.Num() > 0 ? Args[0] : UMTGRecordingSubsystem::GetDefaultRecordingFilename());
+				}
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdPlaybackSeek(
+		TEXT("mtg.PlaybackSeek"),
+		TEXT("Jump to a time in the recording being played back. Usage: mtg.PlaybackSeek <SecondsFromStart>"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UMTGRecordingSubsystem* RecordingSubsystem = World ? World->GetSubsystem<UMTGRecordingSubsystem>() : nullptr;
+			if (RecordingSubsystem && Args.Num() > 0)
+			{
+				RecordingSubsystem->SeekPlayback(FCString::Atod(*Args[0]));
+			}
+		}));
+}
+
+/**
+ * State of an in-progress recording.  Only the RecordPipe touches it while recording.
+ */
+struct FMTGRecorder
+{
+	TUniquePtr<FArchive> Writer;
+	FString Filename;
+
+	float PositionQuantum = 1.f;
+	int32 KeyframeInterval = 1;
+
+	/** Last frame written, sorted by Id */
+	TArray<UE::MTG::Recording::FSample> Previous;
+
+	TArray<UE::MTG::Recording::FKeyframeEntry> Keyframes;
+	double LastFrameTime = 0.;
+	int64 NumFrames = 0;
+	int64 RawBytes = 0;
+	int64 StoredBytes = 0;
+
+	/** Encode, compress and append one frame.  RecordPipe. */
+	void WriteFrame(TArray<UE::MTG::Recording::FSample>&& Samples, const FMTGSimClockState& Clock)
+	{
+		using namespace UE::MTG::Recording;
+
+		SCOPE_CYCLE_COUNTER(STAT_MTGRecordingEncode);
+
+		Algo::SortBy(Samples, &FSample::Id);
+
+		FFrameHeader Header;
+		Header.SimTickNumber = Clock.SimTickNumber;
+		Header.SimTimeElapsed = Clock.SimTimeElapsed;
+		Header.SimTimeDilation = Clock.SimTimeDilation;
+		Header.NumEntities = Samples.Num();
+		Header.bKeyframe = NumFrames % KeyframeInterval == 0;
+
+		TArray<uint8> Raw;
+		Raw.Reserve(Samples.Num() * 6);
+		EncodeFrame(Samples, Header.bKeyframe ? TConstArrayView<FSample>() : TConstArrayView<FSample>(Previous), Raw);
+		Header.RawSize = Raw.Num();
+
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_LZ4, Raw.Num());
+		TArray<uint8> Compressed;
+		Compressed.SetNumUninitialized(CompressedSize);
+
+		// If it didn't get any smaller, just store it raw
+		TArray<uint8>* Stored = &Raw;
+		if (FCompression::CompressMemory(NAME_LZ4, Compressed.GetData(), CompressedSize, Raw.GetData(), Raw.Num())
+			&& CompressedSize < Raw.Num())
+		{
+			Compressed.SetNum(CompressedSize);
+			Stored = &Compressed;
+		}
+		Header.StoredSize = Stored->Num();
+
+		if (Header.bKeyframe)
+		{
+			Keyframes.Add({Header.SimTimeElapsed, Writer->Tell()});
+		}
+
+		*Writer << Header;
+		Writer->Serialize(Stored->GetData(), Stored->Num());
+
+		Previous = MoveTemp(Samples);
+		LastFrameTime = Header.SimTimeElapsed;
+		++NumFrames;
+		RawBytes += Header.RawSize;
+		StoredBytes += Header.StoredSize;
+
+		SET_DWORD_STAT(STAT_MTGRecordingFrameBytes, Header.StoredSize);
+	}
+
+	/** Write the footer and close the file */
+	void Finish()
+	{
+		using namespace UE::MTG::Recording;
+
+		FTrailer Trailer;
+		Trailer.FooterOffset = Writer->Tell();
+
+		*Writer << Keyframes;
+		*Writer << LastFrameTime;
+		*Writer << Trailer;
+
+		const bool bClosed = Writer->Close();
+		Writer.Reset();
+
+		UE_LOG(LogMassTimeGame, Log, TEXT("%s recording [%s]: %lld frames, %.1f MB (%.1f MB before LZ4)"),
+			bClosed ? TEXT("Finished") : TEXT("FAILED to finish"), *Filename, NumFrames, StoredBytes / (1024. * 1024.), RawBytes / (1024. * 1024.));
+	}
+};
+
+/**
+ * State of a playback.  Only one decode task at a time touches it.
+ */
+struct FMTGPlayer
+{
+	TUniquePtr<FArchive> Reader;
+	FString Filename;
+
+	UE::MTG::Recording::FFileHeader FileHeader;
+	TArray<UE::MTG::Recording::FKeyframeEntry> Keyframes;
+
+	/** Time of the first and last frames */
+	double StartTime = 0.;
+	double EndTime = 0.;
+
+	/** Frames are stored in [first frame, FramesEnd) */
+	int64 FramesEnd = 0;
+
+	/** Last decoded frame, sorted by Id */
+	TArray<UE::MTG::Recording::FSample> Current;
+	TArray<UE::MTG::Recording::FSample> Scratch;
+	double CurrentTime = 0.;
+	bool bHasFrame = false;
+
+	/** Offset of the frame after Current */
+	int64 NextOffset = 0;
+
+	/** Target of the last DecodeTo */
+	double LastTargetTime = -1.;
+
+	/** Current as instance transforms; bInstancesDirty until the game thread applies them */
+	TArray<FTransform> Instances;
+	FVector InstanceScale = FVector::OneVector;
+	bool bInstancesDirty = false;
+
+	/** Set if the file turns out to be corrupt */
+	bool bFailed = false;
+
+	/** Open the file and read (or rebuild) its keyframe index */
+	bool Open(const FString& InFilename)
+	{
+		using namespace UE::MTG::Recording;
+
+		Filename = InFilename;
+		Reader.Reset(IFileManager::Get().CreateFileReader(*Filename));
+		if (!Reader)
+		{
+			UE_LOG(LogMassTimeGame, Error, TEXT("Failed to open recording [%s]"), *Filename);
+			return false;
+		}
+
+		*Reader << FileHeader;
+		if (Reader->IsError() || FileHeader.Magic != FileMagic || FileHeader.Version != FileVersion)
+		{
+			UE_LOG(LogMassTimeGame, Error, TEXT("[%s] is not a version %u recording"), *Filename, FileVersion);
+			return false;
+		}
+
+		const int64 FirstFrameOffset = Reader->Tell();
+		const int64 FileSize = Reader->TotalSize();
+
+		FTrailer Trailer;
+		if (FileSize - FTrailer::Size >= FirstFrameOffset)
+		{
+			Reader->Seek(FileSize - FTrailer::Size);
+			*Reader << Trailer;
+		}
+
+		if (!Reader->IsError() && Trailer.Magic == FileMagic && Trailer.FooterOffset >= FirstFrameOffset && Trailer.FooterOffset < FileSize)
+		{
+			Reader->Seek(Trailer.FooterOffset);
+			*Reader << Keyframes;
+			*Reader << EndTime;
+			FramesEnd = Trailer.FooterOffset;
+		}
+		else
+		{
+			// Unfinished recording: index it the slow way, up to the last whole frame
+			Reader->ClearError();
+			UE_LOG(LogMassTimeGame, Warning, TEXT("Recording [%s] was not finished; scanning it"), *Filename);
+
+			int64 Offset = FirstFrameOffset;
+			FramesEnd = FirstFrameOffset;
+			while (Offset < FileSize)
+			{
+				Reader->Seek(Offset);
+				FFrameHeader Header;
+				*Reader << Header;
+				const int64 FrameEnd = Reader->Tell() + Header.StoredSize;
+				if (Reader->IsError() || Header.StoredSize < 0 || FrameEnd > FileSize)
+				{
+					break;
+				}
+
+				if (Header.bKeyframe)
+				{
+					Keyframes.Add({Header.SimTimeElapsed, Offset});
+				}
+				EndTime = Header.SimTimeElapsed;
+				Offset = FramesEnd = FrameEnd;
+			}
+			Reader->ClearError();
+		}
+
+		if (Reader->IsError() || Keyframes.Num() == 0)
+		{
+			UE_LOG(LogMassTimeGame, Error, TEXT("Recording [%s] has no frames"), *Filename);
+			return false;
+		}
+
+		StartTime = Keyframes[0].SimTimeElapsed;
+		NextOffset = Keyframes[0].Offset;
+		return true;
+	}
+
+	/**
+	 * Decode up to the last frame at or before TargetTime (or the first frame).  Decode task.
+	 * @return Number of frames decoded
+	 */
+	int32 DecodeTo(const double TargetTime)
+	{
+		using namespace UE::MTG::Recording;
+
+		SCOPE_CYCLE_COUNTER(STAT_MTGPlaybackDecode);
+
+		LastTargetTime = TargetTime;
+
+		// Going backwards, or past another keyframe: start again from the last keyframe before the target
+		const int32 KeyframeIndex = FMath::Max(0, Algo::UpperBoundBy(Keyframes, TargetTime, &FKeyframeEntry::SimTimeElapsed) - 1);
+		if (!bHasFrame || TargetTime < CurrentTime || Keyframes[KeyframeIndex].SimTimeElapsed > CurrentTime)
+		{
+			NextOffset = Keyframes[KeyframeIndex].Offset;
+			Current.Reset();
+			bHasFrame = false;
+		}
+
+		int32 NumDecoded = 0;
+		TArray<uint8> Stored;
+		TArray<uint8> Raw;
+
+		while (NextOffset < FramesEnd)
+		{
+			Reader->Seek(NextOffset);
+			FFrameHeader Header;
+			*Reader << Header;
+			if (bHasFrame && Header.SimTimeElapsed > TargetTime)
+			{
+				break;
+			}
+
+			Stored.SetNumUninitialized(Header.StoredSize);
+			Reader->Serialize(Stored.GetData(), Stored.Num());
+
+			const uint8* Payload = Stored.GetData();
+			if (Header.StoredSize < Header.RawSize)
+			{
+				Raw.SetNumUninitialized(Header.RawSize);
+				if (!FCompression::UncompressMemory(NAME_LZ4, Raw.GetData(), Raw.Num(), Stored.GetData(), Stored.Num()))
+				{
+					bFailed = true;
+					break;
+				}
+				Payload = Raw.GetData();
+			}
+
+			if (Reader->IsError()
+				|| !DecodeFrame(Payload, Payload + Header.RawSize, Header.NumEntities, Header.bKeyframe ? TConstArrayView<FSample>() : TConstArrayView<FSample>(Current), Scratch))
+			{
+				bFailed = true;
+				break;
+			}
+
+			Swap(Current, Scratch);
+			CurrentTime = Header.SimTimeElapsed;
+			bHasFrame = true;
+			NextOffset = Reader->Tell();
+			++NumDecoded;
+		}
+
+		if (NumDecoded > 0)
+		{
+			const float Quantum = FileHeader.PositionQuantum;
+			Instances.SetNumUninitialized(Current.Num());
+			for (int32 Index = 0; Index < Current.Num(); ++Index)
+			{
+				const FSample& Sample = Current[Index];
+				Instances[Index] = FTransform(
+					FRotator(0., Sample.Yaw * (360. / 65536.), 0.),
+					FVector(Sample.X, Sample.Y, Sample.Z) * Quantum,
+					InstanceScale);
+			}
+			bInstancesDirty = true;
+		}
+
+		return NumDecoded;
+	}
+};
+
+// Set Class Defaults
+UMTGRecordingSubsystem::UMTGRecordingSubsystem()
+{
+	PositionQuantum = 1.f;
+	KeyframeInterval = 300;
+	PlaybackMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Engine/BasicShapes/Cylinder.Cylinder")));
+	PlaybackMeshScale = FVector(0.5, 0.5, 1.8);
+}
+
+void UMTGRecordingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+	Collection.InitializeDependency<UMTGSpawnerSubsystem>();
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+	}
+
+	// After every tickable (including MTGSimTimeSubsystem) has ticked, so the frame's sim tick has run or been launched
+	WorldTickEndHandle = FWorldDelegates::OnWorldTickEnd.AddUObject(this, &ThisClass::NativeOnWorldTickEnd);
+}
+
+void UMTGRecordingSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickEnd.Remove(WorldTickEndHandle);
+
+	// Finish the file; DO NOT let the background tasks outlive the world.
+	// The world is going away, so there is no point in respawning the saved wanderers.
+	StopRecording();
+	ClosePlayer();
+	bLiveWanderersSaved = false;
+	SavedTransforms.Empty();
+	SavedVelocities.Empty();
+	SavedWanderTargets.Empty();
+
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+bool UMTGRecordingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMTGRecordingSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	FString Filename;
+	if (FParse::Value(FCommandLine::Get(), TEXT("MTGPlayback="), Filename))
+	{
+		StartPlayback(Filename);
+	}
+}
+
+FString UMTGRecordingSubsystem::GetDefaultRecordingFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT("MTG") / TEXT("Recording.mtgrec");
+}
+
+bool UMTGRecordingSubsystem::StartRecording(const FString& Filename)
+{
+	using namespace UE::MTG::Recording;
+
+	if (IsRecording() || IsPlayingBack())
+	{
+		UE_LOG(LogMassTimeGame, Warning, TEXT("Cannot record [%s] while already recording or playing back"), *Filename);
+		return false;
+	}
+
+	TSharedPtr<FMTGRecorder, ESPMode::ThreadSafe> NewRecorder = MakeShared<FMTGRecorder, ESPMode::ThreadSafe>();
+	NewRecorder->Filename = Filename;
+	NewRecorder->PositionQuantum = PositionQuantum;
+	NewRecorder->KeyframeInterval = KeyframeInterval;
+	NewRecorder->Writer.Reset(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!NewRecorder->Writer)
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Failed to open recording [%s] for writing"), *Filename);
+		return false;
+	}
+
+	FFileHeader Header;
+	Header.PositionQuantum = PositionQuantum;
+	Header.KeyframeInterval = KeyframeInterval;
+	*NewRecorder->Writer << Header;
+
+	Recorder = MoveTemp(NewRecorder);
+	LastRecordedTickNumber = MAX_uint64;
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Recording to [%s]"), *Filename);
+	return true;
+}
+
+void UMTGRecordingSubsystem::StopRecording()
+{
+	if (!Recorder)
+	{
+		return;
+	}
+
+	// The last gather queues the last write
+	GatherTask.Wait();
+	GatherTask = {};
+	RecordPipe.WaitUntilEmpty();
+
+	Recorder->Finish();
+	Recorder.Reset();
+}
+
+bool UMTGRecordingSubsystem::StartPlayback(const FString& Filename)
+{
+	// Switching recordings keeps the live wanderers saved (if they were already)
+	ClosePlayer();
+	StopRecording();
+
+	UWorld* World = GetWorld();
+	check(World);
+
+	TSharedPtr<FMTGPlayer, ESPMode::ThreadSafe> NewPlayer = MakeShared<FMTGPlayer, ESPMode::ThreadSafe>();
+	NewPlayer->InstanceScale = PlaybackMeshScale;
+	if (!NewPlayer->Open(Filename))
+	{
+		RestoreLiveWanderers();
+		return false;
+	}
+
+	UStaticMesh* Mesh = PlaybackMesh.LoadSynchronous();
+	if (!Mesh)
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Cannot play back without a PlaybackMesh"));
+		RestoreLiveWanderers();
+		return false;
+	}
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.ObjectFlags = RF_Transient;
+	PlaybackActor = World->SpawnActor<AActor>(SpawnParameters);
+
+	PlaybackInstances = NewObject<UInstancedStaticMeshComponent>(PlaybackActor, TEXT("PlaybackInstances"));
+	PlaybackInstances->SetMobility(EComponentMobility::Movable);
+	PlaybackInstances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	PlaybackInstances->SetCastShadow(false);
+	PlaybackInstances->SetStaticMesh(Mesh);
+	PlaybackActor->SetRootComponent(PlaybackInstances);
+	PlaybackInstances->RegisterComponent();
+
+	Player = MoveTemp(NewPlayer);
+	PlaybackTime = Player->StartTime;
+	bReachedPlaybackEnd = false;
+	bDespawnPending = !bLiveWanderersSaved;
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Playing back [%s]: %.1f sim seconds, %d keyframes"), *Filename, Player->EndTime - Player->StartTime, Player->Keyframes.Num());
+	return true;
+}
+
+void UMTGRecordingSubsystem::StopPlayback()
+{
+	ClosePlayer();
+	RestoreLiveWanderers();
+}
+
+void UMTGRecordingSubsystem::ClosePlayer()
+{
+	bDespawnPending = false;
+
+	DecodeTask.Wait();
+	DecodeTask = {};
+
+	if (Player)
+	{
+		UE_LOG(LogMassTimeGame, Log, TEXT("Stopped playing back [%s]"), *Player->Filename);
+		Player.Reset();
+	}
+
+	if (PlaybackActor)
+	{
+		PlaybackActor->Destroy();
+		PlaybackActor = nullptr;
+		PlaybackInstances = nullptr;
+	}
+}
+
+void UMTGRecordingSubsystem::SeekPlayback(const double Seconds)
+{
+	if (Player)
+	{
+		PlaybackTime = FMath::Clamp(Player->StartTime + Seconds, Player->StartTime, Player->EndTime);
+		bReachedPlaybackEnd = false;
+	}
+}
+
+void UMTGRecordingSubsystem::DespawnLiveWanderers()
+{
+	UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntitySubsystem) || !ensure(SimTimeSubsystem))
+	{
+		return;
+	}
+
+	FMassEntityManager& EntityManager = EntitySubsystem->GetMutableEntityManager();
+
+	FMassEntityQuery Query(EntityManager.AsShared());
+	Query.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddRequirement<FMassVelocityFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddRequirement<FMTGWanderTargetFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+
+	SavedTransforms.Reset();
+	SavedVelocities.Reset();
+	SavedWanderTargets.Reset();
+
+	TArray<FMassEntityHandle> Entities;
+	FMassExecutionContext ExecutionContext(EntityManager);
+	Query.ForEachEntityChunk(ExecutionContext, [this, &Entities](FMassExecutionContext& Context)
+	{
+		const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+		const TConstArrayView<FMassVelocityFragment> Velocities = Context.GetFragmentView<FMassVelocityFragment>();
+		const TConstArrayView<FMTGWanderTargetFragment> WanderTargets = Context.GetFragmentView<FMTGWanderTargetFragment>();
+
+		const int32 NumEntities = Context.GetNumEntities();
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			SavedTransforms.Add(Transforms[EntityIndex].GetTransform());
+			SavedVelocities.Add(Velocities[EntityIndex].Value);
+			SavedWanderTargets.Add(WanderTargets[EntityIndex]);
+		}
+
+		Entities.Append(Context.GetEntities());
+	});
+
+	// Destroyed rather than parked, so the representation observers release their actors and instances
+	EntityManager.BatchDestroyEntities(Entities);
+
+	// The parked (recycled) entities remain, but nothing processes them while Mass is suspended
+	SimTimeSubsystem->SetMassProcessingSuspended(true);
+	bLiveWanderersSaved = true;
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Saved and destroyed %d live wanderers for playback"), Entities.Num());
+}
+
+void UMTGRecordingSubsystem::RestoreLiveWanderers()
+{
+	if (!bLiveWanderersSaved)
+	{
+		return;
+	}
+	bLiveWanderersSaved = false;
+
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->SetMassProcessingSuspended(false);
+	}
+
+	UMTGSpawnerSubsystem* SpawnerSubsystem = GetWorld()->GetSubsystem<UMTGSpawnerSubsystem>();
+	const UMassEntityConfigAsset* EntityConfig = SpawnerSubsystem ? SpawnerSubsystem->GetWandererEntityConfig() : nullptr;
+	if (ensure(EntityConfig) && SavedTransforms.Num() > 0)
+	{
+		// The spawner spawns them at the next sim ticks, within its per tick budget
+		SpawnerSubsystem->RequestSpawn(*EntityConfig, SavedTransforms, SavedVelocities, SavedWanderTargets);
+		UE_LOG(LogMassTimeGame, Log, TEXT("Restoring %d live wanderers after playback"), SavedTransforms.Num());
+	}
+
+	SavedTransforms.Empty();
+	SavedVelocities.Empty();
+	SavedWanderTargets.Empty();
+}
+
+void UMTGRecordingSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	if (Player && bDespawnPending)
+	{
+		// Tick boundary, and the level's spawners have spawned by now
+		bDespawnPending = false;
+		DespawnLiveWanderers();
+	}
+
+	if (Player && !bReachedPlaybackEnd)
+	{
+		PlaybackTime += SimTimeSubsystemIn->GetSimDeltaTime();
+		if (PlaybackTime >= Player->EndTime)
+		{
+			PlaybackTime = Player->EndTime;
+			bReachedPlaybackEnd = true;
+
+			UE_LOG(LogMassTimeGame, Log, TEXT("End of recording [%s]; pausing"), *Player->Filename);
+			SimTimeSubsystemIn->PauseSimulation();
+		}
+	}
+}
+
+void UMTGRecordingSubsystem::NativeOnWorldTickEnd(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	using namespace UE::MTG::Recording;
+
+	if (World != GetWorld() || !Recorder || !SimTimeSubsystem || SimTimeSubsystem->GetSimTickNumber() == LastRecordedTickNumber)
+	{
+		return;
+	}
+
+	UMassEntitySubsystem* EntitySubsystem = World->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntitySubsystem))
+	{
+		return;
+	}
+
+	const FMTGSimClockState Clock = SimTimeSubsystem->GetSimClockState();
+	LastRecordedTickNumber = Clock.SimTickNumber;
+
+	const TSharedRef<FMassEntityManager> EntityManager = EntitySubsystem->GetMutableEntityManager().AsShared();
+	const double InvQuantum = 1. / PositionQuantum;
+
+	// Gather reads the fragments, so it must be done by the next tick boundary; the pipe encodes and writes whenever
+	GatherTask = SimTimeSubsystem->LaunchSimTickReader(TEXT("MTGRecordingGather"), [EntityManager, InvQuantum, Clock, Recorder = Recorder, Pipe = &RecordPipe]()
+	{
+		TArray<FSample> Samples;
+		{
+			SCOPE_CYCLE_COUNTER(STAT_MTGRecordingGather);
+
+			FMassEntityQuery Query(EntityManager);
+			Query.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+			Query.AddRequirement<FMTGWanderTargetFragment>(EMassFragmentAccess::None);
+			Query.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+
+			FMassExecutionContext ExecutionContext(*EntityManager);
+			Query.ForEachEntityChunk(ExecutionContext, [&Samples, InvQuantum](FMassExecutionContext& Context)
+			{
+				const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+				const TConstArrayView<FMassEntityHandle> Entities = Context.GetEntities();
+
+				const int32 NumEntities = Context.GetNumEntities();
+				for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+				{
+					const FTransform& Transform = Transforms[EntityIndex].GetTransform();
+					const FVector Location = Transform.GetLocation() * InvQuantum;
+
+					FSample& Sample = Samples.AddDefaulted_GetRef();
+					Sample.Id = Entities[EntityIndex].Index;
+					Sample.X = FMath::RoundToInt32(Location.X);
+					Sample.Y = FMath::RoundToInt32(Location.Y);
+					Sample.Z = FMath::RoundToInt32(Location.Z);
+					Sample.Yaw = static_cast<uint16>(FMath::RoundToInt32(Transform.Rotator().Yaw * (65536. / 360.)));
+				}
+			});
+		}
+
+		Pipe->Launch(TEXT("MTGRecordingWrite"), [Recorder, Samples = MoveTemp(Samples), Clock]() mutable
+		{
+			Recorder->WriteFrame(MoveTemp(Samples), Clock);
+		});
+	});
+}
+
+void UMTGRecordingSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!Player || !DecodeTask.IsCompleted())
+	{
+		return;
+	}
+
+	if (Player->bFailed)
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Recording [%s] is corrupt at %.3f s"), *Player->Filename, Player->CurrentTime - Player->StartTime);
+		StopPlayback();
+		return;
+	}
+
+	ApplyDecodedFrame();
+
+	// Decode the frame for this time on a worker; it's shown the next frame
+	if (Player->LastTargetTime != PlaybackTime)
+	{
+		DecodeTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Player = Player, Time = PlaybackTime]()
+		{
+			INC_DWORD_STAT_BY(STAT_MTGPlaybackFramesDecoded, Player->DecodeTo(Time));
+		});
+	}
+}
+
+void UMTGRecordingSubsystem::ApplyDecodedFrame()
+{
+	if (!Player->bInstancesDirty || !PlaybackInstances)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGPlaybackApply);
+
+	Player->bInstancesDirty = false;
+	const TArray<FTransform>& Instances = Player->Instances;
+
+	// Only the tail of the instance list grows or shrinks
+	const int32 NumInstances = PlaybackInstances->GetInstanceCount();
+	if (Instances.Num() < NumInstances)
+	{
+		TArray<int32> Surplus;
+		for (int32 Index = Instances.Num(); Index < NumInstances; ++Index)
+		{
+			Surplus.Add(Index);
+		}
+		PlaybackInstances->RemoveInstances(Surplus);
+	}
+	else if (Instances.Num() > NumInstances)
+	{
+		PlaybackInstances->AddInstances(TArray<FTransform>(MakeArrayView(Instances).RightChop(NumInstances)), false, true);
+	}
+
+	PlaybackInstances->BatchUpdateInstancesTransforms(0, Instances, true, true, true);
+}
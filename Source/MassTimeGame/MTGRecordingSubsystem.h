@@ -0,0 +1,198 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MTGMassFragments.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Pipe.h"
+#include "Tasks/Task.h"
+#include "MTGRecordingSubsystem.generated.h"
+
+class AActor;
+class UInstancedStaticMeshComponent;
+class UMTGSimTimeSubsystem;
+class UStaticMesh;
+struct FMTGRecorder;
+struct FMTGPlayer;
+
+/**
+ * MTG Recording Subsystem
+ *
+ * Records the wanderers' transforms every sim tick, and plays a recording
+ * back without simulating anything.
+ *
+ * Recording (mtg.Record):
+ *
+ * After each sim tick, a sim tick reader task quantizes every wanderer's
+ * location (to PositionQuantum cm) and yaw (to 1/65536 of a turn).  A
+ * background pipe then sorts them by entity, delta encodes each against the
+ * same entity in the previous frame as zigzag varints, LZ4 compresses the
+ * frame and appends it to the file.  Every KeyframeInterval'th frame is
+ * encoded without deltas, and the keyframes are indexed in a footer for
+ * seeking.  The game thread only launches the reader task.
+ *
+ * Playback (mtg.Playback, or start with -MTGPlayback=<File>):
+ *
+ * At the next sim tick boundary the live wanderers are saved and destroyed,
+ * and the Mass processing phases are suspended, so no processor (ours or
+ * the stock LOD, representation and avoidance ones) keeps working on them.
+ * The recording drives an instanced static mesh (PlaybackMesh) instead.
+ * The sim clock keeps running, and playback time advances with it, so pause
+ * and every SimSpeedOptions speed work as usual, and mtg.PlaybackSeek jumps
+ * to any time by decoding forward from the nearest keyframe.  Frames are
+ * decoded on a worker; the game thread only updates the instances.
+ *
+ * Stopping playback resumes the Mass phases and respawns the saved wanderers
+ * where they were.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Recording Subsystem"))
+class MASSTIMEGAME_API UMTGRecordingSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGRecordingSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~End UWorldSubsystem interface
+
+	//~Begin UTickableWorldSubsystem interface
+	virtual TStatId GetStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(UMTGRecordingSubsystem, STATGROUP_Tickables); }
+	virtual void Tick(float DeltaTime) override;
+	//~End UTickableWorldSubsystem interface
+
+	/**
+	 * Get the filename used when no explicit filename is given
+	 * @return Full path to the default recording file
+	 */
+	static FString GetDefaultRecordingFilename();
+
+	/**
+	 * Start recording every sim tick to a file
+	 * @param Filename Full path of the file to write
+	 * @return True if recording, else False
+	 */
+	bool StartRecording(const FString& Filename);
+
+	/** Stop recording, and finish the file once the background writes are done */
+	void StopRecording();
+
+	/** @return True if recording, else False */
+	bool IsRecording() const { return Recorder.IsValid(); }
+
+	/**
+	 * Replace the live wanderers with a recording
+	 * @param Filename Full path of the recording
+	 * @return True if playing back, else False
+	 */
+	bool StartPlayback(const FString& Filename);
+
+	/** Stop playing back, resume the Mass phases and respawn the saved live wanderers */
+	void StopPlayback();
+
+	/** @return True if playing back, else False */
+	bool IsPlayingBack() const { return Player.IsValid(); }
+
+	/**
+	 * Jump to a time in the recording
+	 * @param Seconds Sim seconds since the start of the recording
+	 */
+	void SeekPlayback(double Seconds);
+
+protected:
+	/** Recorded locations are rounded to multiples of this (cm) */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0.01, ForceUnits="cm"))
+	float PositionQuantum;
+
+	/** Every this many frames is a keyframe, which seeking starts decoding from */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	int32 KeyframeInterval;
+
+	/** Mesh instanced for each wanderer during playback */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	TSoftObjectPtr<UStaticMesh> PlaybackMesh;
+
+	/** Scale of each PlaybackMesh instance */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	FVector PlaybackMeshScale;
+
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/** Callback at the end of every world tick; records the sim tick that just ran */
+	void NativeOnWorldTickEnd(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** Save and destroy every live wanderer, and suspend Mass processing.  MUST be called at a tick boundary. */
+	void DespawnLiveWanderers();
+
+	/** Resume Mass processing and queue the saved wanderers to respawn */
+	void RestoreLiveWanderers();
+
+	/** Close the recording and destroy the playback instances, leaving the live wanderers as they are */
+	void ClosePlayer();
+
+	/** Make the playback instances match the last decoded frame */
+	void ApplyDecodedFrame();
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** Owner of PlaybackInstances */
+	UPROPERTY(Transient)
+	TObjectPtr<AActor> PlaybackActor;
+
+	/** One instance per wanderer in the current playback frame */
+	UPROPERTY(Transient)
+	TObjectPtr<UInstancedStaticMeshComponent> PlaybackInstances;
+
+	/** Recording state, used by one background task at a time; defined in the .cpp */
+	TSharedPtr<FMTGRecorder, ESPMode::ThreadSafe> Recorder;
+
+	/** Encodes and writes recorded frames in order */
+	UE::Tasks::FPipe RecordPipe { TEXT("MTGRecordPipe") };
+
+	/** The last sim tick reader that gathered a frame */
+	UE::Tasks::FTask GatherTask;
+
+	/** Sim tick last recorded */
+	uint64 LastRecordedTickNumber = MAX_uint64;
+
+	/** Playback state, used by one decode task at a time; defined in the .cpp */
+	TSharedPtr<FMTGPlayer, ESPMode::ThreadSafe> Player;
+
+	/** The in-flight decode, if any */
+	UE::Tasks::FTask DecodeTask;
+
+	/** Recording time (sim seconds) to show */
+	double PlaybackTime = 0.;
+
+	/** Has the end of the recording been reached (and the sim paused)? */
+	bool bReachedPlaybackEnd = false;
+
+	/** Should the live wanderers be despawned at the next sim tick boundary? */
+	bool bDespawnPending = false;
+
+	/** Have the live wanderers been saved and destroyed (and Mass processing suspended)? */
+	bool bLiveWanderersSaved = false;
+
+	/** The live wanderers destroyed for playback, to respawn when it stops */
+	TArray<FTransform> SavedTransforms;
+	TArray<FVector> SavedVelocities;
+	TArray<FMTGWanderTargetFragment> SavedWanderTargets;
+
+	/** Handle of our FWorldDelegates::OnWorldTickEnd subscription */
+	FDelegateHandle WorldTickEndHandle;
+};
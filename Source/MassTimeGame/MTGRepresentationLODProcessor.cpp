@@ -0,0 +1,303 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGRepresentationLODProcessor.h"
+
+#include "MassCommonFragments.h"
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+#include "MassLODFragments.h"
+#include "MassRepresentationFragments.h"
+#include "MassTimeGame.h"
+#include "MassVisualizationLODProcessor.h"
+#include "MTGMassFragments.h"
+#include "MTGRepresentationLODSubsystem.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG LOD Prediction"), STAT_MTGLODPrediction, STATGROUP_MassTimeGame);
+DECLARE_CYCLE_STAT(TEXT("MTG LOD Hysteresis"), STAT_MTGLODHysteresis, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::RepresentationLOD
+{
+	static bool bHysteresis = true;
+	static FAutoConsoleVariableRef CVarHysteresis(
+		TEXT("mtg.LODHysteresis"),
+		bHysteresis,
+		TEXT("If true, hold back wanderer representation LOD switches near the thresholds (they are counted either way)"));
+
+	static bool bPrediction = true;
+	static FAutoConsoleVariableRef CVarPrediction(
+		TEXT("mtg.LODPrediction"),
+		bPrediction,
+		TEXT("If true, promote the representation LOD of wanderers the camera is heading toward early"));
+
+	/**
+	 * LOD the Mass LOD calculator gives an entity at Distance
+	 * @param Distances Distance at which each LOD starts; High starts at 0
+	 * @param Distance Viewer distance (cm)
+	 * @return The LOD for that distance
+	 */
+	static EMassLOD::Type GetLODForDistance(const float (&Distances)[EMassLOD::Max], const float Distance)
+	{
+		int32 LOD = EMassLOD::High;
+		while (LOD + 1 < EMassLOD::Max && Distance >= Distances[LOD + 1])
+		{
+			++LOD;
+		}
+		return static_cast<EMassLOD::Type>(LOD);
+	}
+
+	/** Number of entities in each representation LOD, among those sharing one set of LOD parameters */
+	struct FLODCounts
+	{
+		const FMassVisualizationLODParameters* Parameters = nullptr;
+		int32 Num[EMassLOD::Max] = {};
+
+		/** @return True if one more entity fits in LOD without passing its max count */
+		bool HasRoom(const EMassLOD::Type LOD) const
+		{
+			return LOD >= EMassLOD::Max || Num[LOD] < Parameters->LODMaxCount[LOD];
+		}
+
+		/** Move one entity's count from one LOD to another */
+		void Move(const EMassLOD::Type FromLOD, const EMassLOD::Type ToLOD)
+		{
+			if (FromLOD < EMassLOD::Max)
+			{
+				--Num[FromLOD];
+			}
+			if (ToLOD < EMassLOD::Max)
+			{
+				++Num[ToLOD];
+			}
+		}
+	};
+
+	/** LOD counts of each set of LOD parameters in a query; there are usually only one or two */
+	struct FLODCountsByParameters
+	{
+		TArray<FLODCounts, TInlineAllocator<2>> Counts;
+
+		FLODCounts& Find(const FMassVisualizationLODParameters& Parameters)
+		{
+			for (FLODCounts& Entry : Counts)
+			{
+				if (Entry.Parameters == &Parameters)
+				{
+					return Entry;
+				}
+			}
+			FLODCounts& Entry = Counts.AddDefaulted_GetRef();
+			Entry.Parameters = &Parameters;
+			return Entry;
+		}
+
+		/** Count the representation LOD the entities of Query have now */
+		void CountCurrent(FMassEntityQuery& Query, FMassExecutionContext& ExecutionContext)
+		{
+			Query.ForEachEntityChunk(ExecutionContext, [this](FMassExecutionContext& Context)
+			{
+				FLODCounts& Entry = Find(Context.GetConstSharedFragment<FMassVisualizationLODParameters>());
+				for (const FMassRepresentationLODFragment& RepresentationLOD : Context.GetFragmentView<FMassRepresentationLODFragment>())
+				{
+					if (RepresentationLOD.LOD < EMassLOD::Max)
+					{
+						++Entry.Num[RepresentationLOD.LOD];
+					}
+				}
+			});
+		}
+	};
+}
+
+// Set Class Defaults
+UMTGLODPredictionProcessor::UMTGLODPredictionProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::LOD;
+	ExecutionOrder.ExecuteAfter.Add(UMassVisualizationLODProcessor::StaticClass()->GetFName());
+	ExecutionOrder.ExecuteBefore.Add(UMTGLODHysteresisProcessor::StaticClass()->GetFName());
+}
+
+void UMTGLODPredictionProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FMassViewerInfoFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FMassRepresentationLODFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMTGRepresentationLODHoldFragment>(EMassFragmentAccess::None);
+	EntityQuery.AddConstSharedRequirement<FMassVisualizationLODParameters>();
+	EntityQuery.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+	EntityQuery.AddSubsystemRequirement<UMTGRepresentationLODSubsystem>(EMassFragmentAccess::ReadWrite);
+}
+
+void UMTGLODPredictionProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	UMTGRepresentationLODSubsystem* LODSubsystem = Context.GetMutableSubsystem<UMTGRepresentationLODSubsystem>();
+	if (!ensure(LODSubsystem))
+	{
+		return;
+	}
+
+	FVector PredictedOffset;
+	if (!UE::MTG::RepresentationLOD::bPrediction || !LODSubsystem->GetPredictedCameraOffset(PredictedOffset))
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGLODPrediction);
+
+	using namespace UE::MTG::RepresentationLOD;
+
+	const FVector PredictedLocation = LODSubsystem->GetCameraLocation() + PredictedOffset;
+	int32 NumPredictedCloser = 0;
+
+	// A promotion must not push a LOD past its max count, so first count what the LOD processor put in each
+	FLODCountsByParameters LODCounts;
+	LODCounts.CountCurrent(EntityQuery, Context);
+
+	// The predicted distance only ever feeds the representation LOD; the viewer info other LOD users read is left alone
+	EntityQuery.ForEachEntityChunk(Context, [&PredictedLocation, &NumPredictedCloser, &LODCounts](FMassExecutionContext& Context)
+	{
+		const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+		const TConstArrayView<FMassViewerInfoFragment> ViewerInfos = Context.GetFragmentView<FMassViewerInfoFragment>();
+		const TArrayView<FMassRepresentationLODFragment> RepresentationLODs = Context.GetMutableFragmentView<FMassRepresentationLODFragment>();
+		const FMassVisualizationLODParameters& Parameters = Context.GetConstSharedFragment<FMassVisualizationLODParameters>();
+		FLODCounts& Counts = LODCounts.Find(Parameters);
+
+		const int32 NumEntities = Context.GetNumEntities();
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			const FMassViewerInfoFragment& ViewerInfo = ViewerInfos[EntityIndex];
+			const float PredictedDistanceSq = static_cast<float>(FVector::DistSquared(Transforms[EntityIndex].GetTransform().GetLocation(), PredictedLocation));
+			if (PredictedDistanceSq >= ViewerInfo.ClosestViewerDistanceSq)
+			{
+				continue;
+			}
+
+			// Only the distance is predicted; visibility is the current camera's
+			const bool bIsVisible = ViewerInfo.ClosestDistanceToFrustum <= Parameters.DistanceToFrustum;
+			const EMassLOD::Type PredictedLOD = GetLODForDistance(bIsVisible ? Parameters.VisibleLODDistance : Parameters.BaseLODDistance, FMath::Sqrt(PredictedDistanceSq));
+
+			FMassRepresentationLODFragment& RepresentationLOD = RepresentationLODs[EntityIndex];
+			if (PredictedLOD < RepresentationLOD.LOD && Counts.HasRoom(PredictedLOD))
+			{
+				Counts.Move(RepresentationLOD.LOD, PredictedLOD);
+				RepresentationLOD.LOD = PredictedLOD;
+				++NumPredictedCloser;
+			}
+		}
+	});
+
+	LODSubsystem->ReportPrediction(NumPredictedCloser);
+}
+
+// Set Class Defaults
+UMTGLODHysteresisProcessor::UMTGLODHysteresisProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::LOD;
+	ExecutionOrder.ExecuteAfter.Add(UMassVisualizationLODProcessor::StaticClass()->GetFName());
+	ExecutionOrder.ExecuteBefore.Add(UE::Mass::ProcessorGroupNames::Representation);
+}
+
+void UMTGLODHysteresisProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FMassRepresentationLODFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMassViewerInfoFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FMTGRepresentationLODHoldFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddConstSharedRequirement<FMassVisualizationLODParameters>();
+	EntityQuery.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+	EntityQuery.AddSubsystemRequirement<UMTGRepresentationLODSubsystem>(EMassFragmentAccess::ReadWrite);
+}
+
+void UMTGLODHysteresisProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MTGLODHysteresis);
+
+	UMTGRepresentationLODSubsystem* LODSubsystem = Context.GetMutableSubsystem<UMTGRepresentationLODSubsystem>();
+	if (!ensure(LODSubsystem))
+	{
+		return;
+	}
+
+	const bool bHold = UE::MTG::RepresentationLOD::bHysteresis;
+	const double Now = LODSubsystem->GetRealTimeSeconds();
+	const float DemotionScale = 1.f + LODSubsystem->GetDemotionHysteresis();
+	const double MinSecondsInLOD = LODSubsystem->GetMinSecondsInLOD();
+	const double MaxDemotionDelaySeconds = LODSubsystem->GetMaxDemotionDelaySeconds();
+	const uint32 FrameNumber = static_cast<uint32>(GFrameCounter);
+
+	int32 NumSwitches = 0;
+	int32 NumHeld = 0;
+
+	// Holding an entity back must not push the LOD it's held in past its max count either
+	UE::MTG::RepresentationLOD::FLODCountsByParameters LODCounts;
+	if (bHold)
+	{
+		LODCounts.CountCurrent(EntityQuery, Context);
+	}
+
+	EntityQuery.ForEachEntityChunk(Context, [&](FMassExecutionContext& Context)
+	{
+		const TArrayView<FMassRepresentationLODFragment> RepresentationLODs = Context.GetMutableFragmentView<FMassRepresentationLODFragment>();
+		const TConstArrayView<FMassViewerInfoFragment> ViewerInfos = Context.GetFragmentView<FMassViewerInfoFragment>();
+		const TArrayView<FMTGRepresentationLODHoldFragment> Holds = Context.GetMutableFragmentView<FMTGRepresentationLODHoldFragment>();
+		UE::MTG::RepresentationLOD::FLODCounts* Counts = bHold ? &LODCounts.Find(Context.GetConstSharedFragment<FMassVisualizationLODParameters>()) : nullptr;
+
+		const int32 NumEntities = Context.GetNumEntities();
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			FMassRepresentationLODFragment& RepresentationLOD = RepresentationLODs[EntityIndex];
+			FMTGRepresentationLODHoldFragment& Hold = Holds[EntityIndex];
+			const EMassLOD::Type WantedLOD = RepresentationLOD.LOD;
+
+			// New, or not processed last frame (e.g. just reused by the spawner): start from whatever it has now
+			if (Hold.LastFrameNumber + 1 != FrameNumber)
+			{
+				Hold.LOD = WantedLOD;
+				Hold.PendingLOD = EMassLOD::Max;
+				Hold.LastSwitchTime = Now - MinSecondsInLOD;
+			}
+			Hold.LastFrameNumber = FrameNumber;
+
+			if (WantedLOD == Hold.LOD)
+			{
+				Hold.PendingLOD = EMassLOD::Max;
+				continue;
+			}
+
+			const float Distance = FMath::Sqrt(ViewerInfos[EntityIndex].ClosestViewerDistanceSq);
+			if (WantedLOD != Hold.PendingLOD)
+			{
+				// Just crossed a threshold; the band is measured from here
+				Hold.PendingLOD = WantedLOD;
+				Hold.PendingDistance = Distance;
+				Hold.PendingSinceTime = Now;
+			}
+
+			// EMassLOD::High is 0, so a greater LOD is a demotion
+			const bool bDemotion = WantedLOD > Hold.LOD;
+			const bool bPastBand = !bDemotion
+				|| Distance >= Hold.PendingDistance * DemotionScale
+				|| Now - Hold.PendingSinceTime >= MaxDemotionDelaySeconds;
+
+			// An entity that doesn't fit in its held LOD any more switches now, whatever the hysteresis says
+			if (!bHold || (bPastBand && Now - Hold.LastSwitchTime >= MinSecondsInLOD) || !Counts->HasRoom(Hold.LOD))
+			{
+				Hold.LOD = WantedLOD;
+				Hold.PendingLOD = EMassLOD::Max;
+				Hold.LastSwitchTime = Now;
+				++NumSwitches;
+			}
+			else
+			{
+				Counts->Move(WantedLOD, Hold.LOD);
+				RepresentationLOD.LOD = Hold.LOD;
+				++NumHeld;
+			}
+		}
+	});
+
+	LODSubsystem->ReportSwitches(NumSwitches, NumHeld);
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassProcessor.h"
+#include "MTGRepresentationLODProcessor.generated.h"
+
+/**
+ * MTG LOD Prediction Processor
+ *
+ * Runs between UMassVisualizationLODProcessor and UMTGLODHysteresisProcessor.
+ * Where a wanderer is closer to the predicted camera location (see
+ * UMTGRepresentationLODSubsystem) than to the camera, its representation LOD
+ * is promoted to the one the LOD parameters give for the predicted distance,
+ * so entities the camera is heading toward are promoted before it gets there.
+ * Promotions respect each LOD's max count.
+ *
+ * The predicted distance is local to this processor: FMassViewerInfoFragment
+ * is not changed, so the simulation LOD and anything else reading it still
+ * sees the real viewer distance.  Only the distance is predicted; frustum
+ * visibility still comes from the current camera.
+ */
+UCLASS()
+class MASSTIMEGAME_API UMTGLODPredictionProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGLODPredictionProcessor();
+
+protected:
+	//~Begin UMassProcessor interface
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+	//~End UMassProcessor interface
+
+	FMassEntityQuery EntityQuery;
+};
+
+/**
+ * MTG LOD Hysteresis Processor
+ *
+ * Runs right after UMassVisualizationLODProcessor, before the representation
+ * processors act on its result.  Wherever the LOD processor changed a
+ * wanderer's LOD before the entity is allowed to switch (see
+ * UMTGRepresentationLODSubsystem), the LOD is put back to the one in the
+ * entity's FMTGRepresentationLODHoldFragment, so the representation doesn't
+ * flip between actor, ISM and none every few frames.  A hold never takes a
+ * LOD past its LODMaxCount: entities that don't fit switch right away.
+ *
+ * It also counts the switches, with or without mtg.LODHysteresis.
+ */
+UCLASS()
+class MASSTIMEGAME_API UMTGLODHysteresisProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGLODHysteresisProcessor();
+
+protected:
+	//~Begin UMassProcessor interface
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+	//~End UMassProcessor interface
+
+	FMassEntityQuery EntityQuery;
+};
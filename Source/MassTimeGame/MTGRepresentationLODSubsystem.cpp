@@ -0,0 +1,130 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGRepresentationLODSubsystem.h"
+
+#include "MassTimeGame.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("MTG LOD Switches/s"), STAT_MTGLODSwitchesPerSecond, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG LOD Switches"), STAT_MTGLODSwitches, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG LOD Switches Held"), STAT_MTGLODHeld, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG LOD Predicted Closer"), STAT_MTGLODPredictedCloser, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::RepresentationLOD
+{
+	static FAutoConsoleCommandWithWorld CmdLODStats(
+		TEXT("mtg.LODStats"),
+		TEXT("Log the wanderer representation LOD switch counters"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UMTGRepresentationLODSubsystem* LODSubsystem = World ? World->GetSubsystem<UMTGRepresentationLODSubsystem>() : nullptr)
+			{
+				const FMTGRepresentationLODStats& Stats = LODSubsystem->GetStats();
+				UE_LOG(LogMassTimeGame, Log, TEXT("Representation LOD: %.1f switches/s; %lld switches, %lld held entity frames, %lld predicted closer entity frames"),
+					Stats.SwitchesPerSecond, Stats.NumSwitches, Stats.NumHeld, Stats.NumPredictedCloser);
+			}
+		}));
+}
+
+// Set Class Defaults
+UMTGRepresentationLODSubsystem::UMTGRepresentationLODSubsystem()
+{
+	DemotionHysteresis = 0.15f;
+	MinSecondsInLOD = 0.5f;
+	MaxDemotionDelaySeconds = 2.f;
+	PredictionSeconds = 1.f;
+	MinPredictionSpeed = 100.f;
+	MaxPredictionDistance = 3000.f;
+	CameraVelocitySmoothingSeconds = 0.2f;
+}
+
+void UMTGRepresentationLODSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	WorldPreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &ThisClass::NativeOnWorldPreActorTick);
+}
+
+void UMTGRepresentationLODSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(WorldPreActorTickHandle);
+
+	Super::Deinitialize();
+}
+
+bool UMTGRepresentationLODSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMTGRepresentationLODSubsystem::NativeOnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	const double PreviousTime = RealTimeSeconds;
+	RealTimeSeconds = World->GetRealTimeSeconds();
+
+	const APlayerController* PlayerController = World->GetFirstPlayerController();
+	if (!PlayerController || !PlayerController->PlayerCameraManager)
+	{
+		bHasCamera = false;
+		CameraVelocity = FVector::ZeroVector;
+		return;
+	}
+
+	const FVector PreviousLocation = CameraLocation;
+	CameraLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+
+	const double RealDeltaTime = RealTimeSeconds - PreviousTime;
+	if (bHasCamera && RealDeltaTime > 0.)
+	{
+		// Exponential smoothing, so frame time spikes don't jerk the prediction around
+		const FVector FrameVelocity = (CameraLocation - PreviousLocation) / RealDeltaTime;
+		const double Alpha = 1. - FMath::Exp(-RealDeltaTime / CameraVelocitySmoothingSeconds);
+		CameraVelocity += (FrameVelocity - CameraVelocity) * Alpha;
+	}
+	bHasCamera = true;
+}
+
+bool UMTGRepresentationLODSubsystem::GetPredictedCameraOffset(FVector& OutOffset) const
+{
+	if (!bHasCamera || PredictionSeconds <= 0.f || CameraVelocity.SizeSquared() < FMath::Square(MinPredictionSpeed))
+	{
+		return false;
+	}
+
+	OutOffset = (CameraVelocity * PredictionSeconds).GetClampedToMaxSize(MaxPredictionDistance);
+	return true;
+}
+
+void UMTGRepresentationLODSubsystem::ReportSwitches(const int32 NumSwitches, const int32 NumHeld)
+{
+	Stats.NumSwitches += NumSwitches;
+	Stats.NumHeld += NumHeld;
+	WindowSwitches += NumSwitches;
+
+	const double WindowSeconds = RealTimeSeconds - WindowStartTime;
+	if (WindowSeconds >= 1.)
+	{
+		Stats.SwitchesPerSecond = static_cast<float>(WindowSwitches / WindowSeconds);
+		WindowSwitches = 0;
+		WindowStartTime = RealTimeSeconds;
+	}
+
+	SET_FLOAT_STAT(STAT_MTGLODSwitchesPerSecond, Stats.SwitchesPerSecond);
+	SET_DWORD_STAT(STAT_MTGLODSwitches, NumSwitches);
+	SET_DWORD_STAT(STAT_MTGLODHeld, NumHeld);
+}
+
+void UMTGRepresentationLODSubsystem::ReportPrediction(const int32 NumPredictedCloser)
+{
+	Stats.NumPredictedCloser += NumPredictedCloser;
+
+	SET_DWORD_STAT(STAT_MTGLODPredictedCloser, NumPredictedCloser);
+}
@@ -0,0 +1,172 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassExternalSubsystemTraits.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGRepresentationLODSubsystem.generated.h"
+
+/**
+ * Counters describing how often wanderers switch representation LOD
+ */
+struct FMTGRepresentationLODStats
+{
+	/** LOD switches per real second, over the last full second */
+	float SwitchesPerSecond = 0.f;
+
+	/** Total LOD switches */
+	int64 NumSwitches = 0;
+
+	/** Total entity frames where a switch the LOD processor wanted was held back */
+	int64 NumHeld = 0;
+
+	/** Total entity frames where camera prediction promoted the representation LOD */
+	int64 NumPredictedCloser = 0;
+};
+
+/**
+ * MTG Representation LOD Subsystem
+ *
+ * Settings and per-frame camera state for UMTGLODPredictionProcessor and
+ * UMTGLODHysteresisProcessor, which damp wanderer representation switches
+ * (actor, ISM, none) near the LOD thresholds.
+ *
+ * - Hysteresis: a demotion waits until the viewer is DemotionHysteresis
+ *   farther away than where the entity crossed the threshold (or for at most
+ *   MaxDemotionDelaySeconds), and every LOD is kept for at least
+ *   MinSecondsInLOD.  Promotions are not delayed by the band.
+ * - Prediction: each entity's representation LOD is taken from wherever is
+ *   closer, the camera or where it will be in PredictionSeconds at its current
+ *   velocity, so entities the camera is heading toward are promoted early.
+ *
+ * All times are real time, so they behave the same at every sim speed.
+ * Toggle them with mtg.LODHysteresis and mtg.LODPrediction; mtg.LODStats
+ * logs the switch rate.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Representation LOD Subsystem"))
+class MASSTIMEGAME_API UMTGRepresentationLODSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGRepresentationLODSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/** @return Real time (seconds) sampled at the start of this frame */
+	double GetRealTimeSeconds() const { return RealTimeSeconds; }
+
+	/**
+	 * Get how far the camera is expected to move in PredictionSeconds
+	 * @param OutOffset Predicted camera movement (cm)
+	 * @return True if the camera is moving fast enough to predict, else False
+	 */
+	bool GetPredictedCameraOffset(FVector& OutOffset) const;
+
+	/** @return Camera location sampled at the start of this frame */
+	const FVector& GetCameraLocation() const { return CameraLocation; }
+
+	/** @return See DemotionHysteresis */
+	float GetDemotionHysteresis() const { return DemotionHysteresis; }
+
+	/** @return See MinSecondsInLOD */
+	float GetMinSecondsInLOD() const { return MinSecondsInLOD; }
+
+	/** @return See MaxDemotionDelaySeconds */
+	float GetMaxDemotionDelaySeconds() const { return MaxDemotionDelaySeconds; }
+
+	/**
+	 * Add one frame's counts; only UMTGLODHysteresisProcessor should call this
+	 * @param NumSwitches Entities whose LOD changed
+	 * @param NumHeld Entities whose LOD change was held back
+	 */
+	void ReportSwitches(int32 NumSwitches, int32 NumHeld);
+
+	/**
+	 * Add one frame's count; only UMTGLODPredictionProcessor should call this
+	 * @param NumPredictedCloser Entities whose representation LOD was promoted by the prediction
+	 */
+	void ReportPrediction(int32 NumPredictedCloser);
+
+	/** @return The switch counters */
+	const FMTGRepresentationLODStats& GetStats() const { return Stats; }
+
+protected:
+	/** A demotion waits until the viewer distance has grown by this fraction since the threshold was crossed */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ClampMax=1))
+	float DemotionHysteresis;
+
+	/** Real time (seconds) an entity keeps a LOD before it may switch again */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ForceUnits="s"))
+	float MinSecondsInLOD;
+
+	/**
+	 * Real time (seconds) after which a wanted demotion happens regardless of
+	 * distance, e.g. when the camera turned away or the LOD processor had to
+	 * demote entities to stay within its max counts
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ForceUnits="s"))
+	float MaxDemotionDelaySeconds;
+
+	/** Real time (seconds) ahead to predict the camera location */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ForceUnits="s"))
+	float PredictionSeconds;
+
+	/** The camera must move at least this fast (cm/s) to predict anything */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ForceUnits="cm/s"))
+	float MinPredictionSpeed;
+
+	/** The prediction never reaches farther than this (cm), e.g. when the camera teleports */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ForceUnits="cm"))
+	float MaxPredictionDistance;
+
+	/** Real time (seconds) over which the camera velocity is smoothed */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0.001, ForceUnits="s"))
+	float CameraVelocitySmoothingSeconds;
+
+	/** Callback before any actor (or Mass phase) ticks; samples the camera */
+	void NativeOnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+private:
+	/** Real time (seconds) at the start of this frame */
+	double RealTimeSeconds = 0.;
+
+	/** Camera location at the start of this frame */
+	FVector CameraLocation = FVector::ZeroVector;
+
+	/** Smoothed camera velocity (cm per real second) */
+	FVector CameraVelocity = FVector::ZeroVector;
+
+	/** Has the camera been sampled before? */
+	bool bHasCamera = false;
+
+	/** Switches counted toward the next SwitchesPerSecond */
+	int32 WindowSwitches = 0;
+
+	/** Real time (seconds) when WindowSwitches started counting */
+	double WindowStartTime = 0.;
+
+	FMTGRepresentationLODStats Stats;
+
+	/** Handle of our FWorldDelegates::OnWorldPreActorTick subscription */
+	FDelegateHandle WorldPreActorTickHandle;
+};
+
+/** Only the LOD processors use it during Mass processing, so Mass may use it off the game thread */
+template<>
+struct TMassExternalSubsystemTraits<UMTGRepresentationLODSubsystem> final
+{
+	enum
+	{
+		GameThreadOnly = false,
+		ThreadSafeWrite = false,
+	};
+};
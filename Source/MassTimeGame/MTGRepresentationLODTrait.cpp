@@ -0,0 +1,15 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGRepresentationLODTrait.h"
+
+#include "MassEntityTemplateRegistry.h"
+#include "MassLODFragments.h"
+#include "MassRepresentationFragments.h"
+#include "MTGMassFragments.h"
+
+void UMTGRepresentationLODHysteresisTrait::BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const
+{
+	BuildContext.RequireFragment<FMassViewerInfoFragment>();
+	BuildContext.RequireFragment<FMassRepresentationLODFragment>();
+	BuildContext.AddFragment<FMTGRepresentationLODHoldFragment>();
+}
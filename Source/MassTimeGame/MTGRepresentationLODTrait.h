@@ -0,0 +1,24 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassEntityTraitBase.h"
+#include "MTGRepresentationLODTrait.generated.h"
+
+/**
+ * MTG Representation LOD Hysteresis Trait
+ *
+ * Add this to an entity config that also has a Mass visualization trait (e.g.
+ * MEC_Wanderer) so UMTGLODPredictionProcessor and UMTGLODHysteresisProcessor
+ * damp its representation switches near the LOD thresholds.
+ */
+UCLASS(meta=(DisplayName="MTG Representation LOD Hysteresis"))
+class MASSTIMEGAME_API UMTGRepresentationLODHysteresisTrait : public UMassEntityTraitBase
+{
+	GENERATED_BODY()
+
+protected:
+	//~Begin UMassEntityTraitBase interface
+	virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+	//~End UMassEntityTraitBase interface
+};
@@ -0,0 +1,786 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGShardSubsystem.h"
+
+#include "MassCommonFragments.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutionContext.h"
+#include "MassSpawner.h"
+#include "MassMovementFragments.h"
+#include "MassSimulationSubsystem.h"
+#include "MassTimeGame.h"
+#include "MTGSpawnerSubsystem.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "Common/TcpSocketBuilder.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Shard Gather"), STAT_MTGShardGather, STATGROUP_MassTimeGame);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("MTG Shard Barrier Wait (ms)"), STAT_MTGShardBarrierWait, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Shard Migrated Out"), STAT_MTGShardMigratedOut, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Shard Migrated In"), STAT_MTGShardMigratedIn, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::Shard
+{
+	static FAutoConsoleCommandWithWorld CmdShardStats(
+		TEXT("mtg.ShardStats"),
+		TEXT("Log the region shard migration, halo and barrier wait totals"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UMTGShardSubsystem* ShardSubsystem = World ? World->GetSubsystem<UMTGShardSubsystem>() : nullptr)
+			{
+				ShardSubsystem->LogStats();
+			}
+			else
+			{
+				UE_LOG(LogMassTimeGame, Log, TEXT("Not a sharded run; start with -MTGShardCount=N -MTGShardIndex=I"));
+			}
+		}));
+
+	/** Once a message header has arrived, the rest of it is never far behind */
+	static constexpr double MessageBodyTimeoutSeconds = 30.;
+
+	/** Send all of Data, however many Send calls it takes */
+	static bool SendAll(FSocket& Socket, const uint8* Data, int32 Size)
+	{
+		while (Size > 0)
+		{
+			int32 BytesSent = 0;
+			if (!Socket.Send(Data, Size, BytesSent))
+			{
+				return false;
+			}
+			Data += BytesSent;
+			Size -= BytesSent;
+		}
+		return true;
+	}
+
+	/** Receive exactly Size bytes, or fail at Deadline (FPlatformTime::Seconds) */
+	static bool ReceiveAll(FSocket& Socket, uint8* Data, int32 Size, const double Deadline)
+	{
+		while (Size > 0)
+		{
+			const double Remaining = Deadline - FPlatformTime::Seconds();
+			if (Remaining <= 0. || !Socket.Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromSeconds(Remaining)))
+			{
+				return false;
+			}
+
+			int32 BytesRead = 0;
+			if (!Socket.Recv(Data, Size, BytesRead) || BytesRead == 0)
+			{
+				// Readable with nothing to read means the other side closed the connection
+				return false;
+			}
+			Data += BytesRead;
+			Size -= BytesRead;
+		}
+		return true;
+	}
+
+	/** Send a length prefixed message */
+	static bool SendMessage(FSocket& Socket, FMTGShardMessage& Message)
+	{
+		TArray<uint8> Bytes;
+		Bytes.AddZeroed(sizeof(int32));
+
+		FMemoryWriter Writer(Bytes, false, true);
+		Writer << Message;
+
+		const int32 BodySize = Bytes.Num() - sizeof(int32);
+		FMemory::Memcpy(Bytes.GetData(), &BodySize, sizeof(int32));
+
+		return SendAll(Socket, Bytes.GetData(), Bytes.Num());
+	}
+
+	/**
+	 * Receive a length prefixed message
+	 * @param TimeoutSeconds Seconds to wait for it to start arriving; 0 returns immediately if none has
+	 * @return True if a whole message was received, else False
+	 */
+	static bool ReceiveMessage(FSocket& Socket, FMTGShardMessage& OutMessage, const double TimeoutSeconds)
+	{
+		uint32 PendingSize = 0;
+		if (TimeoutSeconds <= 0. && !Socket.HasPendingData(PendingSize))
+		{
+			return false;
+		}
+
+		// A poll only gets here when the message has started arriving
+		const double HeaderTimeoutSeconds = TimeoutSeconds > 0. ? TimeoutSeconds : MessageBodyTimeoutSeconds;
+
+		int32 BodySize = 0;
+		if (!ReceiveAll(Socket, reinterpret_cast<uint8*>(&BodySize), sizeof(int32), FPlatformTime::Seconds() + HeaderTimeoutSeconds)
+			|| BodySize < 0)
+		{
+			return false;
+		}
+
+		TArray<uint8> Body;
+		Body.SetNumUninitialized(BodySize);
+		if (!ReceiveAll(Socket, Body.GetData(), BodySize, FPlatformTime::Seconds() + MessageBodyTimeoutSeconds))
+		{
+			return false;
+		}
+
+		FMemoryReader Reader(Body, true);
+		Reader << OutMessage;
+		return !Reader.IsError();
+	}
+
+	/** Destroy a socket made by the platform socket subsystem */
+	static void DestroySocket(FSocket*& Socket)
+	{
+		if (Socket)
+		{
+			Socket->Close();
+			ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+			Socket = nullptr;
+		}
+	}
+}
+
+// Set Class Defaults
+UMTGShardSubsystem::UMTGShardSubsystem()
+{
+	RegionMinX = -50000.f;
+	RegionMaxX = 50000.f;
+	HaloWidth = 2000.f;
+	FixedDeltaSeconds = 1.f / 30.f;
+	BasePort = 7790;
+	ConnectTimeoutSeconds = 60.f;
+	BarrierTimeoutSeconds = 10.f;
+}
+
+int32 UMTGShardSubsystem::GetShardCount()
+{
+	int32 ShardCount = 1;
+	FParse::Value(FCommandLine::Get(), TEXT("MTGShardCount="), ShardCount);
+	return FMath::Max(1, ShardCount);
+}
+
+bool UMTGShardSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && GetShardCount() > 1;
+}
+
+void UMTGShardSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	ShardCount = GetShardCount();
+	FParse::Value(FCommandLine::Get(), TEXT("MTGShardIndex="), ShardIndex);
+	if (!ensureMsgf(ShardIndex >= 0 && ShardIndex < ShardCount, TEXT("-MTGShardIndex=%d is not in [0, %d)"), ShardIndex, ShardCount))
+	{
+		ShardIndex = 0;
+	}
+
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+	Collection.InitializeDependency<UMTGCrowdDensitySubsystem>();
+
+	// The spawner subscribes to OnSimTickCompleted first, so last tick's migrants are recycled before we gather
+	SpawnerSubsystem = Collection.InitializeDependency<UMTGSpawnerSubsystem>();
+	MassSimulationSubsystem = Collection.InitializeDependency<UMassSimulationSubsystem>();
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+		SimTimeSubsystem->GetOnSimulationPaused().AddUObject(this, &ThisClass::NativeOnSimulationPaused);
+	}
+
+	if (IsCoordinator())
+	{
+		// After MTGSimTimeSubsystem's own phase callback, so this tick's player input is already applied
+		if (MassSimulationSubsystem)
+		{
+			MassSimulationSubsystem->GetOnProcessingPhaseStarted(EMassProcessingPhase::PrePhysics).AddUObject(this, &ThisClass::NativeOnPrePhysicsStarted);
+		}
+	}
+	else
+	{
+		WorldPreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &ThisClass::NativeOnWorldPreActorTick);
+	}
+
+	// Every shard's sim ticks must be the same length
+	bPreviousUseFixedTimeStep = FApp::UseFixedTimeStep();
+	PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(FixedDeltaSeconds);
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Shard %d of %d, region X [%.0f, %.0f)"), ShardIndex, ShardCount,
+		ShardIndex == 0 ? -UE_BIG_NUMBER : RegionMinX + ShardIndex * (RegionMaxX - RegionMinX) / ShardCount,
+		ShardIndex == ShardCount - 1 ? UE_BIG_NUMBER : RegionMinX + (ShardIndex + 1) * (RegionMaxX - RegionMinX) / ShardCount);
+}
+
+void UMTGShardSubsystem::Deinitialize()
+{
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem->GetOnSimulationPaused().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	if (MassSimulationSubsystem)
+	{
+		MassSimulationSubsystem->GetOnProcessingPhaseStarted(EMassProcessingPhase::PrePhysics).RemoveAll(this);
+		MassSimulationSubsystem = nullptr;
+	}
+
+	FWorldDelegates::OnWorldPreActorTick.Remove(WorldPreActorTickHandle);
+
+	for (const TWeakObjectPtr<AMassSpawner>& Spawner : LevelSpawners)
+	{
+		if (Spawner.IsValid())
+		{
+			Spawner->OnSpawningFinishedEvent.RemoveAll(this);
+		}
+	}
+	LevelSpawners.Reset();
+
+	// FApp fixed time step is global; put back whatever it was before this world (e.g. another world's setting)
+	FApp::SetUseFixedTimeStep(bPreviousUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+
+	Disconnect();
+	SpawnerSubsystem = nullptr;
+
+	Super::Deinitialize();
+}
+
+bool UMTGShardSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game;
+}
+
+void UMTGShardSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// This runs before the actors' BeginPlay, so no spawner has spawned yet
+	for (TActorIterator<AMassSpawner> It(&InWorld); It; ++It)
+	{
+		It->OnSpawningFinishedEvent.AddDynamic(this, &ThisClass::NativeOnSpawnerFinished);
+		LevelSpawners.Add(*It);
+	}
+
+	const bool bConnected = IsCoordinator() ? AcceptShards() : ConnectToCoordinator();
+	if (!bConnected)
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Shard %d could not connect its peers; simulating its region alone"), ShardIndex);
+		Disconnect();
+	}
+}
+
+void UMTGShardSubsystem::NativeOnSpawnerFinished()
+{
+	++NumSpawnersFinished;
+}
+
+bool UMTGShardSubsystem::IsLevelPopulationSpawned() const
+{
+	// Only the spawners that still auto spawn are part of the level population; UMTGBakedSpawnSubsystem
+	// turns off the ones it replaces, and spawns their baked entities synchronously before any sim tick.
+	// bAutoSpawnOnBeginPlay isn't exposed to C++, so read it through reflection.
+	const FBoolProperty* AutoSpawnProperty = FindFProperty<FBoolProperty>(AMassSpawner::StaticClass(), TEXT("bAutoSpawnOnBeginPlay"));
+
+	int32 NumAutoSpawners = 0;
+	for (const TWeakObjectPtr<AMassSpawner>& Spawner : LevelSpawners)
+	{
+		if (Spawner.IsValid() && (!AutoSpawnProperty || AutoSpawnProperty->GetPropertyValue_InContainer(Spawner.Get())))
+		{
+			++NumAutoSpawners;
+		}
+	}
+
+	return NumSpawnersFinished >= NumAutoSpawners;
+}
+
+int32 UMTGShardSubsystem::GetShardForX(const double X) const
+{
+	const double RegionWidth = (RegionMaxX - RegionMinX) / ShardCount;
+	return FMath::Clamp(FMath::FloorToInt32((X - RegionMinX) / RegionWidth), 0, ShardCount - 1);
+}
+
+bool UMTGShardSubsystem::AcceptShards()
+{
+	using namespace UE::MTG::Shard;
+
+	int32 Port = BasePort;
+	FParse::Value(FCommandLine::Get(), TEXT("MTGShardPort="), Port);
+
+	FSocket* ListenSocket = FTcpSocketBuilder(TEXT("MTGShardListen"))
+		.AsReusable()
+		.BoundToEndpoint(FIPv4Endpoint(FIPv4Address::InternalLoopback, Port))
+		.Listening(ShardCount);
+
+	if (!ListenSocket)
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Shard coordinator cannot listen on 127.0.0.1:%d"), Port);
+		return false;
+	}
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Shard coordinator waiting for %d shards on 127.0.0.1:%d"), ShardCount - 1, Port);
+
+	ShardSockets.Init(nullptr, ShardCount);
+	int32 NumConnected = 0;
+	const double Deadline = FPlatformTime::Seconds() + ConnectTimeoutSeconds;
+
+	while (NumConnected < ShardCount - 1 && FPlatformTime::Seconds() < Deadline)
+	{
+		bool bHasPendingConnection = false;
+		if (!ListenSocket->WaitForPendingConnection(bHasPendingConnection, FTimespan::FromSeconds(0.5)) || !bHasPendingConnection)
+		{
+			continue;
+		}
+
+		FSocket* Socket = ListenSocket->Accept(TEXT("MTGShard"));
+		if (!Socket)
+		{
+			continue;
+		}
+
+		Socket->SetNonBlocking(false);
+		Socket->SetNoDelay(true);
+
+		FMTGShardMessage Hello;
+		if (ReceiveMessage(*Socket, Hello, BarrierTimeoutSeconds)
+			&& Hello.Type == EMTGShardMessage::Hello
+			&& Hello.ShardIndex > 0 && Hello.ShardIndex < ShardCount
+			&& !ShardSockets[Hello.ShardIndex])
+		{
+			ShardSockets[Hello.ShardIndex] = Socket;
+			++NumConnected;
+			UE_LOG(LogMassTimeGame, Log, TEXT("Shard %d connected"), Hello.ShardIndex);
+		}
+		else
+		{
+			DestroySocket(Socket);
+		}
+	}
+
+	DestroySocket(ListenSocket);
+	return NumConnected == ShardCount - 1;
+}
+
+bool UMTGShardSubsystem::ConnectToCoordinator()
+{
+	using namespace UE::MTG::Shard;
+
+	int32 Port = BasePort;
+	FParse::Value(FCommandLine::Get(), TEXT("MTGShardPort="), Port);
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	const TSharedRef<FInternetAddr> Address = FIPv4Endpoint(FIPv4Address::InternalLoopback, Port).ToInternetAddr();
+	const double Deadline = FPlatformTime::Seconds() + ConnectTimeoutSeconds;
+
+	// The coordinator may not be listening yet
+	while (!CoordinatorSocket && FPlatformTime::Seconds() < Deadline)
+	{
+		CoordinatorSocket = FTcpSocketBuilder(TEXT("MTGShard")).AsBlocking().Build();
+		if (CoordinatorSocket && !CoordinatorSocket->Connect(*Address))
+		{
+			DestroySocket(CoordinatorSocket);
+			FPlatformProcess::Sleep(0.5f);
+		}
+	}
+
+	if (!CoordinatorSocket)
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Shard %d cannot connect to the coordinator on %s"), ShardIndex, *Address->ToString(true));
+		return false;
+	}
+
+	CoordinatorSocket->SetNoDelay(true);
+
+	FMTGShardMessage Hello;
+	Hello.Type = EMTGShardMessage::Hello;
+	Hello.ShardIndex = ShardIndex;
+	return SendMessage(*CoordinatorSocket, Hello);
+}
+
+void UMTGShardSubsystem::Disconnect()
+{
+	for (FSocket*& Socket : ShardSockets)
+	{
+		UE::MTG::Shard::DestroySocket(Socket);
+	}
+	ShardSockets.Reset();
+
+	UE::MTG::Shard::DestroySocket(CoordinatorSocket);
+	bAwaitingReports = false;
+}
+
+void UMTGShardSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	if (IsCoordinator())
+	{
+		// Routed with the shards' reports at the start of the next tick
+		GatherReport(OwnReport);
+		return;
+	}
+
+	FMTGShardMessage Report;
+	GatherReport(Report);
+
+	if (CoordinatorSocket)
+	{
+		Report.Type = EMTGShardMessage::Report;
+		Report.ShardIndex = ShardIndex;
+		Report.Clock = SimTimeSubsystemIn->GetSimClockState();
+		UE::MTG::Shard::SendMessage(*CoordinatorSocket, Report);
+	}
+}
+
+void UMTGShardSubsystem::NativeOnSimulationPaused(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	if (!IsCoordinator())
+	{
+		return;
+	}
+
+	// The shards are waiting for the next tick's go ahead; tell them it isn't coming yet
+	FMTGShardMessage Pause;
+	Pause.Type = EMTGShardMessage::Pause;
+	Pause.Clock = SimTimeSubsystemIn->GetSimClockState();
+
+	for (FSocket* Socket : ShardSockets)
+	{
+		if (Socket)
+		{
+			UE::MTG::Shard::SendMessage(*Socket, Pause);
+		}
+	}
+}
+
+void UMTGShardSubsystem::NativeOnPrePhysicsStarted(const float DeltaSeconds)
+{
+	using namespace UE::MTG::Shard;
+
+	if (ShardSockets.Num() == 0 || !SimTimeSubsystem || SimTimeSubsystem->IsPaused())
+	{
+		return;
+	}
+
+	TArray<TArray<FMTGShardMigrant>> MigrantsTo;
+	TArray<TArray<FMTGCrowdDensityHaloCell>> HaloTo;
+	MigrantsTo.SetNum(ShardCount);
+	HaloTo.SetNum(ShardCount);
+
+	auto Route = [this, &MigrantsTo, &HaloTo](FMTGShardMessage& Report, const int32 FromShard)
+	{
+		for (FMTGShardMigrant& Migrant : Report.Migrants)
+		{
+			if (MigrantsTo.IsValidIndex(Migrant.ToShard))
+			{
+				MigrantsTo[Migrant.ToShard].Add(MoveTemp(Migrant));
+			}
+		}
+		if (FromShard > 0)
+		{
+			HaloTo[FromShard - 1].Append(MoveTemp(Report.HaloLower));
+		}
+		if (FromShard < ShardCount - 1)
+		{
+			HaloTo[FromShard + 1].Append(MoveTemp(Report.HaloUpper));
+		}
+	};
+
+	// Barrier: every shard must have finished the last tick before any starts the next
+	if (bAwaitingReports)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		Route(OwnReport, 0);
+		for (int32 FromShard = 1; FromShard < ShardCount; ++FromShard)
+		{
+			FMTGShardMessage Report;
+			if (ShardSockets[FromShard] && ReceiveMessage(*ShardSockets[FromShard], Report, BarrierTimeoutSeconds) && Report.Type == EMTGShardMessage::Report)
+			{
+				if (Report.Clock.SimTickNumber != SimTimeSubsystem->GetSimTickNumber())
+				{
+					UE_LOG(LogMassTimeGame, Warning, TEXT("Shard %d reported tick %llu at coordinator tick %llu"), FromShard, Report.Clock.SimTickNumber, SimTimeSubsystem->GetSimTickNumber());
+				}
+				Route(Report, FromShard);
+			}
+			else
+			{
+				UE_LOG(LogMassTimeGame, Warning, TEXT("No report from shard %d within %.1f s"), FromShard, BarrierTimeoutSeconds);
+			}
+		}
+
+		const double WaitSeconds = FPlatformTime::Seconds() - StartTime;
+		BarrierWaitSeconds += WaitSeconds;
+		SET_FLOAT_STAT(STAT_MTGShardBarrierWait, 1000. * WaitSeconds);
+	}
+	OwnReport = FMTGShardMessage();
+
+	const FMTGSimClockState Clock = SimTimeSubsystem->GetSimClockState();
+	for (int32 ToShard = 1; ToShard < ShardCount; ++ToShard)
+	{
+		if (ShardSockets[ToShard])
+		{
+			FMTGShardMessage Go;
+			Go.Type = EMTGShardMessage::Go;
+			Go.ShardIndex = ToShard;
+			Go.Clock = Clock;
+			Go.Migrants = MoveTemp(MigrantsTo[ToShard]);
+			Go.HaloLower = MoveTemp(HaloTo[ToShard]);
+			SendMessage(*ShardSockets[ToShard], Go);
+		}
+	}
+
+	ApplyIncoming(MigrantsTo[0], MoveTemp(HaloTo[0]));
+	bAwaitingReports = true;
+}
+
+void UMTGShardSubsystem::NativeOnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld() || !CoordinatorSocket || !SimTimeSubsystem)
+	{
+		return;
+	}
+
+	// A pipelined tick completes (and sends its report) here; the coordinator needs it before it will answer
+	SimTimeSubsystem->FlushSimPipeline();
+
+	// While paused, just check whether the coordinator has resumed
+	const bool bPaused = SimTimeSubsystem->IsPaused();
+	const double StartTime = FPlatformTime::Seconds();
+
+	FMTGShardMessage Message;
+	if (UE::MTG::Shard::ReceiveMessage(*CoordinatorSocket, Message, bPaused ? 0. : BarrierTimeoutSeconds))
+	{
+		if (!bPaused)
+		{
+			const double WaitSeconds = FPlatformTime::Seconds() - StartTime;
+			BarrierWaitSeconds += WaitSeconds;
+			SET_FLOAT_STAT(STAT_MTGShardBarrierWait, 1000. * WaitSeconds);
+		}
+
+		ApplyCoordinatorMessage(MoveTemp(Message));
+	}
+	else if (CoordinatorSocket->GetConnectionState() != SCS_Connected)
+	{
+		UE_LOG(LogMassTimeGame, Log, TEXT("Shard %d lost the coordinator; exiting"), ShardIndex);
+		Disconnect();
+		FPlatformMisc::RequestExit(false, TEXT("MTGShardSubsystem"));
+	}
+	else if (!bPaused)
+	{
+		UE_LOG(LogMassTimeGame, Warning, TEXT("Shard %d had no go ahead from the coordinator within %.1f s; ticking alone"), ShardIndex, BarrierTimeoutSeconds);
+	}
+}
+
+void UMTGShardSubsystem::ApplyCoordinatorMessage(FMTGShardMessage&& Message)
+{
+	switch (Message.Type)
+	{
+	case EMTGShardMessage::Pause:
+		if (!SimTimeSubsystem->IsPaused())
+		{
+			SimTimeSubsystem->PauseSimulation();
+		}
+		break;
+
+	case EMTGShardMessage::Go:
+		if (SimTimeSubsystem->IsPaused())
+		{
+			SimTimeSubsystem->ResumeSimulation();
+		}
+
+		// Same tick number and speed as the coordinator; a mismatch means a shard missed a barrier or the speed changed
+		if (Message.Clock.SimTickNumber != SimTimeSubsystem->GetSimTickNumber()
+			|| Message.Clock.SimSpeedIndex != SimTimeSubsystem->GetSimClockState().SimSpeedIndex)
+		{
+			++NumClockCorrections;
+			SimTimeSubsystem->RestoreSimClockState(Message.Clock);
+		}
+
+		ApplyIncoming(Message.Migrants, MoveTemp(Message.HaloLower));
+		break;
+
+	default:
+		UE_LOG(LogMassTimeGame, Warning, TEXT("Shard %d ignored unexpected message %d"), ShardIndex, static_cast<int32>(Message.Type));
+		break;
+	}
+}
+
+void UMTGShardSubsystem::GatherReport(FMTGShardMessage& OutReport)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MTGShardGather);
+
+	UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntitySubsystem) || !SpawnerSubsystem)
+	{
+		return;
+	}
+
+	FMassEntityManager& EntityManager = EntitySubsystem->GetMutableEntityManager();
+
+	// Forget the entities the spawner has recycled since (or reused for wanderers arriving here)
+	for (auto It = MigratedOut.CreateIterator(); It; ++It)
+	{
+		const FMassEntityHandle Entity = *It;
+		const FTransformFragment* Transform = EntityManager.IsEntityValid(Entity) ? EntityManager.GetFragmentDataPtr<FTransformFragment>(Entity) : nullptr;
+		if (!Transform
+			|| EntityManager.GetArchetypeComposition(EntityManager.GetArchetypeForEntity(Entity)).Tags.Contains<FMTGRecycledTag>()
+			|| GetShardForX(Transform->GetTransform().GetLocation().X) == ShardIndex)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	FMassEntityQuery Query(EntityManager.AsShared());
+	Query.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddRequirement<FMassVelocityFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddRequirement<FMTGWanderTargetFragment>(EMassFragmentAccess::ReadOnly);
+	Query.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+
+	TArray<FMassEntityHandle, FMTGFrameArenaAllocator> Departed;
+	const bool bSendDeparted = bCulledInitialPopulation;
+
+	FMassExecutionContext ExecutionContext(EntityManager);
+	Query.ForEachEntityChunk(ExecutionContext, [this, &OutReport, &Departed, bSendDeparted](FMassExecutionContext& Context)
+	{
+		const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+		const TConstArrayView<FMassVelocityFragment> Velocities = Context.GetFragmentView<FMassVelocityFragment>();
+		const TConstArrayView<FMTGWanderTargetFragment> WanderTargets = Context.GetFragmentView<FMTGWanderTargetFragment>();
+		const TConstArrayView<FMassEntityHandle> Entities = Context.GetEntities();
+
+		const int32 NumEntities = Context.GetNumEntities();
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; ++EntityIndex)
+		{
+			const int32 ToShard = GetShardForX(Transforms[EntityIndex].GetTransform().GetLocation().X);
+			if (LIKELY(ToShard == ShardIndex) || MigratedOut.Contains(Entities[EntityIndex]))
+			{
+				continue;
+			}
+
+			// Until the initial cull, the other shards already have their own copy of the level's wanderers
+			if (bSendDeparted)
+			{
+				FMTGShardMigrant& Migrant = OutReport.Migrants.AddDefaulted_GetRef();
+				Migrant.ToShard = ToShard;
+				Migrant.Transform = Transforms[EntityIndex].GetTransform();
+				Migrant.Velocity = Velocities[EntityIndex].Value;
+				Migrant.WanderTarget = WanderTargets[EntityIndex];
+			}
+
+			Departed.Add(Entities[EntityIndex]);
+		}
+	});
+
+	const UMassEntityConfigAsset* EntityConfig = SpawnerSubsystem->GetWandererEntityConfig();
+	if (Departed.Num() > 0 && ensure(EntityConfig))
+	{
+		SpawnerSubsystem->RequestDespawn(*EntityConfig, Departed);
+		MigratedOut.Append(Departed);
+	}
+
+	if (bSendDeparted)
+	{
+		NumMigratedOut += Departed.Num();
+		SET_DWORD_STAT(STAT_MTGShardMigratedOut, Departed.Num());
+	}
+	else
+	{
+		NumInitiallyCulled += Departed.Num();
+
+		// The first gather after the whole level population exists is the last cull; from then on
+		// every wanderer leaving our region is a migrant, even if no wanderer was ever culled
+		if (IsLevelPopulationSpawned())
+		{
+			bCulledInitialPopulation = true;
+			UE_LOG(LogMassTimeGame, Log, TEXT("Shard %d despawned %d level wanderers outside its region"), ShardIndex, NumInitiallyCulled);
+		}
+	}
+
+	// Halo: our density cells next to each boundary, for the neighbor across it
+	const UMTGCrowdDensitySubsystem* DensitySubsystem = GetWorld()->GetSubsystem<UMTGCrowdDensitySubsystem>();
+	if (!DensitySubsystem || HaloWidth <= 0.f)
+	{
+		return;
+	}
+
+	const FMTGCrowdDensityGrid& Grid = DensitySubsystem->GetGrid();
+	const double RegionWidth = (RegionMaxX - RegionMinX) / ShardCount;
+	const double LowerBoundary = RegionMinX + ShardIndex * RegionWidth;
+	const double UpperBoundary = LowerBoundary + RegionWidth;
+
+	for (int32 X = 0; X < Grid.NumX; ++X)
+	{
+		const double CenterX = Grid.Origin.X + (X + 0.5) * Grid.CellSize;
+		TArray<FMTGCrowdDensityHaloCell>* Halo =
+			ShardIndex > 0 && CenterX >= LowerBoundary && CenterX < LowerBoundary + HaloWidth ? &OutReport.HaloLower
+			: ShardIndex < ShardCount - 1 && CenterX < UpperBoundary && CenterX >= UpperBoundary - HaloWidth ? &OutReport.HaloUpper
+			: nullptr;
+
+		if (!Halo)
+		{
+			continue;
+		}
+
+		for (int32 Y = 0; Y < Grid.NumY; ++Y)
+		{
+			const int32 CellIndex = Y * Grid.NumX + X;
+			if (Grid.Density[CellIndex] > 0.f)
+			{
+				Halo->Add({CellIndex, Grid.Density[CellIndex], Grid.AverageVelocity[CellIndex]});
+			}
+		}
+	}
+
+	NumHaloCellsSent += OutReport.HaloLower.Num() + OutReport.HaloUpper.Num();
+}
+
+void UMTGShardSubsystem::ApplyIncoming(TConstArrayView<FMTGShardMigrant> Migrants, TArray<FMTGCrowdDensityHaloCell>&& HaloCells)
+{
+	if (UMTGCrowdDensitySubsystem* DensitySubsystem = GetWorld()->GetSubsystem<UMTGCrowdDensitySubsystem>())
+	{
+		DensitySubsystem->SetHaloCells(MoveTemp(HaloCells));
+	}
+
+	SET_DWORD_STAT(STAT_MTGShardMigratedIn, Migrants.Num());
+
+	const UMassEntityConfigAsset* EntityConfig = SpawnerSubsystem ? SpawnerSubsystem->GetWandererEntityConfig() : nullptr;
+	if (Migrants.Num() == 0 || !EntityConfig)
+	{
+		return;
+	}
+
+	TArray<FTransform> Transforms;
+	TArray<FVector> Velocities;
+	TArray<FMTGWanderTargetFragment> WanderTargets;
+	Transforms.Reserve(Migrants.Num());
+	Velocities.Reserve(Migrants.Num());
+	WanderTargets.Reserve(Migrants.Num());
+
+	for (const FMTGShardMigrant& Migrant : Migrants)
+	{
+		Transforms.Add(Migrant.Transform);
+		Velocities.Add(Migrant.Velocity);
+		WanderTargets.Add(Migrant.WanderTarget);
+	}
+
+	SpawnerSubsystem->RequestSpawn(*EntityConfig, Transforms, Velocities, WanderTargets);
+	NumMigratedIn += Migrants.Num();
+}
+
+void UMTGShardSubsystem::LogStats() const
+{
+	UE_LOG(LogMassTimeGame, Log, TEXT("Shard %d of %d%s: tick %llu, migrated out %lld, in %lld, halo cells sent %lld, clock corrections %lld, barrier wait %.3f s"),
+		ShardIndex, ShardCount, IsCoordinator() ? TEXT(" (coordinator)") : TEXT(""),
+		SimTimeSubsystem ? SimTimeSubsystem->GetSimTickNumber() : 0,
+		NumMigratedOut, NumMigratedIn, NumHaloCellsSent, NumClockCorrections, BarrierWaitSeconds);
+}
@@ -0,0 +1,296 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassEntityHandle.h"
+#include "MTGCrowdDensitySubsystem.h"
+#include "MTGMassFragments.h"
+#include "MTGSimTimeSubsystem.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGShardSubsystem.generated.h"
+
+class AMassSpawner;
+class FSocket;
+class UMassSimulationSubsystem;
+class UMTGSpawnerSubsystem;
+
+/**
+ * A wanderer leaving one shard's region for another's
+ */
+struct FMTGShardMigrant
+{
+	/** Shard whose region the wanderer entered */
+	int32 ToShard = INDEX_NONE;
+
+	FTransform Transform;
+	FVector Velocity = FVector::ZeroVector;
+	FMTGWanderTargetFragment WanderTarget;
+
+	friend FArchive& operator<<(FArchive& Ar, FMTGShardMigrant& Migrant)
+	{
+		return Ar << Migrant.ToShard << Migrant.Transform << Migrant.Velocity << Migrant.WanderTarget.Destination << Migrant.WanderTarget.bHasDestination;
+	}
+};
+
+/**
+ * Kinds of message sent between shards
+ */
+enum class EMTGShardMessage : uint8
+{
+	/** Shard -> coordinator, once after connecting */
+	Hello,
+
+	/** Shard -> coordinator after each sim tick: its migrants and halo */
+	Report,
+
+	/** Coordinator -> shard before each sim tick: the clock to run it with, and the shard's incoming migrants and halo */
+	Go,
+
+	/** Coordinator -> shard: the coordinator paused after the last tick */
+	Pause,
+};
+
+/**
+ * A message sent between shards over their local socket
+ */
+struct FMTGShardMessage
+{
+	EMTGShardMessage Type = EMTGShardMessage::Hello;
+	int32 ShardIndex = INDEX_NONE;
+
+	/** Sender's sim clock */
+	FMTGSimClockState Clock;
+
+	/** Report: outgoing migrants.  Go: incoming migrants. */
+	TArray<FMTGShardMigrant> Migrants;
+
+	/** Report: density cells next to the lower/upper boundary.  Go: halo cells from both neighbors in HaloLower. */
+	TArray<FMTGCrowdDensityHaloCell> HaloLower;
+	TArray<FMTGCrowdDensityHaloCell> HaloUpper;
+
+	friend FArchive& operator<<(FArchive& Ar, FMTGShardMessage& Message)
+	{
+		Ar << Message.Type << Message.ShardIndex;
+		Ar << Message.Clock.SimTickNumber << Message.Clock.SimTimeElapsed << Message.Clock.SimTimeDilation << Message.Clock.SimSpeedIndex;
+		Ar << Message.Clock.ExactSimTime.Microseconds << Message.Clock.ExactSimTime.Fraction;
+		return Ar << Message.Migrants << Message.HaloLower << Message.HaloUpper;
+	}
+};
+
+/**
+ * MTG Shard Subsystem
+ *
+ * Splits the sim over several processes on the same machine, each simulating
+ * the wanderers in its own strip of the world along X.  Start one process per
+ * shard, e.g. for 4 shards:
+ *
+ *   MassTimeGame -MTGShardCount=4 -MTGShardIndex=0
+ *   MassTimeGame -MTGShardCount=4 -MTGShardIndex=1 -nullrhi
+ *   MassTimeGame -MTGShardCount=4 -MTGShardIndex=2 -nullrhi
+ *   MassTimeGame -MTGShardCount=4 -MTGShardIndex=3 -nullrhi
+ *
+ * Shard 0 is the coordinator: the player's process, which the others connect
+ * to over loopback TCP (-MTGShardPort, default BasePort).  It runs its own
+ * region and drives the others in lock step:
+ *
+ * 1) After each sim tick, every shard sends the coordinator a report of the
+ *    wanderers that left its region (and despawns them), and of its density
+ *    cells within HaloWidth of each boundary.
+ * 2) Before the next sim tick, the coordinator collects every report, then
+ *    sends each shard its incoming wanderers, its neighbors' halo cells and
+ *    the coordinator's clock.  Shards wait for this before they tick, and
+ *    adopt the clock's tick number and speed if theirs differ.
+ * 3) When the coordinator pauses, it tells the shards to pause; they resume
+ *    when the next tick's message arrives.
+ *
+ * Every process uses a fixed time step of FixedDeltaSeconds so the shards'
+ * sim ticks are the same length (the previous FApp setting is restored when
+ * the world goes away).  Every process spawns the whole level, so until the
+ * level's Mass spawners have all finished, each shard despawns the wanderers
+ * outside its region instead of sending them; after the first sim tick
+ * following that, every wanderer leaving the region is sent to its new
+ * shard.  The coordinator only renders its own region.
+ *
+ * mtg.ShardStats logs the migration, halo and wait time totals.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Shard Subsystem"))
+class MASSTIMEGAME_API UMTGShardSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGShardSubsystem();
+
+	//~Begin USubsystem interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 * Get the number of shards requested on the command line
+	 * @return Number of shards, or 1 if this is not a sharded run
+	 */
+	static int32 GetShardCount();
+
+	/**
+	 * Is this process the coordinator (shard 0)?
+	 * @return True if coordinator, else False
+	 */
+	bool IsCoordinator() const { return ShardIndex == 0; }
+
+	/**
+	 * Get the shard whose region contains a world X
+	 * @param X World X coordinate
+	 * @return Shard index
+	 */
+	int32 GetShardForX(double X) const;
+
+	/** Log the totals since the world began play */
+	void LogStats() const;
+
+protected:
+	/** Regions split [RegionMinX, RegionMaxX) into equal strips; the outer shards extend to infinity */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ForceUnits="cm"))
+	float RegionMinX;
+
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ForceUnits="cm"))
+	float RegionMaxX;
+
+	/** Density cells within this distance (cm) of a boundary are sent to the neighbor across it */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0, ForceUnits="cm"))
+	float HaloWidth;
+
+	/** Fixed world DeltaTime (before dilation) of every shard process */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0.001, ForceUnits="s"))
+	float FixedDeltaSeconds;
+
+	/** Coordinator TCP port on 127.0.0.1, unless -MTGShardPort is given */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	int32 BasePort;
+
+	/** Real seconds to wait for every shard to connect */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1, ForceUnits="s"))
+	float ConnectTimeoutSeconds;
+
+	/** Real seconds to wait at the lock step barrier before giving up on a shard */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0.1, ForceUnits="s"))
+	float BarrierTimeoutSeconds;
+
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/**
+	 * Callback from MTGSimTimeSubsystem when the sim pauses
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimulationPaused(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/** Callback from each level AMassSpawner when it has spawned its entities */
+	UFUNCTION()
+	void NativeOnSpawnerFinished();
+
+	/**
+	 * Have all the level's auto spawning Mass spawners finished spawning?
+	 * @return True once the whole level population exists
+	 */
+	bool IsLevelPopulationSpawned() const;
+
+	/** Coordinator: start of a sim tick's Mass processing; routes the reports and releases the shards */
+	void NativeOnPrePhysicsStarted(float DeltaSeconds);
+
+	/** Shard: start of each frame; waits for the coordinator's go ahead */
+	void NativeOnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** Coordinator: accept a connection from every other shard */
+	bool AcceptShards();
+
+	/** Shard: connect to the coordinator and say hello */
+	bool ConnectToCoordinator();
+
+	/**
+	 * Collect the wanderers that left our region (queuing their despawn) and our halo cells
+	 * @param OutReport Report to fill
+	 */
+	void GatherReport(FMTGShardMessage& OutReport);
+
+	/**
+	 * Spawn incoming wanderers and set the halo
+	 * @param Migrants Wanderers entering our region
+	 * @param HaloCells Neighbor density cells
+	 */
+	void ApplyIncoming(TConstArrayView<FMTGShardMigrant> Migrants, TArray<FMTGCrowdDensityHaloCell>&& HaloCells);
+
+	/**
+	 * Shard: apply a message from the coordinator
+	 * @param Message Go or Pause
+	 */
+	void ApplyCoordinatorMessage(FMTGShardMessage&& Message);
+
+	/** Close every socket */
+	void Disconnect();
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** Saved reference to the MTGSpawnerSubsystem, which despawns/spawns migrants */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSpawnerSubsystem> SpawnerSubsystem;
+
+	/** Saved reference to the MassSimulationSubsystem, for the coordinator's phase callback */
+	UPROPERTY(Transient)
+	TObjectPtr<UMassSimulationSubsystem> MassSimulationSubsystem;
+
+	int32 ShardIndex = 0;
+	int32 ShardCount = 1;
+
+	/** Coordinator: socket of each shard, indexed by shard (0 is unused) */
+	TArray<FSocket*> ShardSockets;
+
+	/** Shard: socket to the coordinator */
+	FSocket* CoordinatorSocket = nullptr;
+
+	/** Coordinator: its own report from the last sim tick */
+	FMTGShardMessage OwnReport;
+
+	/** Coordinator: have the shards been sent a Go that they'll answer with a Report? */
+	bool bAwaitingReports = false;
+
+	/** Has the despawn of the level's wanderers outside our region been done? Until then, departed wanderers aren't sent */
+	bool bCulledInitialPopulation = false;
+
+	/** Level wanderers despawned by the initial cull */
+	int32 NumInitiallyCulled = 0;
+
+	/** The level's Mass spawners, and how many spawn finished events they've sent */
+	TArray<TWeakObjectPtr<AMassSpawner>> LevelSpawners;
+	int32 NumSpawnersFinished = 0;
+
+	/** FApp fixed time step settings before Initialize, restored by Deinitialize */
+	bool bPreviousUseFixedTimeStep = false;
+	double PreviousFixedDeltaTime = 0.;
+
+	/** Entities we sent away that the spawner hasn't recycled yet; DO NOT send them twice */
+	TSet<FMassEntityHandle> MigratedOut;
+
+	/** Handle of our FWorldDelegates::OnWorldPreActorTick subscription */
+	FDelegateHandle WorldPreActorTickHandle;
+
+	/** Totals for mtg.ShardStats */
+	int64 NumMigratedOut = 0;
+	int64 NumMigratedIn = 0;
+	int64 NumHaloCellsSent = 0;
+	int64 NumClockCorrections = 0;
+	double BarrierWaitSeconds = 0.;
+};
@@ -3,9 +3,12 @@
 #include "MTGSimControlWidget.h"
 
 #include "MassTimeGame.h"
+#include "MTGCostHeatmapSubsystem.h"
 #include "MTGSimTimeSubsystem.h"
 #include "TimerManager.h"
 #include "Components/Button.h"
+#include "Components/CheckBox.h"
+#include "Components/ProgressBar.h"
 #include "Components/TextBlock.h"
 
 #define LOCTEXT_NAMESPACE "MassTimeGame"
@@ -24,6 +27,7 @@ void UMTGSimControlWidget::NativeConstruct()
 	// by default assume the simulation isn't paused or time dilated (e.g. in design time)
 	bool bIsPaused = false;
 	float TimeDilation = 1.f;
+	bool bIsFastForwarding = false;
 
 	if (!IsDesignTime())
 	{
@@ -48,21 +52,32 @@ void UMTGSimControlWidget::NativeConstruct()
 		UWorld* World = GetWorld();
 		check(World);
 
+		if (HeatmapCheckBox)
+		{
+			const UMTGCostHeatmapSubsystem* HeatmapSubsystem = World->GetSubsystem<UMTGCostHeatmapSubsystem>();
+			HeatmapCheckBox->SetIsChecked(HeatmapSubsystem && HeatmapSubsystem->IsOverlayVisible());
+			HeatmapCheckBox->OnCheckStateChanged.AddDynamic(this, &ThisClass::NativeOnHeatmapCheckStateChanged);
+		}
+
 		SimTimeSubsystem = World->GetSubsystem<UMTGSimTimeSubsystem>();
 		if (ensureAlwaysMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
 		{
 			bIsPaused = SimTimeSubsystem->IsPaused();
 			TimeDilation = SimTimeSubsystem->GetSimTimeDilation();
+			bIsFastForwarding = SimTimeSubsystem->IsFastForwarding();
 
 			SimTimeSubsystem->GetOnSimulationPaused().AddUObject(this, &ThisClass::NativeOnSimulationPauseStateChanged);
 			SimTimeSubsystem->GetOnSimulationResumed().AddUObject(this, &ThisClass::NativeOnSimulationPauseStateChanged);
 			SimTimeSubsystem->GetOnTimeDilationChanged().AddUObject(this, &ThisClass::NativeOnSimulationTimeDilationChanged);
+			SimTimeSubsystem->GetOnFastForwardStarted().AddUObject(this, &ThisClass::NativeOnSimulationFastForwardStateChanged);
+			SimTimeSubsystem->GetOnFastForwardFinished().AddUObject(this, &ThisClass::NativeOnSimulationFastForwardStateChanged);
 		}
 	}
 
 	UpdateWidgetPauseState(bIsPaused);
 	UpdateWidgetTimeDilationState(TimeDilation);
 	UpdateWidgetTimeState();
+	UpdateWidgetFastForwardState(bIsFastForwarding);
 }
 
 void UMTGSimControlWidget::NativeDestruct()
@@ -84,11 +99,18 @@ void UMTGSimControlWidget::NativeDestruct()
 			SpeedUpButton->OnClicked.RemoveAll(this);
 		}
 
+		if (HeatmapCheckBox)
+		{
+			HeatmapCheckBox->OnCheckStateChanged.RemoveAll(this);
+		}
+
 		if (SimTimeSubsystem)
 		{
 			SimTimeSubsystem->GetOnSimulationPaused().RemoveAll(this);
 			SimTimeSubsystem->GetOnSimulationResumed().RemoveAll(this);
 			SimTimeSubsystem->GetOnTimeDilationChanged().RemoveAll(this);
+			SimTimeSubsystem->GetOnFastForwardStarted().RemoveAll(this);
+			SimTimeSubsystem->GetOnFastForwardFinished().RemoveAll(this);
 			SimTimeSubsystem = nullptr;
 		}
 	}
@@ -146,7 +168,7 @@ void UMTGSimControlWidget::UpdateWidgetTimeState()
 	if (LIKELY(SimTimeSubsystem))
 	{
 		SimTickNumber = SimTimeSubsystem->GetSimTickNumber();
-		SimTime = SimTimeSubsystem->GetSimTimeElapsed();
+		SimTime = SimTimeSubsystem->GetExactSimTimeSeconds();
 		SimDeltaTime = SimTimeSubsystem->GetSimDeltaTime();
 	}
 
@@ -177,6 +199,15 @@ void UMTGSimControlWidget::UpdateWidgetTimeState()
 	}
 }
 
+void UMTGSimControlWidget::UpdateWidgetFastForwardState(bool bIsFastForwarding)
+{
+	if (FastForwardProgressBar)
+	{
+		FastForwardProgressBar->SetVisibility(bIsFastForwarding ? ESlateVisibility::HitTestInvisible : ESlateVisibility::Collapsed);
+		FastForwardProgressBar->SetPercent(SimTimeSubsystem ? SimTimeSubsystem->GetFastForwardProgress() : 0.f);
+	}
+}
+
 void UMTGSimControlWidget::NativeOnSimulationPauseStateChanged(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
 {
 	checkf(SimTimeSubsystem == SimTimeSubsystemIn, TEXT("We should never receive this event except from our expected SimTimeSubsystem"));
@@ -192,11 +223,20 @@ void UMTGSimControlWidget::NativeOnSimulationTimeDilationChanged(TNotNull<UMTGSi
 	UpdateWidgetTimeDilationState(TimeDilation);
 }
 
+void UMTGSimControlWidget::NativeOnSimulationFastForwardStateChanged(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	checkf(SimTimeSubsystem == SimTimeSubsystemIn, TEXT("We should never receive this event except from our expected SimTimeSubsystem"));
+	const bool bIsFastForwarding = SimTimeSubsystem->IsFastForwarding();
+	UpdateWidgetFastForwardState(bIsFastForwarding);
+	UpdateWidgetTimeState();
+}
+
 void UMTGSimControlWidget::NativeOnPauseButtonClicked()
 {
+	// Like the key bindings, applied at the next tick boundary and counted in the input latency stats
 	if (SimTimeSubsystem)
 	{
-		SimTimeSubsystem->TogglePlayPause();
+		SimTimeSubsystem->RequestSimInput(EMTGSimInput::TogglePlayPause);
 	}
 }
 
@@ -204,7 +244,7 @@ void UMTGSimControlWidget::NativeOnSpeedDownButtonClicked()
 {
 	if (SimTimeSubsystem)
 	{
-		SimTimeSubsystem->DecreaseSimSpeed();
+		SimTimeSubsystem->RequestSimInput(EMTGSimInput::DecreaseSimSpeed);
 	}
 }
 
@@ -212,7 +252,15 @@ void UMTGSimControlWidget::NativeOnSpeedUpButtonClicked()
 {
 	if (SimTimeSubsystem)
 	{
-		SimTimeSubsystem->IncreaseSimSpeed();
+		SimTimeSubsystem->RequestSimInput(EMTGSimInput::IncreaseSimSpeed);
+	}
+}
+
+void UMTGSimControlWidget::NativeOnHeatmapCheckStateChanged(const bool bIsChecked)
+{
+	if (UMTGCostHeatmapSubsystem* HeatmapSubsystem = GetWorld()->GetSubsystem<UMTGCostHeatmapSubsystem>())
+	{
+		HeatmapSubsystem->SetOverlayVisible(bIsChecked);
 	}
 }
 
@@ -228,12 +276,34 @@ ETickableTickType UMTGSimControlWidget::GetTickableTickType() const
 
 void UMTGSimControlWidget::Tick(float DeltaTime)
 {
+	const double PlatformTime = FPlatformTime::Seconds();
+	const double PlatformDeltaTime = PlatformTime - LastTickPlatformTime;
+	LastTickPlatformTime = PlatformTime;
+
 	if (LIKELY(SimTimeSubsystem))
 	{
 		// When we're dilating the global time, that means World Timers are also dilated,
 		// which means at really slow time dilation this widget will almost never update!
 		// This means we need to tick every frame, and keep track of the ACTUAL REAL TIME
 		// that has elapsed since our last update, and update when needed.
+		//
+		// While fast forwarding, DeltaTime is a fixed step unrelated to real time,
+		// so use the platform clock instead.
+
+		if (UNLIKELY(SimTimeSubsystem->IsFastForwarding()))
+		{
+			TimeSinceLastUpdate += PlatformDeltaTime;
+
+			if (TimeSinceLastUpdate >= WidgetUpdateInterval)
+			{
+				TimeSinceLastUpdate = 0.;
+				if (FastForwardProgressBar)
+				{
+					FastForwardProgressBar->SetPercent(SimTimeSubsystem->GetFastForwardProgress());
+				}
+			}
+			return;
+		}
 
 		const float RealDeltaTime = SimTimeSubsystem->GetRealTimeSeconds(DeltaTime);
 		TimeSinceLastUpdate += RealDeltaTime;
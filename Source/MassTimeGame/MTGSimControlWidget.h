@@ -6,7 +6,9 @@
 #include "MTGSimControlWidget.generated.h"
 
 class UButton;
+class UCheckBox;
 class UMTGSimTimeSubsystem;
+class UProgressBar;
 class UTextBlock;
 
 /**
@@ -24,6 +26,11 @@ class UTextBlock;
  * In order to not be affected by the global time dilation, this widget
  * ticks.  It only updates itself once every WidgetUpdateInterval seconds,
  * which you can configure to your liking.
+ *
+ * While the sim is fast forwarding, world rendering is suspended and the only
+ * thing this widget updates is the FastForwardProgressBar.
+ *
+ * The optional HeatmapCheckBox shows/hides the MTGCostHeatmapSubsystem overlay.
  */
 UCLASS()
 class MASSTIMEGAME_API UMTGSimControlWidget
@@ -61,6 +68,12 @@ protected:
 	 */
 	void UpdateWidgetTimeState();
 
+	/**
+	 * Update the fast forward state of the widget
+	 * @param bIsFastForwarding True if the simulation is currently fast forwarding, else False
+	 */
+	void UpdateWidgetFastForwardState(bool bIsFastForwarding);
+
 	/**
 	 * Callback from the MTGSimTimeSubsystem when the simulation Pause state changes
 	 * @param SimTimeSubsystem Expected to be the same as our cached SimTimeSubsystem
@@ -73,6 +86,12 @@ protected:
 	 */
 	void NativeOnSimulationTimeDilationChanged(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
 
+	/**
+	 * Callback from the MTGSimTimeSubsystem when a fast forward starts or finishes
+	 * @param SimTimeSubsystem Expected to be the same as our cached SimTimeSubsystem
+	 */
+	void NativeOnSimulationFastForwardStateChanged(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
 	/** Callback when the "Pause/Resume" button is clicked */
 	UFUNCTION()
 	void NativeOnPauseButtonClicked();
@@ -85,6 +104,10 @@ protected:
 	UFUNCTION()
 	void NativeOnSpeedUpButtonClicked();
 
+	/** Callback when the "Cost Heatmap" check box is toggled */
+	UFUNCTION()
+	void NativeOnHeatmapCheckStateChanged(bool bIsChecked);
+
 	/** Persistent reference to the MTGSimTimeSubsystem since we use it 1+ times per tick */
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category=MassTimeGame)
 	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
@@ -121,10 +144,25 @@ protected:
 	UPROPERTY(meta=(BindWidgetOptional))
 	TObjectPtr<UTextBlock> DeltaTimeText;
 
+	/** A progress bar that is only visible while the simulation is fast forwarding */
+	UPROPERTY(meta=(BindWidgetOptional))
+	TObjectPtr<UProgressBar> FastForwardProgressBar;
+
+	/** Shows/hides the processing cost heatmap overlay */
+	UPROPERTY(meta=(BindWidgetOptional))
+	TObjectPtr<UCheckBox> HeatmapCheckBox;
+
 private:
 	/** How long it has been (real time seconds) since we last updated the widget */
 	float TimeSinceLastUpdate = MAX_flt / 2.;  // A huge number
 
+	/**
+	 * Platform time of the previous Tick.
+	 * During fast forward, the engine DeltaTime is fixed and has nothing to do with real time,
+	 * so we measure real time ourselves.
+	 */
+	double LastTickPlatformTime = 0.;
+
 public:
 	//~Begin FTickableGameObject interface
 	virtual UWorld* GetTickableGameObjectWorld() const override;
@@ -0,0 +1,708 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGSimSaveSubsystem.h"
+
+#include "MassCommonFragments.h"
+#include "MassEntityConfigAsset.h"
+#include "MassEntityManager.h"
+#include "MassEntitySubsystem.h"
+#include "MassEntityTemplate.h"
+#include "MassExecutionContext.h"
+#include "MassMovementFragments.h"
+#include "MassSpawnerSubsystem.h"
+#include "MassSpawnerTypes.h"
+#include "MassSpawnLocationProcessor.h"
+#include "MassTimeGame.h"
+#include "MTGMassFragments.h"
+#include "MTGSimTimeSubsystem.h"
+#include "MTGSpawnerSubsystem.h"
+#include "Async/MappedFileHandle.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Tasks/Task.h"
+
+namespace UE::MTG::SimSave
+{
+	static constexpr uint32 FileMagic = 0x5347544D;  // "MTGS"
+	static constexpr uint32 FileVersion = 3;
+
+	/** Oldest version we can still load; version 1 files have no exact sim time, version 2 files no entity config */
+	static constexpr uint32 MinFileVersion = 1;
+
+	/** Every block starts on this alignment in the file, so mapped blocks are cache line aligned */
+	static constexpr int64 BlockAlignment = 64;
+
+	/** Bytes per entity in a block: one FTransformFragment followed (in a separate array) by one FMassVelocityFragment */
+	static constexpr int64 BytesPerEntity = sizeof(FTransformFragment) + sizeof(FMassVelocityFragment);
+
+	/** Serialized size of a FBlockEntry */
+	static constexpr int64 BlockEntrySize = sizeof(int64) + 3 * sizeof(int32);
+
+	/**
+	 * One chunk worth of fragment data.
+	 * Layout: [NumEntities x FTransformFragment][NumEntities x FMassVelocityFragment]
+	 */
+	struct FSnapshotBlock
+	{
+		int32 NumEntities = 0;
+		TArray<uint8> Data;
+	};
+
+	/** Everything the game thread copies at the tick boundary; the rest happens in the background */
+	struct FSnapshot
+	{
+		FMTGSimClockState Clock;
+		FSoftObjectPath EntityConfigPath;
+		TArray<FSnapshotBlock> Blocks;
+		int64 NumEntities = 0;
+	};
+
+	/**
+	 * Per-block table entry in the file header.
+	 * A block is LZ4 compressed if and only if StoredSize < UncompressedSize.
+	 */
+	struct FBlockEntry
+	{
+		int64 Offset = 0;
+		int32 NumEntities = 0;
+		int32 StoredSize = 0;
+		int32 UncompressedSize = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FBlockEntry& Entry)
+		{
+			return Ar << Entry.Offset << Entry.NumEntities << Entry.StoredSize << Entry.UncompressedSize;
+		}
+	};
+
+	/** File header, followed immediately by NumBlocks FBlockEntry */
+	struct FFileHeader
+	{
+		uint32 Magic = FileMagic;
+		uint32 Version = FileVersion;
+		uint32 TransformFragmentSize = sizeof(FTransformFragment);
+		uint32 VelocityFragmentSize = sizeof(FMassVelocityFragment);
+		uint64 SimTickNumber = 0;
+		double SimTimeElapsed = 0.;
+		float SimTimeDilation = 1.f;
+		int32 SimSpeedIndex = INDEX_NONE;
+		uint64 ExactSimTimeMicroseconds = 0;
+		uint32 ExactSimTimeFraction = 0;
+		FString EntityConfigPath;  // What wanderers missing at load time are spawned from
+		int64 NumEntities = 0;
+		int32 NumBlocks = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FFileHeader& Header)
+		{
+			Ar << Header.Magic << Header.Version
+				<< Header.TransformFragmentSize << Header.VelocityFragmentSize
+				<< Header.SimTickNumber << Header.SimTimeElapsed << Header.SimTimeDilation << Header.SimSpeedIndex;
+			if (Header.Version >= 2)
+			{
+				Ar << Header.ExactSimTimeMicroseconds << Header.ExactSimTimeFraction;
+			}
+			if (Header.Version >= 3)
+			{
+				Ar << Header.EntityConfigPath;
+			}
+			return Ar << Header.NumEntities << Header.NumBlocks;
+		}
+	};
+
+	/** Create the query that matches all wanderer entities */
+	static FMassEntityQuery MakeWandererQuery(FMassEntityManager& EntityManager, EMassFragmentAccess Access)
+	{
+		FMassEntityQuery Query(EntityManager.AsShared());
+		Query.AddRequirement<FTransformFragment>(Access);
+		Query.AddRequirement<FMassVelocityFragment>(Access);
+		Query.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+		return Query;
+	}
+
+	/** Copy the fragment arrays of every wanderer chunk. Game thread, tick boundary. */
+	static FSnapshot TakeSnapshot(FMassEntityManager& EntityManager, const FMTGSimClockState& Clock, const FSoftObjectPath& EntityConfigPath)
+	{
+		FSnapshot Snapshot;
+		Snapshot.Clock = Clock;
+		Snapshot.EntityConfigPath = EntityConfigPath;
+
+		FMassEntityQuery Query = MakeWandererQuery(EntityManager, EMassFragmentAccess::ReadOnly);
+		FMassExecutionContext ExecutionContext(EntityManager);
+
+		Query.ForEachEntityChunk(ExecutionContext, [&Snapshot](FMassExecutionContext& Context)
+		{
+			const int32 NumEntities = Context.GetNumEntities();
+			const TConstArrayView<FTransformFragment> Transforms = Context.GetFragmentView<FTransformFragment>();
+			const TConstArrayView<FMassVelocityFragment> Velocities = Context.GetFragmentView<FMassVelocityFragment>();
+
+			FSnapshotBlock& Block = Snapshot.Blocks.AddDefaulted_GetRef();
+			Block.NumEntities = NumEntities;
+			Block.Data.SetNumUninitialized(NumEntities * BytesPerEntity);
+
+			const int64 TransformBytes = NumEntities * sizeof(FTransformFragment);
+			FMemory::Memcpy(Block.Data.GetData(), Transforms.GetData(), TransformBytes);
+			FMemory::Memcpy(Block.Data.GetData() + TransformBytes, Velocities.GetData(), NumEntities * sizeof(FMassVelocityFragment));
+
+			Snapshot.NumEntities += NumEntities;
+		});
+
+		return Snapshot;
+	}
+
+	/** Compress and write a snapshot. Runs on a background thread. */
+	static bool WriteSnapshot(FSnapshot&& Snapshot, const FString& Filename, const bool bCompress)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		FFileHeader Header;
+		Header.SimTickNumber = Snapshot.Clock.SimTickNumber;
+		Header.SimTimeElapsed = Snapshot.Clock.SimTimeElapsed;
+		Header.SimTimeDilation = Snapshot.Clock.SimTimeDilation;
+		Header.SimSpeedIndex = Snapshot.Clock.SimSpeedIndex;
+		Header.ExactSimTimeMicroseconds = Snapshot.Clock.ExactSimTime.Microseconds;
+		Header.ExactSimTimeFraction = Snapshot.Clock.ExactSimTime.Fraction;
+		Header.EntityConfigPath = Snapshot.EntityConfigPath.ToString();
+		Header.NumEntities = Snapshot.NumEntities;
+		Header.NumBlocks = Snapshot.Blocks.Num();
+
+		TArray<FBlockEntry> BlockEntries;
+		BlockEntries.SetNum(Snapshot.Blocks.Num());
+
+		// Compress in place: each block's Data is replaced with its stored form
+		for (int32 BlockIndex = 0; BlockIndex < Snapshot.Blocks.Num(); ++BlockIndex)
+		{
+			FSnapshotBlock& Block = Snapshot.Blocks[BlockIndex];
+			FBlockEntry& Entry = BlockEntries[BlockIndex];
+			Entry.NumEntities = Block.NumEntities;
+			Entry.UncompressedSize = Block.Data.Num();
+			Entry.StoredSize = Block.Data.Num();
+
+			if (bCompress)
+			{
+				int32 CompressedSize = FCompression::CompressMemoryBound(NAME_LZ4, Block.Data.Num());
+				TArray<uint8> CompressedData;
+				CompressedData.SetNumUninitialized(CompressedSize);
+
+				// If it didn't get any smaller, just store it raw
+				if (FCompression::CompressMemory(NAME_LZ4, CompressedData.GetData(), CompressedSize, Block.Data.GetData(), Block.Data.Num())
+					&& CompressedSize < Block.Data.Num())
+				{
+					CompressedData.SetNum(CompressedSize);
+					Block.Data = MoveTemp(CompressedData);
+					Entry.StoredSize = CompressedSize;
+				}
+			}
+		}
+
+		// The header is fixed size, so serialize once to measure it, then compute aligned block offsets
+		TArray<uint8> HeaderBytes;
+		{
+			FMemoryWriter HeaderWriter(HeaderBytes);
+			HeaderWriter << Header;
+			HeaderWriter << BlockEntries;
+		}
+
+		int64 Offset = Align<int64>(HeaderBytes.Num(), BlockAlignment);
+		for (FBlockEntry& Entry : BlockEntries)
+		{
+			Entry.Offset = Offset;
+			Offset = Align(Offset + Entry.StoredSize, BlockAlignment);
+		}
+
+		HeaderBytes.Reset();
+		{
+			FMemoryWriter HeaderWriter(HeaderBytes);
+			HeaderWriter << Header;
+			HeaderWriter << BlockEntries;
+		}
+
+		// Write to a temp file and move it into place, so a crash mid-save never corrupts the previous save
+		const FString TempFilename = Filename + TEXT(".tmp");
+		{
+			TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFilename));
+			if (!Writer)
+			{
+				UE_LOG(LogMassTimeGame, Error, TEXT("Failed to open sim save file [%s] for writing"), *TempFilename);
+				return false;
+			}
+
+			static constexpr uint8 Padding[BlockAlignment] = {};
+
+			Writer->Serialize(HeaderBytes.GetData(), HeaderBytes.Num());
+			int64 WrittenBytes = HeaderBytes.Num();
+
+			for (int32 BlockIndex = 0; BlockIndex < Snapshot.Blocks.Num(); ++BlockIndex)
+			{
+				const FBlockEntry& Entry = BlockEntries[BlockIndex];
+				Writer->Serialize(const_cast<uint8*>(Padding), Entry.Offset - WrittenBytes);
+				Writer->Serialize(Snapshot.Blocks[BlockIndex].Data.GetData(), Entry.StoredSize);
+				WrittenBytes = Entry.Offset + Entry.StoredSize;
+			}
+
+			if (!Writer->Close())
+			{
+				UE_LOG(LogMassTimeGame, Error, TEXT("Failed to write sim save file [%s]"), *TempFilename);
+				return false;
+			}
+		}
+
+		if (!IFileManager::Get().Move(*Filename, *TempFilename, /*bReplace*/ true))
+		{
+			UE_LOG(LogMassTimeGame, Error, TEXT("Failed to move sim save file [%s] to [%s]"), *TempFilename, *Filename);
+			return false;
+		}
+
+		UE_LOG(LogMassTimeGame, Log, TEXT("Saved %lld wanderers at tick %llu to [%s] in %.2f ms (background)"), Header.NumEntities, Header.SimTickNumber, *Filename, 1000. * (FPlatformTime::Seconds() - StartTime));
+		return true;
+	}
+
+	/**
+	 * Spawn one wanderer per saved entity that had no live wanderer to load into
+	 * @return Number of wanderers spawned
+	 */
+	static int32 SpawnMissing(UWorld& World, FMassEntityManager& EntityManager, const UMassEntityConfigAsset& EntityConfig, TConstArrayView<FTransformFragment> Transforms, TConstArrayView<FMassVelocityFragment> Velocities)
+	{
+		UMassSpawnerSubsystem* SpawnerSubsystem = World.GetSubsystem<UMassSpawnerSubsystem>();
+		if (!ensure(SpawnerSubsystem))
+		{
+			return 0;
+		}
+
+		const FMassEntityTemplate& EntityTemplate = EntityConfig.GetOrCreateEntityTemplate(World);
+
+		// Entity N gets transform N, so it lines up with Velocities too
+		FMassTransformsSpawnData SpawnData;
+		SpawnData.bRandomize = false;
+		SpawnData.Transforms.Reserve(Transforms.Num());
+		for (const FTransformFragment& Transform : Transforms)
+		{
+			SpawnData.Transforms.Add(Transform.GetTransform());
+		}
+
+		TArray<FMassEntityHandle> SpawnedEntities;
+		SpawnerSubsystem->SpawnEntities(EntityTemplate.GetTemplateID(), Transforms.Num(), FConstStructView::Make(SpawnData), UMassSpawnLocationProcessor::StaticClass(), SpawnedEntities);
+
+		// The spawn location processor only sets the transform; restore the rest of the saved state
+		for (int32 Index = 0; Index < SpawnedEntities.Num(); ++Index)
+		{
+			if (FTransformFragment* Transform = EntityManager.GetFragmentDataPtr<FTransformFragment>(SpawnedEntities[Index]))
+			{
+				*Transform = Transforms[Index];
+			}
+			if (FMassVelocityFragment* Velocity = EntityManager.GetFragmentDataPtr<FMassVelocityFragment>(SpawnedEntities[Index]))
+			{
+				*Velocity = Velocities[Index];
+			}
+		}
+
+		return SpawnedEntities.Num();
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdSaveSim(
+		TEXT("mtg.SaveSim"),
+		TEXT("Save the wanderer entities and sim clock. Usage: mtg.SaveSim [Filename]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UMTGSimSaveSubsystem* SaveSubsystem = World ? World->GetSubsystem<UMTGSimSaveSubsystem>() : nullptr)
+			{
+				SaveSubsystem->RequestSave(Args.Num() > 0 ? Args[0] : UMTGSimSaveSubsystem::GetDefaultSaveFilename());
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdLoadSim(
+		TEXT("mtg.LoadSim"),
+		TEXT("Load the wanderer entities and sim clock. Usage: mtg.LoadSim [Filename]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (UMTGSimSaveSubsystem* SaveSubsystem = World ? World->GetSubsystem<UMTGSimSaveSubsystem>() : nullptr)
+			{
+				SaveSubsystem->LoadSimulation(Args.Num() > 0 ? Args[0] : UMTGSimSaveSubsystem::GetDefaultSaveFilename());
+			}
+		}));
+}
+
+// Set Class Defaults
+UMTGSimSaveSubsystem::UMTGSimSaveSubsystem()
+{
+	AutosaveIntervalSeconds = 0.f;
+	bCompressSaves = true;
+}
+
+void UMTGSimSaveSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+	}
+}
+
+void UMTGSimSaveSubsystem::Deinitialize()
+{
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	// Don't let a save outlive the world; the snapshot is self-contained, but we want it on disk before exit
+	SaveTask.Wait();
+
+	Super::Deinitialize();
+}
+
+bool UMTGSimSaveSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+FString UMTGSimSaveSubsystem::GetDefaultSaveFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT("MTG") / TEXT("Autosave.mtgsim");
+}
+
+bool UMTGSimSaveSubsystem::RequestSave(const FString& Filename)
+{
+	if (IsSaveInProgress())
+	{
+		UE_LOG(LogMassTimeGame, Warning, TEXT("Cannot save [%s], a save is already in progress"), *Filename);
+		return false;
+	}
+
+	PendingSaveFilename = Filename;
+
+	if (SimTimeSubsystem && SimTimeSubsystem->IsPaused())
+	{
+		// No sim ticks are coming while paused, and we're already at a tick boundary
+		SnapshotAndWrite();
+	}
+
+	return true;
+}
+
+bool UMTGSimSaveSubsystem::IsSaveInProgress() const
+{
+	return !PendingSaveFilename.IsEmpty() || !SaveTask.IsCompleted();
+}
+
+void UMTGSimSaveSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	if (AutosaveIntervalSeconds > 0.f
+		&& SimTimeSubsystemIn->GetSimTimeElapsed() - LastAutosaveSimTime >= AutosaveIntervalSeconds
+		&& !IsSaveInProgress())
+	{
+		LastAutosaveSimTime = SimTimeSubsystemIn->GetSimTimeElapsed();
+		PendingSaveFilename = GetDefaultSaveFilename();
+	}
+
+	if (!PendingSaveFilename.IsEmpty())
+	{
+		SnapshotAndWrite();
+	}
+}
+
+void UMTGSimSaveSubsystem::SnapshotAndWrite()
+{
+	using namespace UE::MTG::SimSave;
+
+	check(IsInGameThread());
+	check(SimTimeSubsystem);
+
+	UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntitySubsystem))
+	{
+		PendingSaveFilename.Reset();
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	const UMTGSpawnerSubsystem* SpawnerSubsystem = GetWorld()->GetSubsystem<UMTGSpawnerSubsystem>();
+	const UMassEntityConfigAsset* EntityConfig = SpawnerSubsystem ? SpawnerSubsystem->GetWandererEntityConfig() : nullptr;
+
+	FSnapshot Snapshot = TakeSnapshot(EntitySubsystem->GetMutableEntityManager(), SimTimeSubsystem->GetSimClockState(), FSoftObjectPath(EntityConfig));
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Sim save snapshot of %lld wanderers (%d chunks) took %.3f ms on the game thread"), Snapshot.NumEntities, Snapshot.Blocks.Num(), 1000. * (FPlatformTime::Seconds() - StartTime));
+
+	SaveTask = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+		[Snapshot = MoveTemp(Snapshot), Filename = MoveTemp(PendingSaveFilename), bCompress = bCompressSaves]() mutable
+		{
+			WriteSnapshot(MoveTemp(Snapshot), Filename, bCompress);
+		});
+
+	PendingSaveFilename.Reset();
+}
+
+bool UMTGSimSaveSubsystem::LoadSimulation(const FString& Filename)
+{
+	using namespace UE::MTG::SimSave;
+
+	check(IsInGameThread());
+
+	UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntitySubsystem) || !ensure(SimTimeSubsystem))
+	{
+		return false;
+	}
+
+	// A pipelined sim tick may be writing the fragments right now
+	SimTimeSubsystem->FlushSimPipeline();
+
+	FMassEntityManager& EntityManager = EntitySubsystem->GetMutableEntityManager();
+	if (!ensureMsgf(!EntityManager.IsProcessing(), TEXT("Cannot load a sim while Mass is processing")))
+	{
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*Filename));
+	if (!MappedFile)
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Failed to open sim save file [%s]"), *Filename);
+		return false;
+	}
+
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	if (!MappedRegion)
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Failed to map sim save file [%s]"), *Filename);
+		return false;
+	}
+
+	const uint8* FileData = MappedRegion->GetMappedPtr();
+	const int64 FileSize = MappedRegion->GetMappedSize();
+
+	FFileHeader Header;
+	TArray<FBlockEntry> BlockEntries;
+	{
+		FMemoryReaderView HeaderReader(MakeArrayView(FileData, static_cast<int32>(FMath::Min<int64>(FileSize, MAX_int32))));
+		HeaderReader << Header;
+
+		if (HeaderReader.IsError()
+			|| Header.Magic != FileMagic
+			|| Header.Version < MinFileVersion
+			|| Header.Version > FileVersion
+			|| Header.TransformFragmentSize != sizeof(FTransformFragment)
+			|| Header.VelocityFragmentSize != sizeof(FMassVelocityFragment))
+		{
+			UE_LOG(LogMassTimeGame, Error, TEXT("Sim save file [%s] is not compatible with this build"), *Filename);
+			return false;
+		}
+
+		// Check the table fits in what's left before allocating for it
+		int32 NumBlockEntries = 0;
+		HeaderReader << NumBlockEntries;
+
+		if (HeaderReader.IsError()
+			|| Header.NumEntities < 0
+			|| Header.NumBlocks < 0
+			|| NumBlockEntries != Header.NumBlocks
+			|| Header.NumBlocks * BlockEntrySize > HeaderReader.TotalSize() - HeaderReader.Tell())
+		{
+			UE_LOG(LogMassTimeGame, Error, TEXT("Sim save file [%s] has a corrupt block table"), *Filename);
+			return false;
+		}
+
+		BlockEntries.SetNum(NumBlockEntries);
+		for (FBlockEntry& Entry : BlockEntries)
+		{
+			HeaderReader << Entry;
+		}
+
+		// Every block must lie between the end of the table and the end of the file, and add up to the header's count
+		const int64 BlocksStart = HeaderReader.Tell();
+		int64 NumBlockEntities = 0;
+		bool bValidBlocks = !HeaderReader.IsError();
+		for (const FBlockEntry& Entry : BlockEntries)
+		{
+			bValidBlocks = bValidBlocks
+				&& Entry.NumEntities >= 0
+				&& Entry.StoredSize >= 0
+				&& Entry.StoredSize <= Entry.UncompressedSize
+				&& Entry.UncompressedSize == Entry.NumEntities * BytesPerEntity
+				&& Entry.Offset >= BlocksStart
+				&& Entry.Offset <= FileSize - Entry.StoredSize;
+			NumBlockEntities += Entry.NumEntities;
+		}
+
+		if (!bValidBlocks || NumBlockEntities != Header.NumEntities)
+		{
+			UE_LOG(LogMassTimeGame, Error, TEXT("Sim save file [%s] has a corrupt block table"), *Filename);
+			return false;
+		}
+	}
+
+	// Decompress everything before touching any entity, so a corrupt block fails the load instead of leaving it half done
+	TArray<const uint8*> BlockDatas;
+	TArray64<uint8> DecompressedData;
+	{
+		int64 DecompressedSize = 0;
+		for (const FBlockEntry& Entry : BlockEntries)
+		{
+			DecompressedSize += Entry.StoredSize < Entry.UncompressedSize ? Align<int64>(Entry.UncompressedSize, BlockAlignment) : 0;
+		}
+		DecompressedData.SetNumUninitialized(DecompressedSize);
+
+		int64 DecompressedOffset = 0;
+		for (int32 BlockIndex = 0; BlockIndex < BlockEntries.Num(); ++BlockIndex)
+		{
+			const FBlockEntry& Entry = BlockEntries[BlockIndex];
+			if (Entry.StoredSize < Entry.UncompressedSize)
+			{
+				uint8* Data = DecompressedData.GetData() + DecompressedOffset;
+				if (!FCompression::UncompressMemory(NAME_LZ4, Data, Entry.UncompressedSize, FileData + Entry.Offset, Entry.StoredSize))
+				{
+					UE_LOG(LogMassTimeGame, Error, TEXT("Sim save file [%s] block %d failed to decompress"), *Filename, BlockIndex);
+					return false;
+				}
+				BlockDatas.Add(Data);
+				DecompressedOffset += Align<int64>(Entry.UncompressedSize, BlockAlignment);
+			}
+			else
+			{
+				// Mapped file memory, no copy needed
+				BlockDatas.Add(FileData + Entry.Offset);
+			}
+		}
+	}
+
+	// Walk the saved blocks and the live chunks in parallel. They usually line up 1:1,
+	// but if the chunk layout changed (e.g. different archetype) we copy in partial spans.
+	int32 BlockIndex = 0;
+	int32 BlockEntityIndex = 0;
+
+	// Skip empty blocks, so BlockIndex is always a block with entities left, or the end
+	auto SkipEmptyBlocks = [&]()
+	{
+		while (BlockIndex < BlockEntries.Num() && BlockEntityIndex >= BlockEntries[BlockIndex].NumEntities)
+		{
+			++BlockIndex;
+			BlockEntityIndex = 0;
+		}
+	};
+	SkipEmptyBlocks();
+
+	int64 NumLoaded = 0;
+	bool bLoadError = false;
+	TArray<FMassEntityHandle> SurplusEntities;
+
+	FMassEntityQuery Query = MakeWandererQuery(EntityManager, EMassFragmentAccess::ReadWrite);
+	FMassExecutionContext ExecutionContext(EntityManager);
+
+	Query.ForEachEntityChunk(ExecutionContext, [&](FMassExecutionContext& Context)
+	{
+		const TArrayView<FTransformFragment> Transforms = Context.GetMutableFragmentView<FTransformFragment>();
+		const TArrayView<FMassVelocityFragment> Velocities = Context.GetMutableFragmentView<FMassVelocityFragment>();
+
+		const int32 NumEntities = Context.GetNumEntities();
+		int32 ChunkEntityIndex = 0;
+
+		while (ChunkEntityIndex < NumEntities)
+		{
+			if (BlockIndex >= BlockEntries.Num())
+			{
+				// Out of saved data; everything left in the world is surplus
+				for (; ChunkEntityIndex < NumEntities; ++ChunkEntityIndex)
+				{
+					SurplusEntities.Add(Context.GetEntity(ChunkEntityIndex));
+				}
+				break;
+			}
+
+			const uint8* Data = BlockDatas[BlockIndex];
+			const int32 BlockNumEntities = BlockEntries[BlockIndex].NumEntities;
+			const int32 NumToCopy = FMath::Min(NumEntities - ChunkEntityIndex, BlockNumEntities - BlockEntityIndex);
+
+			const FTransformFragment* SavedTransforms = reinterpret_cast<const FTransformFragment*>(Data);
+			const FMassVelocityFragment* SavedVelocities = reinterpret_cast<const FMassVelocityFragment*>(Data + BlockNumEntities * sizeof(FTransformFragment));
+
+			FMemory::Memcpy(&Transforms[ChunkEntityIndex], SavedTransforms + BlockEntityIndex, NumToCopy * sizeof(FTransformFragment));
+			FMemory::Memcpy(&Velocities[ChunkEntityIndex], SavedVelocities + BlockEntityIndex, NumToCopy * sizeof(FMassVelocityFragment));
+
+			ChunkEntityIndex += NumToCopy;
+			BlockEntityIndex += NumToCopy;
+			NumLoaded += NumToCopy;
+
+			SkipEmptyBlocks();
+		}
+	});
+
+	if (SurplusEntities.Num() > 0)
+	{
+		UE_LOG(LogMassTimeGame, Log, TEXT("Destroying %d wanderers that are not in the sim save"), SurplusEntities.Num());
+		EntityManager.Defer().DestroyEntities(SurplusEntities);
+		EntityManager.FlushCommands();
+	}
+
+	if (NumLoaded < Header.NumEntities)
+	{
+		// The world has fewer wanderers than the save; spawn the rest from the config they were saved with
+		TArray<FTransformFragment> MissingTransforms;
+		TArray<FMassVelocityFragment> MissingVelocities;
+		const int32 NumMissing = static_cast<int32>(Header.NumEntities - NumLoaded);
+		MissingTransforms.Reserve(NumMissing);
+		MissingVelocities.Reserve(NumMissing);
+
+		for (; BlockIndex < BlockEntries.Num(); ++BlockIndex, BlockEntityIndex = 0)
+		{
+			const int32 BlockNumEntities = BlockEntries[BlockIndex].NumEntities;
+			const FTransformFragment* SavedTransforms = reinterpret_cast<const FTransformFragment*>(BlockDatas[BlockIndex]);
+			const FMassVelocityFragment* SavedVelocities = reinterpret_cast<const FMassVelocityFragment*>(BlockDatas[BlockIndex] + BlockNumEntities * sizeof(FTransformFragment));
+
+			MissingTransforms.Append(SavedTransforms + BlockEntityIndex, BlockNumEntities - BlockEntityIndex);
+			MissingVelocities.Append(SavedVelocities + BlockEntityIndex, BlockNumEntities - BlockEntityIndex);
+		}
+
+		// Version 2 files don't say; the spawner's wanderers are the only ones we save
+		const UMTGSpawnerSubsystem* SpawnerSubsystem = GetWorld()->GetSubsystem<UMTGSpawnerSubsystem>();
+		const UMassEntityConfigAsset* EntityConfig = !Header.EntityConfigPath.IsEmpty()
+			? TSoftObjectPtr<UMassEntityConfigAsset>(FSoftObjectPath(Header.EntityConfigPath)).LoadSynchronous()
+			: SpawnerSubsystem ? SpawnerSubsystem->GetWandererEntityConfig() : nullptr;
+
+		const int32 NumSpawned = EntityConfig ? SpawnMissing(*GetWorld(), EntityManager, *EntityConfig, MissingTransforms, MissingVelocities) : 0;
+		NumLoaded += NumSpawned;
+
+		if (NumSpawned < MissingTransforms.Num())
+		{
+			UE_LOG(LogMassTimeGame, Error, TEXT("Sim save [%s] has %lld wanderers, but only %lld could be loaded or spawned (entity config [%s])"),
+				*Filename, Header.NumEntities, NumLoaded, *Header.EntityConfigPath);
+			bLoadError = true;
+		}
+		else
+		{
+			UE_LOG(LogMassTimeGame, Log, TEXT("Spawned %d wanderers that were in the sim save but not in the world"), NumSpawned);
+		}
+	}
+
+	FMTGSimClockState Clock;
+	Clock.SimTickNumber = Header.SimTickNumber;
+	Clock.SimTimeElapsed = Header.SimTimeElapsed;
+	Clock.SimTimeDilation = Header.SimTimeDilation;
+	Clock.SimSpeedIndex = Header.SimSpeedIndex;
+	if (Header.Version >= 2)
+	{
+		Clock.ExactSimTime.Microseconds = Header.ExactSimTimeMicroseconds;
+		Clock.ExactSimTime.Fraction = Header.ExactSimTimeFraction;
+	}
+	else
+	{
+		Clock.ExactSimTime = FMTGExactSimTime::FromSeconds(Header.SimTimeElapsed);
+	}
+	SimTimeSubsystem->RestoreSimClockState(Clock);
+
+	LastAutosaveSimTime = Clock.SimTimeElapsed;
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Loaded %lld wanderers from [%s] in %.2f ms"), NumLoaded, *Filename, 1000. * (FPlatformTime::Seconds() - StartTime));
+	return !bLoadError;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "MTGSimSaveSubsystem.generated.h"
+
+class UMTGSimTimeSubsystem;
+
+/**
+ * MTG Sim Save Subsystem
+ *
+ * Saves and loads the wanderer entities (transform + velocity fragments)
+ * along with the sim clock (tick number, elapsed time, dilation, speed index).
+ *
+ * The file is laid out in blocks that each hold one archetype chunk worth of
+ * fragment arrays, so saving is a memcpy per chunk per fragment, and loading
+ * maps the file into memory and copies each block straight back into chunk
+ * memory.
+ *
+ * Saving happens in 2 phases:
+ *
+ * 1) At the next sim tick boundary, the game thread copies the fragment arrays
+ *    out of every chunk into a snapshot.  This is the only game thread cost.
+ * 2) A background task compresses the snapshot and writes it to disk.
+ *
+ * Only one save may be in flight at a time.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Sim Save Subsystem"))
+class MASSTIMEGAME_API UMTGSimSaveSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGSimSaveSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 * Get the filename used when no explicit filename is given
+	 * @return Full path to the default save file
+	 */
+	static FString GetDefaultSaveFilename();
+
+	/**
+	 * Request a save of the simulation.
+	 *
+	 * If the sim is paused, the snapshot is taken immediately, otherwise it is
+	 * taken at the end of the next sim tick.  Either way the file is written
+	 * in the background.
+	 *
+	 * @param Filename Full path of the file to write
+	 * @return True if the save was queued, else False (e.g. a save is already in progress)
+	 */
+	bool RequestSave(const FString& Filename);
+
+	/**
+	 * Load a previously saved simulation into the current world.
+	 *
+	 * This copies the saved fragment data into the existing wanderer entities.
+	 * If the world has more wanderers than the file, the extras are destroyed.
+	 * If the file has more wanderers than the world, the extras are spawned
+	 * from the entity config saved with them, at their saved transform and velocity.
+	 *
+	 * The whole file is validated and decompressed first, so a corrupt file
+	 * fails the load without changing any entity.
+	 *
+	 * This must not be called while Mass is processing.
+	 *
+	 * @param Filename Full path of the file to read
+	 * @return True if the file was loaded, else False
+	 */
+	bool LoadSimulation(const FString& Filename);
+
+	/**
+	 * Is there a save in progress (either waiting for a snapshot, or writing in the background)?
+	 * @return True if a save is in progress, else False
+	 */
+	bool IsSaveInProgress() const;
+
+protected:
+	/**
+	 * Sim time (seconds) between automatic saves to the default filename.
+	 * Set to 0 to disable autosave.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0))
+	float AutosaveIntervalSeconds;
+
+	/** Compress the saved blocks?  Costs background CPU, saves disk space. */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	bool bCompressSaves;
+
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/**
+	 * Snapshot the simulation now, and write it to PendingSaveFilename in the background.
+	 * MUST be called on the game thread at a tick boundary.
+	 */
+	void SnapshotAndWrite();
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem since we use it every tick */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** Filename to write on the next tick boundary, or empty if no save is pending */
+	FString PendingSaveFilename;
+
+	/** The background compress+write task of the current save, if any */
+	UE::Tasks::FTask SaveTask;
+
+	/** SimTimeElapsed at the last autosave */
+	double LastAutosaveSimTime = 0.;
+};
@@ -2,14 +2,135 @@
 
 #include "MTGSimTimeSubsystem.h"
 
+#include "MassEntitySubsystem.h"
+#include "MassExecutor.h"
+#include "MassProcessingTypes.h"
+#include "MassProcessor.h"
 #include "MassSimulationSubsystem.h"
 #include "MassTimeGame.h"
+#include "MTGCrowdDensityProcessor.h"
+#include "MTGFlowFieldProcessor.h"
+#include "MTGWanderSteeringProcessor.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/World.h"
 #include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Sim Pipeline"), STAT_MTGSimPipeline, STATGROUP_MassTimeGame);
+DECLARE_CYCLE_STAT(TEXT("MTG Sim Pipeline Wait"), STAT_MTGSimPipelineWait, STATGROUP_MassTimeGame);
+DECLARE_CYCLE_STAT(TEXT("MTG Sim Tick Reader Wait"), STAT_MTGSimTickReaderWait, STATGROUP_MassTimeGame);
+DECLARE_CYCLE_STAT(TEXT("MTG Fast Forward Steps"), STAT_MTGFastForwardSteps, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Fast Forward Steps/Frame"), STAT_MTGFastForwardStepsPerFrame, STATGROUP_MassTimeGame);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("MTG Input To Effect (ms)"), STAT_MTGInputToEffect, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Frame Arena Used KB"), STAT_MTGFrameArenaUsedKB, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Frame Arena High Water KB"), STAT_MTGFrameArenaHighWaterKB, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Frame Arena Reserved KB"), STAT_MTGFrameArenaReservedKB, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Frame Arena Blocks Allocated"), STAT_MTGFrameArenaBlocksAllocated, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Frame Arena Heap Fallbacks"), STAT_MTGFrameArenaHeapFallbacks, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Sim Tick Heap Allocs"), STAT_MTGSimTickHeapAllocs, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::Private
+{
+	static bool bPipelinedSim = false;
+	static FAutoConsoleVariableRef CVarPipelinedSim(
+		TEXT("mtg.PipelinedSim"),
+		bPipelinedSim,
+		TEXT("If true, the MTGSimTimeSubsystem PipelinedProcessors run on a background task overlapped with the end of the frame. Takes effect at the next sim tick boundary."));
+
+	/** True while this thread is running the sim pipeline's processors */
+	static thread_local bool bIsSimPipelineThread = false;
+
+	static int32 FrameArenaWarmUpTicks = 300;
+	static FAutoConsoleVariableRef CVarFrameArenaWarmUpTicks(
+		TEXT("mtg.FrameArena.WarmUpTicks"),
+		FrameArenaWarmUpTicks,
+		TEXT("Tick boundaries before the frame arenas are expected to have stopped touching the heap; any sim tick heap allocation after that is logged as a warning"));
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdFastForwardTo(
+		TEXT("mtg.FastForwardTo"),
+		TEXT("Fast forward the simulation to the given SimTimeElapsed (seconds). Usage: mtg.FastForwardTo 1800"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UMTGSimTimeSubsystem* SimTimeSubsystem = World ? World->GetSubsystem<UMTGSimTimeSubsystem>() : nullptr;
+			if (SimTimeSubsystem && Args.Num() > 0)
+			{
+				if (!SimTimeSubsystem->FastForwardTo(FCString::Atod(*Args[0])))
+				{
+					UE_LOG(LogMassTimeGame, Warning, TEXT("Cannot fast forward from %.4f to %s"), SimTimeSubsystem->GetSimTimeElapsed(), *Args[0]);
+				}
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorld CmdInputLatency(
+		TEXT("mtg.InputLatency"),
+		TEXT("Log the player input-to-effect latency (real ms) measured at each sim speed"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UMTGSimTimeSubsystem* SimTimeSubsystem = World ? World->GetSubsystem<UMTGSimTimeSubsystem>() : nullptr)
+			{
+				SimTimeSubsystem->LogInputLatency();
+			}
+		}));
+
+	static FAutoConsoleCommandWithWorld CmdFrameArenaStats(
+		TEXT("mtg.FrameArenaStats"),
+		TEXT("Log the sim tick frame arena counters"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UMTGSimTimeSubsystem* SimTimeSubsystem = World ? World->GetSubsystem<UMTGSimTimeSubsystem>() : nullptr)
+			{
+				SimTimeSubsystem->LogFrameArenaStats();
+			}
+		}));
+}
+
+void FMTGExactSimTime::Advance(const double DeltaSeconds)
+{
+	// Split into whole microseconds and a Q32 fraction; DeltaSeconds comes from a float, so this split is exact to 2^-32 us
+	const double DeltaMicroseconds = FMath::Max(0., DeltaSeconds) * 1'000'000.;
+	const double WholeMicroseconds = FMath::FloorToDouble(DeltaMicroseconds);
+	const uint64 DeltaFraction = static_cast<uint64>(FMath::RoundToDouble((DeltaMicroseconds - WholeMicroseconds) * 4294967296.));
+
+	const uint64 FractionSum = static_cast<uint64>(Fraction) + DeltaFraction;
+	Microseconds += static_cast<uint64>(WholeMicroseconds) + (FractionSum >> 32);
+	Fraction = static_cast<uint32>(FractionSum);
+}
+
+double FMTGExactSimTime::ToSeconds() const
+{
+	return (static_cast<double>(Microseconds) + Fraction / 4294967296.) / 1'000'000.;
+}
+
+FMTGExactSimTime FMTGExactSimTime::FromSeconds(const double Seconds)
+{
+	FMTGExactSimTime ExactTime;
+	ExactTime.Advance(Seconds);
+	return ExactTime;
+}
 
 UMTGSimTimeSubsystem::UMTGSimTimeSubsystem()
 {
 	// Override in Config if you want different options
 	SimSpeedOptions = {.125f, .25f, .5f, .75f, 1.f, 2.f, 3.f, 4.f, 8.f};
+
+	// One 30 fps frame of sim time per fast forward step, as many steps per frame as fit in 50 ms
+	FastForwardStepSeconds = 1.f / 30.f;
+	FastForwardFrameBudgetMs = 50.f;
+
+	PipelinedProcessors = {
+		UMTGCrowdDensityProcessor::StaticClass(),
+		UMTGFlowFieldProcessor::StaticClass(),
+		UMTGWanderSteeringProcessor::StaticClass(),
+	};
+
+	FastForwardProcessors = {
+		TSoftClassPtr<UMassProcessor>(FSoftObjectPath(TEXT("/Script/MassAIBehavior.MassStateTreeProcessor"))),
+		UMTGCrowdDensityProcessor::StaticClass(),
+		UMTGFlowFieldProcessor::StaticClass(),
+		UMTGWanderSteeringProcessor::StaticClass(),
+		TSoftClassPtr<UMassProcessor>(FSoftObjectPath(TEXT("/Script/MassMovement.MassApplyMovementProcessor"))),
+	};
 }
 
 void UMTGSimTimeSubsystem::PostInitProperties()
@@ -87,14 +208,46 @@ void UMTGSimTimeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 
 	MassSimulationSubsystem->GetOnSimulationPaused().AddUObject(this, &ThisClass::NativeOnSimulationPaused);
 	MassSimulationSubsystem->GetOnSimulationResumed().AddUObject(this, &ThisClass::NativeOnSimulationResumed);
+
+	// Every phase start is a tick boundary at which player input can be applied
+	for (int32 PhaseIndex = 0; PhaseIndex < static_cast<int32>(EMassProcessingPhase::MAX); ++PhaseIndex)
+	{
+		MassSimulationSubsystem->GetOnProcessingPhaseStarted(static_cast<EMassProcessingPhase>(PhaseIndex)).AddUObject(this, &ThisClass::NativeOnProcessingPhaseStarted);
+	}
+
+	WorldPreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &ThisClass::NativeOnWorldPreActorTick);
 }
 
 void UMTGSimTimeSubsystem::Deinitialize()
 {
+	if (IsFastForwarding())
+	{
+		// FApp fixed time step is global, DO NOT leave it enabled after this world goes away
+		EndFastForward();
+	}
+
+	FWorldDelegates::OnWorldPreActorTick.Remove(WorldPreActorTickHandle);
+
+	// The pipeline task uses the entity manager, DO NOT let it outlive the world
+	if (SimPipelineTask.IsValid())
+	{
+		SimPipelineTask.Wait();
+		SimPipelineTask = {};
+	}
+	bIsSimTickCompletionPending = false;
+
+	UE::Tasks::Wait(SimTickReaderTasks);
+	SimTickReaderTasks.Reset();
+
 	if (UMassSimulationSubsystem* MassSimulationSubsystem = GetWorld()->GetSubsystem<UMassSimulationSubsystem>())
 	{
 		MassSimulationSubsystem->GetOnSimulationPaused().RemoveAll(this);
 		MassSimulationSubsystem->GetOnSimulationResumed().RemoveAll(this);
+
+		for (int32 PhaseIndex = 0; PhaseIndex < static_cast<int32>(EMassProcessingPhase::MAX); ++PhaseIndex)
+		{
+			MassSimulationSubsystem->GetOnProcessingPhaseStarted(static_cast<EMassProcessingPhase>(PhaseIndex)).RemoveAll(this);
+		}
 	}
 
 	Super::Deinitialize();
@@ -110,6 +263,19 @@ void UMTGSimTimeSubsystem::Tick(float DeltaTime)
 	// to optimize for that state. Yes, this burns a little CPU when the
 	// simulation is paused, but it still seems worthwhile.
 
+	bool bDidSimTick = false;
+
+	if (UNLIKELY(IsFastForwarding()))
+	{
+		const UMassSimulationSubsystem* MassSimulationSubsystem = GetWorld()->GetSubsystem<UMassSimulationSubsystem>();
+		if (MassSimulationSubsystem && MassSimulationSubsystem->IsSimulationPaused())
+		{
+			// The Mass phases didn't run this frame; the fast forward steps are this frame's sim ticks
+			RunFastForwardSteps();
+			return;
+		}
+	}
+
 	if (UNLIKELY(IsPaused()))
 	{
 		// While paused, report zero DeltaTime
@@ -117,10 +283,23 @@ void UMTGSimTimeSubsystem::Tick(float DeltaTime)
 	}
 	else
 	{
+		bDidSimTick = true;
+
 		// While running, keep track of time (DeltaTime is sim-dilated)
-		SimDeltaTime = DeltaTime;
-		SimTimeElapsed += DeltaTime;
-		++SimTickNumber;
+		AdvanceSimClock(DeltaTime);
+
+		if (UNLIKELY(IsFastForwarding()))
+		{
+			if (SimTimeElapsed >= FastForwardTargetTime)
+			{
+				UE_LOG(LogMassTimeGame, Log, TEXT("Fast Forward reached %.4f (target %.4f) at tick %llu"), SimTimeElapsed, FastForwardTargetTime, SimTickNumber);
+				EndFastForward();
+			}
+			else
+			{
+				UpdateFastForwardStep();
+			}
+		}
 	}
 
 	// Check for external changes to the world time dilation.
@@ -161,6 +340,404 @@ void UMTGSimTimeSubsystem::Tick(float DeltaTime)
 
 		OnTimeDilationChanged.Broadcast(this);
 	}
+
+	if (LIKELY(bDidSimTick))
+	{
+		if (bIsSimPipelined && !bMassProcessingSuspended)
+		{
+			// This tick isn't complete until its pipelined processors finish; FlushSimPipeline will broadcast
+			LaunchSimPipeline(SimDeltaTime);
+			bIsSimTickCompletionPending = true;
+		}
+		else
+		{
+			CompleteSimTick();
+		}
+	}
+}
+
+void UMTGSimTimeSubsystem::AdvanceSimClock(const double DeltaTime)
+{
+	SimDeltaTime = DeltaTime;
+	SimTimeElapsed += DeltaTime;
+	ExactSimTime.Advance(DeltaTime);
+	++SimTickNumber;
+}
+
+bool UMTGSimTimeSubsystem::IsDeferredToSimPipeline(const UWorld* World)
+{
+	if (UE::MTG::Private::bIsSimPipelineThread)
+	{
+		// This IS the sim pipeline
+		return false;
+	}
+
+	const UMTGSimTimeSubsystem* SimTimeSubsystem = World ? World->GetSubsystem<UMTGSimTimeSubsystem>() : nullptr;
+	return SimTimeSubsystem && SimTimeSubsystem->IsSimPipelined();
+}
+
+void UMTGSimTimeSubsystem::FlushSimPipeline()
+{
+	check(IsInGameThread());
+
+	if (SimPipelineTask.IsValid())
+	{
+		// Any time spent here is pipelined sim work that the rest of the frame didn't hide
+		SCOPE_CYCLE_COUNTER(STAT_MTGSimPipelineWait);
+		SimPipelineTask.Wait();
+		SimPipelineTask = {};
+	}
+
+	if (SimTickReaderTasks.Num() > 0)
+	{
+		// Readers of the last tick must be done before the tick boundary callbacks change anything
+		SCOPE_CYCLE_COUNTER(STAT_MTGSimTickReaderWait);
+		UE::Tasks::Wait(SimTickReaderTasks);
+		SimTickReaderTasks.Reset();
+	}
+
+	if (bIsSimTickCompletionPending)
+	{
+		bIsSimTickCompletionPending = false;
+		CompleteSimTick();
+	}
+}
+
+bool UMTGSimTimeSubsystem::IsSimPipelineIdle() const
+{
+	if (SimPipelineTask.IsValid() && !SimPipelineTask.IsCompleted())
+	{
+		return false;
+	}
+
+	for (const UE::Tasks::FTask& Task : SimTickReaderTasks)
+	{
+		if (!Task.IsCompleted())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+UE::Tasks::FTask UMTGSimTimeSubsystem::LaunchSimTickReader(const TCHAR* DebugName, TUniqueFunction<void()>&& Work)
+{
+	check(IsInGameThread());
+
+	// The next FlushSimPipeline waits for this task, so the arenas outlive it
+	auto ScopedWork = [Arenas = &FrameArenas, Work = MoveTemp(Work)]()
+	{
+		FMTGFrameArenaScope ArenaScope(*Arenas);
+		Work();
+	};
+
+	// In pipelined mode the tick isn't done until its pipeline task is
+	UE::Tasks::FTask Task = SimPipelineTask.IsValid()
+		? UE::Tasks::Launch(DebugName, MoveTemp(ScopedWork), UE::Tasks::Prerequisites(SimPipelineTask))
+		: UE::Tasks::Launch(DebugName, MoveTemp(ScopedWork));
+
+	SimTickReaderTasks.Add(Task);
+	return Task;
+}
+
+void UMTGSimTimeSubsystem::CompleteSimTick()
+{
+	{
+		FMTGFrameArenaScope ArenaScope(FrameArenas);
+		OnSimTickCompleted.Broadcast(this);
+	}
+	ResolveInputLatency(EInputEffect::SimTick);
+}
+
+void UMTGSimTimeSubsystem::ResetFrameArenas()
+{
+	// Read before the reset, so Used is the whole of the tick that just ended
+	const FMTGFrameArenaStats Stats = FrameArenas.GetStats();
+	const int32 NumHeapFallbacks = FMTGFrameArenas::ConsumeNumHeapFallbacks();
+	const int32 NumScopedHeapAllocs = FMTGFrameArenas::ConsumeNumScopedHeapAllocs();
+	const int32 NumNewBlocks = Stats.NumBlocksAllocated - LastNumArenaBlocksAllocated;
+	LastNumArenaBlocksAllocated = Stats.NumBlocksAllocated;
+
+	SET_DWORD_STAT(STAT_MTGFrameArenaUsedKB, Stats.UsedBytes / 1024);
+	SET_DWORD_STAT(STAT_MTGFrameArenaHighWaterKB, Stats.HighWaterBytes / 1024);
+	SET_DWORD_STAT(STAT_MTGFrameArenaReservedKB, Stats.ReservedBytes / 1024);
+	SET_DWORD_STAT(STAT_MTGFrameArenaBlocksAllocated, Stats.NumBlocksAllocated);
+	SET_DWORD_STAT(STAT_MTGFrameArenaHeapFallbacks, NumHeapFallbacks);
+	SET_DWORD_STAT(STAT_MTGSimTickHeapAllocs, NumScopedHeapAllocs);
+
+	// Once every arena has seen its biggest tick, a sim tick must not touch the heap at all.
+	// The scoped count already includes the new blocks and fallbacks when it's installed.
+	const int32 NumHeapAllocs = FMTGFrameArenas::IsCountingScopedHeapAllocs() ? NumScopedHeapAllocs : NumNewBlocks + NumHeapFallbacks;
+	if (++NumFrameArenaResets > UE::MTG::Private::FrameArenaWarmUpTicks && NumHeapAllocs > 0)
+	{
+		NumSteadyStateHeapAllocs += NumHeapAllocs;
+		if (!bWarnedSteadyStateHeapAllocs)
+		{
+			bWarnedSteadyStateHeapAllocs = true;
+			UE_LOG(LogMassTimeGame, Warning, TEXT("Sim tick %llu made %d heap allocations after the frame arena warm up (%d new arena blocks, %d allocations outside a scope); see mtg.FrameArenaStats"),
+				GetSimTickNumber(), NumHeapAllocs, NumNewBlocks, NumHeapFallbacks);
+		}
+	}
+
+	FrameArenas.ResetAll();
+}
+
+FMTGFrameArenas* UMTGSimTimeSubsystem::FindFrameArenas(const UWorld* World)
+{
+	UMTGSimTimeSubsystem* SimTimeSubsystem = World ? World->GetSubsystem<UMTGSimTimeSubsystem>() : nullptr;
+	return SimTimeSubsystem ? &SimTimeSubsystem->FrameArenas : nullptr;
+}
+
+void UMTGSimTimeSubsystem::LogFrameArenaStats() const
+{
+	const FMTGFrameArenaStats Stats = FrameArenas.GetStats();
+	UE_LOG(LogMassTimeGame, Log, TEXT("Frame arenas: %d threads, %.1f KB used, %.1f KB high water, %.1f KB reserved, %d blocks allocated"),
+		Stats.NumArenas, Stats.UsedBytes / 1024., Stats.HighWaterBytes / 1024., Stats.ReservedBytes / 1024., Stats.NumBlocksAllocated);
+
+	const int32 NumSteadyStateTicks = FMath::Max(0, NumFrameArenaResets - UE::MTG::Private::FrameArenaWarmUpTicks);
+	UE_LOG(LogMassTimeGame, Log, TEXT("Steady state: %lld heap allocations in %d sim ticks (%s)"),
+		NumSteadyStateHeapAllocs, NumSteadyStateTicks,
+		FMTGFrameArenas::IsCountingScopedHeapAllocs() ? TEXT("every allocation in a frame arena scope") : TEXT("arena blocks and fallbacks only; run with -MTGCountSimAllocs to count every allocation"));
+}
+
+void UMTGSimTimeSubsystem::NativeOnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	// Tick boundary: finish the previous tick before any Mass phase runs, then decide how to run this one
+	FlushSimPipeline();
+
+	// Nothing from the previous tick is running anymore, so its transient memory can be reused
+	ResetFrameArenas();
+
+	// Player input goes first, so a pause takes effect before this frame's Mass work starts
+	bAppliedSimInputThisFrame = false;
+	ApplyPendingSimInputs();
+
+	if (bIsSimPipelined != UE::MTG::Private::bPipelinedSim)
+	{
+		bIsSimPipelined = UE::MTG::Private::bPipelinedSim;
+		UE_LOG(LogMassTimeGame, Log, TEXT("Pipelined simulation %s at tick %llu"), bIsSimPipelined ? TEXT("enabled") : TEXT("disabled"), SimTickNumber);
+	}
+}
+
+void UMTGSimTimeSubsystem::LaunchSimPipeline(const float DeltaTime)
+{
+	check(!SimPipelineTask.IsValid());
+
+	UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntitySubsystem))
+	{
+		return;
+	}
+
+	const TSharedRef<FMassEntityManager> EntityManager = EntitySubsystem->GetMutableEntityManager().AsShared();
+
+	if (PipelineProcessorInstances.Num() == 0)
+	{
+		for (const TSoftClassPtr<UMassProcessor>& ProcessorClass : PipelinedProcessors)
+		{
+			if (UClass* Class = ProcessorClass.LoadSynchronous())
+			{
+				UMassProcessor* Processor = NewObject<UMassProcessor>(this, Class);
+				Processor->CallInitialize(this, EntityManager);
+				PipelineProcessorInstances.Add(Processor);
+			}
+		}
+	}
+
+	// The instances are owned by this subsystem, and Deinitialize waits for the task
+	TArray<UMassProcessor*> Processors(PipelineProcessorInstances);
+
+	SimPipelineTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Processors = MoveTemp(Processors), EntityManager, DeltaTime, Arenas = &FrameArenas]()
+	{
+		SCOPE_CYCLE_COUNTER(STAT_MTGSimPipeline);
+		TGuardValue<bool> PipelineThreadGuard(UE::MTG::Private::bIsSimPipelineThread, true);
+		FMTGFrameArenaScope ArenaScope(*Arenas);
+
+		for (UMassProcessor* Processor : Processors)
+		{
+			FMassProcessingContext ProcessingContext(EntityManager, DeltaTime);
+			UE::Mass::Executor::Run(*Processor, ProcessingContext);
+		}
+	});
+}
+
+void UMTGSimTimeSubsystem::NativeOnProcessingPhaseStarted(const float DeltaSeconds)
+{
+	// Input that arrived during the previous phase (e.g. from the player controller tick) doesn't wait for the end of the frame
+	ApplyPendingSimInputs();
+}
+
+void UMTGSimTimeSubsystem::RequestSimInput(const EMTGSimInput Input)
+{
+	FTimedSimInput& TimedInput = PendingSimInputs.AddDefaulted_GetRef();
+	TimedInput.Input = Input;
+	TimedInput.RequestTime = FPlatformTime::Seconds();
+	TimedInput.SimSpeedIndex = SimSpeedIndex;
+}
+
+void UMTGSimTimeSubsystem::ApplyPendingSimInputs()
+{
+	if (LIKELY(PendingSimInputs.Num() == 0))
+	{
+		return;
+	}
+
+	check(IsInGameThread());
+	bAppliedSimInputThisFrame = true;
+
+	// Handlers may queue more input; those wait for the next boundary
+	TArray<FTimedSimInput> Inputs = MoveTemp(PendingSimInputs);
+	PendingSimInputs.Reset();
+
+	for (const FTimedSimInput& TimedInput : Inputs)
+	{
+		EInputEffect Effect = EInputEffect::SimTick;
+		bool bHasEffect = true;
+
+		switch (TimedInput.Input)
+		{
+		case EMTGSimInput::TogglePlayPause:
+			Effect = IsPaused() ? EInputEffect::Resumed : EInputEffect::Paused;
+			bHasEffect = TogglePlayPause();
+			break;
+		case EMTGSimInput::IncreaseSimSpeed:
+			bHasEffect = IncreaseSimSpeed();
+			break;
+		case EMTGSimInput::DecreaseSimSpeed:
+			bHasEffect = DecreaseSimSpeed();
+			break;
+		case EMTGSimInput::SetDestination:
+			break;
+		}
+
+		if (!bHasEffect)
+		{
+			// e.g. already at max speed; there's nothing to wait for
+			continue;
+		}
+
+		FAwaitingInputEffect& Awaiting = AwaitingInputEffects.AddDefaulted_GetRef();
+		Awaiting.Effect = Effect;
+		Awaiting.RequestTime = TimedInput.RequestTime;
+		Awaiting.SimSpeedIndex = TimedInput.SimSpeedIndex;
+	}
+
+	// While paused no sim tick will come, so speed changes and clicks are as visible as they'll get
+	if (IsPaused())
+	{
+		ResolveInputLatency(EInputEffect::SimTick);
+	}
+}
+
+void UMTGSimTimeSubsystem::ResolveInputLatency(const EInputEffect Effect)
+{
+	if (LIKELY(AwaitingInputEffects.Num() == 0))
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	for (int32 Index = 0; Index < AwaitingInputEffects.Num(); )
+	{
+		const FAwaitingInputEffect& Awaiting = AwaitingInputEffects[Index];
+		if (Awaiting.Effect != Effect)
+		{
+			++Index;
+			continue;
+		}
+
+		const double LatencyMs = 1000. * (Now - Awaiting.RequestTime);
+		SET_FLOAT_STAT(STAT_MTGInputToEffect, LatencyMs);
+
+		if (Awaiting.SimSpeedIndex >= 0)
+		{
+			if (InputLatencyBySpeed.Num() <= Awaiting.SimSpeedIndex)
+			{
+				InputLatencyBySpeed.SetNum(Awaiting.SimSpeedIndex + 1);
+			}
+
+			FMTGInputLatencyStats& Stats = InputLatencyBySpeed[Awaiting.SimSpeedIndex];
+			++Stats.NumSamples;
+			Stats.TotalMs += LatencyMs;
+			Stats.MaxMs = FMath::Max(Stats.MaxMs, LatencyMs);
+		}
+
+		AwaitingInputEffects.RemoveAtSwap(Index, EAllowShrinking::No);
+	}
+}
+
+const FMTGInputLatencyStats* UMTGSimTimeSubsystem::GetInputLatencyStats(const int32 InSimSpeedIndex) const
+{
+	return InputLatencyBySpeed.IsValidIndex(InSimSpeedIndex) && InputLatencyBySpeed[InSimSpeedIndex].NumSamples > 0
+		? &InputLatencyBySpeed[InSimSpeedIndex]
+		: nullptr;
+}
+
+void UMTGSimTimeSubsystem::LogInputLatency() const
+{
+	UE_LOG(LogMassTimeGame, Log, TEXT("Input-to-effect latency (real ms) per sim speed:"));
+
+	for (int32 Index = 0; Index < SimSpeedOptions.Num(); ++Index)
+	{
+		if (const FMTGInputLatencyStats* Stats = GetInputLatencyStats(Index))
+		{
+			UE_LOG(LogMassTimeGame, Log, TEXT("  %6.3fx: %4d inputs, avg %7.2f ms, max %7.2f ms"), SimSpeedOptions[Index], Stats->NumSamples, Stats->GetAverageMs(), Stats->MaxMs);
+		}
+		else
+		{
+			UE_LOG(LogMassTimeGame, Log, TEXT("  %6.3fx: no inputs"), SimSpeedOptions[Index]);
+		}
+	}
+}
+
+FMTGSimClockState UMTGSimTimeSubsystem::GetSimClockState() const
+{
+	FMTGSimClockState ClockState;
+	ClockState.SimTickNumber = SimTickNumber;
+	ClockState.SimTimeElapsed = SimTimeElapsed;
+	ClockState.ExactSimTime = ExactSimTime;
+	ClockState.SimTimeDilation = SimTimeDilation;
+	ClockState.SimSpeedIndex = SimSpeedIndex;
+	return ClockState;
+}
+
+void UMTGSimTimeSubsystem::RestoreSimClockState(const FMTGSimClockState& ClockState)
+{
+	SimTickNumber = ClockState.SimTickNumber;
+	SimTimeElapsed = ClockState.SimTimeElapsed;
+	ExactSimTime = ClockState.ExactSimTime;
+
+	// The saved speed index may not be valid if SimSpeedOptions config changed since it was saved
+	const int32 NewSimSpeedIndex = FMath::Clamp(ClockState.SimSpeedIndex, 0, SimSpeedOptions.Num() - 1);
+	if (NewSimSpeedIndex != SimSpeedIndex)
+	{
+		SimSpeedIndex = NewSimSpeedIndex;
+		SimTimeDilation = SimSpeedOptions[SimSpeedIndex];
+
+		if (!FMath::IsNearlyEqual(SimTimeDilation, ClockState.SimTimeDilation))
+		{
+			UE_LOG(LogMassTimeGame, Warning, TEXT("Restored sim speed %d is %.6fx, but it was saved as %.6fx"), SimSpeedIndex, SimTimeDilation, ClockState.SimTimeDilation);
+		}
+
+		const UWorld* World = GetWorld();
+		check(World);
+
+		if (AWorldSettings* WorldSettings = World->GetWorldSettings())
+		{
+			WorldSettings->SetTimeDilation(SimTimeDilation);
+		}
+
+		OnTimeDilationChanged.Broadcast(this);
+	}
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Restored sim clock: tick %llu, elapsed %.4f, speed %d (%.3fx)"), SimTickNumber, SimTimeElapsed, SimSpeedIndex, SimTimeDilation);
 }
 
 bool UMTGSimTimeSubsystem::IncreaseSimSpeed()
@@ -227,12 +804,27 @@ bool UMTGSimTimeSubsystem::TogglePlayPause()
 
 bool UMTGSimTimeSubsystem::PauseSimulation()
 {
+	if (IsFastForwarding())
+	{
+		// An explicit pause request aborts the fast forward
+		CancelFastForward();
+	}
+
 	if (IsPaused())
 	{
 		// We're already paused, we don't need to do anything.
 		return true;
 	}
 
+	if (bMassProcessingSuspended)
+	{
+		// The Mass phases are already paused; only the sim clock needs to stop
+		bIsSimPaused = true;
+		OnSimulationPaused.Broadcast(this);
+		ResolveInputLatency(EInputEffect::Paused);
+		return true;
+	}
+
 	const UWorld* World = GetWorld();
 	check(World);
 
@@ -261,6 +853,15 @@ bool UMTGSimTimeSubsystem::ResumeSimulation()
 		return true;
 	}
 
+	if (bMassProcessingSuspended)
+	{
+		// The Mass phases stay paused; only the sim clock needs to run again
+		bIsSimPaused = false;
+		OnSimulationResumed.Broadcast(this);
+		ResolveInputLatency(EInputEffect::Resumed);
+		return true;
+	}
+
 	const UWorld* World = GetWorld();
 	check(World);
 
@@ -281,6 +882,263 @@ bool UMTGSimTimeSubsystem::ResumeSimulation()
 	return true;
 }
 
+bool UMTGSimTimeSubsystem::FastForwardTo(double TargetSimTime)
+{
+	if (IsFastForwarding()
+		|| IsMassProcessingSuspended()
+		|| TargetSimTime <= SimTimeElapsed)
+	{
+		return false;
+	}
+
+	UWorld* World = GetWorld();
+	check(World);
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Fast Forward from %.4f to %.4f"), SimTimeElapsed, TargetSimTime);
+
+	// Remember everything we're about to change
+	PreFastForwardState.bWasPaused = IsPaused();
+	PreFastForwardState.bUsedFixedTimeStep = FApp::UseFixedTimeStep();
+	PreFastForwardState.FixedDeltaTime = FApp::GetFixedDeltaTime();
+
+	// With a fixed time step the engine does not wait for real time to pass, nor does it
+	// honor t.MaxFPS, so frames (and thus sim ticks) run back-to-back as fast as the CPU allows.
+	FApp::SetUseFixedTimeStep(true);
+
+	// VSync would still cap us at the display refresh rate, since Slate keeps presenting the UI
+	if (IConsoleVariable* CVarVSync = IConsoleManager::Get().FindConsoleVariable(TEXT("r.VSync")))
+	{
+		PreFastForwardState.VSync = CVarVSync->GetInt();
+		CVarVSync->Set(0, ECVF_SetByCode);
+	}
+
+	// Stop rendering the world. The UI (and thus the SimControlWidget progress) keeps drawing.
+	if (UGameViewportClient* GameViewport = World->GetGameViewport())
+	{
+		PreFastForwardState.bDisableWorldRendering = GameViewport->bDisableWorldRendering;
+		GameViewport->bDisableWorldRendering = true;
+	}
+
+	// The steps run on the game thread; nothing of the last tick may still be running
+	FlushSimPipeline();
+
+	bIsFastForwarding = true;
+	FastForwardStartTime = SimTimeElapsed;
+	FastForwardTargetTime = TargetSimTime;
+
+	UpdateFastForwardStep();
+
+	// We run the sim ourselves, many steps per frame.  Suspending the Mass phases also
+	// suspends representation and visualization, which would only waste time unrendered.
+	// Until this takes effect, frames tick the sim normally.
+	UMassSimulationSubsystem* MassSimulationSubsystem = World->GetSubsystem<UMassSimulationSubsystem>();
+	if (MassSimulationSubsystem && !MassSimulationSubsystem->IsSimulationPaused())
+	{
+		bSuspendedMassForFastForward = true;
+		MassSimulationSubsystem->PauseSimulation();
+	}
+
+	// Fast forwarding a paused sim would never get anywhere.
+	// EndFastForward will pause it again if needed.
+	if (bIsSimPaused)
+	{
+		bIsSimPaused = false;
+		OnSimulationResumed.Broadcast(this);
+	}
+
+	OnFastForwardStarted.Broadcast(this);
+	return true;
+}
+
+void UMTGSimTimeSubsystem::CancelFastForward()
+{
+	if (IsFastForwarding())
+	{
+		UE_LOG(LogMassTimeGame, Log, TEXT("Fast Forward canceled at %.4f (target %.4f)"), SimTimeElapsed, FastForwardTargetTime);
+		EndFastForward();
+	}
+}
+
+float UMTGSimTimeSubsystem::GetFastForwardProgress() const
+{
+	if (!IsFastForwarding())
+	{
+		return 0.f;
+	}
+
+	const double TotalTime = FastForwardTargetTime - FastForwardStartTime;
+	return FMath::Clamp(static_cast<float>((SimTimeElapsed - FastForwardStartTime) / TotalTime), 0.f, 1.f);
+}
+
+void UMTGSimTimeSubsystem::UpdateFastForwardStep()
+{
+	// Don't overshoot the target; the last step only covers the remaining time
+	const double SimStepSeconds = FMath::Min<double>(FastForwardStepSeconds, FastForwardTargetTime - SimTimeElapsed);
+
+	// The engine will apply the world time dilation to this, so give it the real time equivalent
+	double RealStepSeconds = SimStepSeconds / GetSimTimeDilation();
+
+	// Stay within the range AWorldSettings::FixupDeltaSeconds will allow, else it will clamp us anyway
+	if (const AWorldSettings* WorldSettings = GetWorld()->GetWorldSettings())
+	{
+		RealStepSeconds = FMath::Clamp(RealStepSeconds, WorldSettings->MinUndilatedFrameTime, WorldSettings->MaxUndilatedFrameTime);
+	}
+
+	FApp::SetFixedDeltaTime(RealStepSeconds);
+}
+
+void UMTGSimTimeSubsystem::RunFastForwardSteps()
+{
+	UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntitySubsystem))
+	{
+		CancelFastForward();
+		return;
+	}
+
+	const TSharedRef<FMassEntityManager> EntityManager = EntitySubsystem->GetMutableEntityManager().AsShared();
+
+	if (FastForwardProcessorInstances.Num() == 0)
+	{
+		for (const TSoftClassPtr<UMassProcessor>& ProcessorClass : FastForwardProcessors)
+		{
+			if (UClass* Class = ProcessorClass.LoadSynchronous())
+			{
+				UMassProcessor* Processor = NewObject<UMassProcessor>(this, Class);
+				Processor->CallInitialize(this, EntityManager);
+				FastForwardProcessorInstances.Add(Processor);
+			}
+			else
+			{
+				UE_LOG(LogMassTimeGame, Warning, TEXT("Fast forward processor [%s] not found"), *ProcessorClass.ToString());
+			}
+		}
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGFastForwardSteps);
+
+	const double EndTime = FPlatformTime::Seconds() + FastForwardFrameBudgetMs / 1000.;
+	int32 NumSteps = 0;
+
+	do
+	{
+		// Don't overshoot the target; the last step only covers the remaining time
+		const double StepSeconds = FMath::Min<double>(FastForwardStepSeconds, FastForwardTargetTime - SimTimeElapsed);
+
+		{
+			// Nothing else runs the pipelined processors now, so they must not defer to the sim pipeline
+			TGuardValue<bool> PipelineThreadGuard(UE::MTG::Private::bIsSimPipelineThread, true);
+			FMTGFrameArenaScope ArenaScope(FrameArenas);
+
+			for (UMassProcessor* Processor : FastForwardProcessorInstances)
+			{
+				FMassProcessingContext ProcessingContext(EntityManager, static_cast<float>(StepSeconds));
+				UE::Mass::Executor::Run(*Processor, ProcessingContext);
+			}
+		}
+
+		AdvanceSimClock(StepSeconds);
+		CompleteSimTick();
+
+		// Every step is a tick boundary: wait for the step's readers, then recycle its transient memory
+		FlushSimPipeline();
+		ResetFrameArenas();
+		++NumSteps;
+	}
+	while (IsFastForwarding() && SimTimeElapsed < FastForwardTargetTime && FPlatformTime::Seconds() < EndTime);
+
+	SET_DWORD_STAT(STAT_MTGFastForwardStepsPerFrame, NumSteps);
+
+	if (IsFastForwarding() && SimTimeElapsed >= FastForwardTargetTime)
+	{
+		UE_LOG(LogMassTimeGame, Log, TEXT("Fast Forward reached %.4f (target %.4f) at tick %llu"), SimTimeElapsed, FastForwardTargetTime, SimTickNumber);
+		EndFastForward();
+	}
+}
+
+void UMTGSimTimeSubsystem::EndFastForward()
+{
+	check(IsFastForwarding());
+	bIsFastForwarding = false;
+
+	FApp::SetUseFixedTimeStep(PreFastForwardState.bUsedFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreFastForwardState.FixedDeltaTime);
+
+	if (IConsoleVariable* CVarVSync = IConsoleManager::Get().FindConsoleVariable(TEXT("r.VSync")))
+	{
+		CVarVSync->Set(PreFastForwardState.VSync, ECVF_SetByCode);
+	}
+
+	if (const UWorld* World = GetWorld())
+	{
+		if (UGameViewportClient* GameViewport = World->GetGameViewport())
+		{
+			GameViewport->bDisableWorldRendering = PreFastForwardState.bDisableWorldRendering;
+		}
+	}
+
+	if (PreFastForwardState.bWasPaused)
+	{
+		// Return to the Paused state we were in before fast forwarding.
+		// The Mass phases are still suspended, so we only need to report it again.
+		bIsSimPaused = true;
+		OnSimulationPaused.Broadcast(this);
+	}
+	else if (bSuspendedMassForFastForward && !bMassProcessingSuspended)
+	{
+		if (UMassSimulationSubsystem* MassSimulationSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UMassSimulationSubsystem>() : nullptr)
+		{
+			MassSimulationSubsystem->ResumeSimulation();
+		}
+	}
+	bSuspendedMassForFastForward = false;
+
+	OnFastForwardFinished.Broadcast(this);
+}
+
+void UMTGSimTimeSubsystem::SetMassProcessingSuspended(const bool bSuspended)
+{
+	if (bMassProcessingSuspended == bSuspended)
+	{
+		return;
+	}
+
+	if (bSuspended && IsFastForwarding())
+	{
+		CancelFastForward();
+	}
+
+	UMassSimulationSubsystem* MassSimulationSubsystem = GetWorld()->GetSubsystem<UMassSimulationSubsystem>();
+	if (!ensure(MassSimulationSubsystem))
+	{
+		return;
+	}
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Mass processing %s at tick %llu"), bSuspended ? TEXT("suspended") : TEXT("restored"), SimTickNumber);
+
+	if (bSuspended)
+	{
+		// Nothing of the last tick may still be running once the entities stop being processed
+		FlushSimPipeline();
+
+		bMassProcessingSuspended = true;
+		if (!MassSimulationSubsystem->IsSimulationPaused())
+		{
+			MassSimulationSubsystem->PauseSimulation();
+		}
+	}
+	else
+	{
+		bMassProcessingSuspended = false;
+
+		// A paused sim keeps the Mass phases paused; resuming it later resumes them
+		if (!bIsSimPaused && MassSimulationSubsystem->IsSimulationPaused())
+		{
+			MassSimulationSubsystem->ResumeSimulation();
+		}
+	}
+}
+
 int32 UMTGSimTimeSubsystem::FindApproximateSimSpeedIndex()
 {
 	// Get the closest approximation we can to the current SimTimeDilation value
@@ -299,14 +1157,28 @@ int32 UMTGSimTimeSubsystem::FindApproximateSimSpeedIndex()
 
 void UMTGSimTimeSubsystem::NativeOnSimulationPaused(TNotNull<UMassSimulationSubsystem*> MassSimulationSubsystem)
 {
+	if (IsFastForwarding() || bMassProcessingSuspended)
+	{
+		// Someone suspended the Mass phases while the sim clock keeps running; the sim isn't paused
+		return;
+	}
+
 	// UMassSimulationSubsystem notified us the sim is now paused
 	bIsSimPaused = true;
 	OnSimulationPaused.Broadcast(this);  // Relay this event
+	ResolveInputLatency(EInputEffect::Paused);
 }
 
 void UMTGSimTimeSubsystem::NativeOnSimulationResumed(TNotNull<UMassSimulationSubsystem*> MassSimulationSubsystem)
 {
+	if (IsFastForwarding() || bMassProcessingSuspended || !bIsSimPaused)
+	{
+		// Mass resuming after a fast forward; the sim was already running
+		return;
+	}
+
 	// UMassSimulationSubsystem notified us the sim is now resumed
 	bIsSimPaused = false;
 	OnSimulationResumed.Broadcast(this);  // Relay this event
+	ResolveInputLatency(EInputEffect::Resumed);
 }
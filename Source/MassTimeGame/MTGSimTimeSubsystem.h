@@ -2,11 +2,85 @@
 
 #pragma once
 
+#include "MTGFrameArena.h"
+#include "Engine/EngineBaseTypes.h"
 #include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
 #include "MTGSimTimeSubsystem.generated.h"
 
+class UMassProcessor;
 class UMassSimulationSubsystem;
 
+/**
+ * Exact elapsed sim time: whole microseconds plus a 32 bit fixed-point fraction of a microsecond.
+ *
+ * Every tick's DeltaTime is added as integers, so unlike summing DeltaTime into a
+ * double, the result doesn't lose precision as it grows: after days of sim time it
+ * is still the exact sum of every tick (to 2^-32 us per tick), and it is the same
+ * on every machine that ran the same ticks.
+ */
+struct FMTGExactSimTime
+{
+	uint64 Microseconds = 0;
+	uint32 Fraction = 0;
+
+	/**
+	 * Add one tick's DeltaTime
+	 * @param DeltaSeconds Sim DeltaTime of the tick
+	 */
+	void Advance(double DeltaSeconds);
+
+	/**
+	 * Convert to seconds.  Exact to the microsecond for ~285 years of sim time.
+	 * @return Elapsed sim time in seconds
+	 */
+	double ToSeconds() const;
+
+	/**
+	 * Convert from seconds, e.g. to upgrade a clock that only saved SimTimeElapsed
+	 * @param Seconds Elapsed sim time in seconds
+	 * @return Closest exact sim time
+	 */
+	static FMTGExactSimTime FromSeconds(double Seconds);
+};
+
+/**
+ * A copy of the sim clock, as saved/restored by UMTGSimTimeSubsystem
+ */
+struct FMTGSimClockState
+{
+	uint64 SimTickNumber = 0;
+	double SimTimeElapsed = 0.;
+	FMTGExactSimTime ExactSimTime;
+	float SimTimeDilation = 1.f;
+	int32 SimSpeedIndex = INDEX_NONE;
+};
+
+/**
+ * Player inputs that MTGSimTimeSubsystem applies at sim tick boundaries
+ */
+enum class EMTGSimInput : uint8
+{
+	TogglePlayPause,
+	IncreaseSimSpeed,
+	DecreaseSimSpeed,
+
+	/** Click to move; applied immediately by the controller, only its latency is tracked */
+	SetDestination,
+};
+
+/**
+ * Input-to-effect latency of player inputs made at one sim speed
+ */
+struct FMTGInputLatencyStats
+{
+	int32 NumSamples = 0;
+	double TotalMs = 0.;
+	double MaxMs = 0.;
+
+	double GetAverageMs() const { return NumSamples > 0 ? TotalMs / NumSamples : 0.; }
+};
+
 /**
  * MTG Sim Time Subsystem
  *
@@ -19,6 +93,36 @@ class UMassSimulationSubsystem;
  * need to worry about which subsystem creates that versus the time dilation
  * events, you can just subscribe to all the relevant events here and ignore
  * the use of UMassSimulationSubsystem under the hood.
+ *
+ * Pipelined Simulation (mtg.PipelinedSim):
+ *
+ * The PipelinedProcessors only touch fragments, so instead of running them
+ * inside the frame's Mass phases, they can run on a background task launched
+ * at the end of the frame.  That task overlaps the end of frame work (Slate,
+ * render submission, waiting for the render thread) and is only waited for at
+ * the start of the next world tick, before any Mass phase runs.
+ *
+ * The fragments are the back buffer and the representation (actors/ISMs,
+ * updated inside the Mass phases) is the front buffer: the frame renders the
+ * previous sim tick while the next one is computed.  Every sim tick still
+ * uses its own frame's DeltaTime and behavior still runs before movement, so
+ * only processors ordered after the pipelined ones (i.e. representation) see
+ * a tick of latency.  OnSimTickCompleted moves to the start of the next frame,
+ * once that tick's pipelined work is done.  Pause/resume and speed changes
+ * take effect at these tick boundaries.
+ *
+ * Player Input Priority:
+ *
+ * Player sim inputs (RequestSimInput) are queued and applied at the next
+ * boundary: the start of the world tick, or the start of any Mass processing
+ * phase, whichever comes first.  So a pause pressed while Mass is busy
+ * doesn't wait for the whole frame of processing to finish.  While input is
+ * pending or was just applied, ShouldYieldToInput() is true and deferrable
+ * per-tick work (spawn waves, compaction) waits for the next tick.
+ *
+ * The time from each input to its visible effect (pause/resume callback, or
+ * the next completed sim tick) is measured in real ms, per sim speed, and
+ * logged by mtg.InputLatency.
  */
 UCLASS(Config=MTG, meta=(DisplayName="MTG Sim Time Subsystem"))
 class MASSTIMEGAME_API UMTGSimTimeSubsystem  : public UTickableWorldSubsystem
@@ -28,6 +132,8 @@ class MASSTIMEGAME_API UMTGSimTimeSubsystem  : public UTickableWorldSubsystem
 public:
 	DECLARE_MULTICAST_DELEGATE_OneParam(FOnPauseStateChanged, TNotNull<UMTGSimTimeSubsystem*> /*this*/);
 	DECLARE_MULTICAST_DELEGATE_OneParam(FOnTimeDilationChanged, TNotNull<UMTGSimTimeSubsystem*> /*this*/);
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnFastForwardStateChanged, TNotNull<UMTGSimTimeSubsystem*> /*this*/);
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnSimTickCompleted, TNotNull<UMTGSimTimeSubsystem*> /*this*/);
 
 	/** Delegate broadcast when the simulation enters the Paused state */
 	FOnPauseStateChanged& GetOnSimulationPaused() { return OnSimulationPaused; }
@@ -38,9 +144,85 @@ public:
 	/** Delegate broadcast when the simulation time dilation factor changes */
 	FOnTimeDilationChanged& GetOnTimeDilationChanged() { return OnTimeDilationChanged; }
 
+	/** Delegate broadcast when a FastForwardTo begins */
+	FOnFastForwardStateChanged& GetOnFastForwardStarted() { return OnFastForwardStarted; }
+
+	/** Delegate broadcast when a FastForwardTo ends (either by reaching its target or by being canceled) */
+	FOnFastForwardStateChanged& GetOnFastForwardFinished() { return OnFastForwardFinished; }
+
+	/**
+	 * Delegate broadcast once per non-paused sim tick, after Mass has finished processing
+	 * the frame and SimTickNumber/SimTimeElapsed have been updated.
+	 *
+	 * This is the tick boundary: it's safe to read (and copy) fragment data here.
+	 */
+	FOnSimTickCompleted& GetOnSimTickCompleted() { return OnSimTickCompleted; }
+
 	// Set Class Defaults
 	UMTGSimTimeSubsystem();
 
+	/**
+	 * Should a pipelined processor skip this Execute, since the sim pipeline runs it instead?
+	 * Call at the top of Execute in every PipelinedProcessors class.
+	 * @param World The world being processed
+	 * @return True if the processor must return without doing anything
+	 */
+	static bool IsDeferredToSimPipeline(const UWorld* World);
+
+	/**
+	 * Is this frame's sim tick being computed by the sim pipeline?
+	 * @return True if pipelined, else False
+	 */
+	bool IsSimPipelined() const { return bIsSimPipelined; }
+
+	/**
+	 * Wait for the in-flight pipelined sim tick (and its sim tick readers), if any, and complete it.
+	 * Anything that modifies fragments on the game thread outside of Mass processing
+	 * (e.g. loading a save) must call this first.
+	 */
+	void FlushSimPipeline();
+
+	/**
+	 * Is nothing running off the game thread on the entity manager (no pipelined tick, no sim tick reader)?
+	 * @return True if the game thread may change the entity manager's structure
+	 */
+	bool IsSimPipelineIdle() const;
+
+	/**
+	 * Launch a task that reads the fragments of the sim tick that just ran, off the game thread.
+	 *
+	 * The task starts once the tick's pipelined work (if any) is done, and the next
+	 * FlushSimPipeline waits for it before anything changes the fragments again, so
+	 * it may read chunk memory directly.  Call on the game thread after the sim
+	 * tick's Mass processing and before the next tick boundary (e.g. at world tick end).
+	 *
+	 * @param DebugName Task name
+	 * @param Work Reads the entity manager; MUST NOT change it
+	 * @return The launched task
+	 */
+	UE::Tasks::FTask LaunchSimTickReader(const TCHAR* DebugName, TUniqueFunction<void()>&& Work);
+
+	/**
+	 * Get the per-thread arenas for memory that only lives until the end of the sim tick.
+	 *
+	 * They are reset at every tick boundary, right after FlushSimPipeline.  The sim
+	 * pipeline, sim tick readers and OnSimTickCompleted listeners are already in a
+	 * FMTGFrameArenaScope; anything else (e.g. a Mass processor) opens its own.
+	 *
+	 * @return The frame arenas
+	 */
+	FMTGFrameArenas& GetFrameArenas() { return FrameArenas; }
+
+	/**
+	 * Get a world's frame arenas, for Mass processors to open a FMTGFrameArenaScope with
+	 * @param World The world being processed
+	 * @return The frame arenas, or nullptr if the world has no MTGSimTimeSubsystem
+	 */
+	static FMTGFrameArenas* FindFrameArenas(const UWorld* World);
+
+	/** Log the frame arena counters, including the heap allocations seen since the warm up */
+	void LogFrameArenaStats() const;
+
 	//~Begin UObject interface
 	virtual void PostInitProperties() override;
 	//~End UObject interface
@@ -98,6 +280,25 @@ public:
 	 */
 	double GetSimTimeElapsed() const { return SimTimeElapsed; }
 
+	/**
+	 * Get the exact total sim time elapsed, accumulated in integer units rather than as a double sum.
+	 * Use this for anything that must stay accurate over long runs (days at high sim speed).
+	 * @return Exact total simulation time elapsed
+	 */
+	const FMTGExactSimTime& GetExactSimTime() const { return ExactSimTime; }
+
+	/**
+	 * Get the exact total sim time elapsed, in seconds
+	 * @return Exact total simulation time elapsed
+	 */
+	double GetExactSimTimeSeconds() const { return ExactSimTime.ToSeconds(); }
+
+	/**
+	 * Get how far the double accumulated SimTimeElapsed has drifted from the exact sim time
+	 * @return SimTimeElapsed - exact sim time, in seconds
+	 */
+	double GetSimClockDrift() const { return SimTimeElapsed - ExactSimTime.ToSeconds(); }
+
 	/**
 	 * Get the current sim time dilation factor
 	 *
@@ -109,6 +310,22 @@ public:
 	 */
 	float GetSimTimeDilation() const { return SimTimeDilation; }
 
+	/**
+	 * Get a copy of the current sim clock
+	 * @return Sim tick number, elapsed time, dilation and speed index
+	 */
+	FMTGSimClockState GetSimClockState() const;
+
+	/**
+	 * Restore the sim clock from a previously saved state (e.g. when loading a saved sim).
+	 *
+	 * The speed index is clamped to the currently configured SimSpeedOptions, and the
+	 * world time dilation is updated to match it.
+	 *
+	 * @param ClockState The sim clock state to restore
+	 */
+	void RestoreSimClockState(const FMTGSimClockState& ClockState);
+
 	/**
 	 * Is it possible to increase the sim speed?
 	 * @return True if faster speeds are available, else False
@@ -157,6 +374,95 @@ public:
 	 */
 	bool ResumeSimulation();
 
+	/**
+	 * Queue a player input to be applied at the next tick boundary
+	 * @param Input The input the player made
+	 */
+	void RequestSimInput(EMTGSimInput Input);
+
+	/**
+	 * Should deferrable per-tick work yield this tick, so player input gets the frame time?
+	 * @return True if player input is pending or was applied this frame, else False
+	 */
+	bool ShouldYieldToInput() const { return PendingSimInputs.Num() > 0 || bAppliedSimInputThisFrame; }
+
+	/**
+	 * Get the input-to-effect latency of inputs made at the given sim speed
+	 * @param InSimSpeedIndex SimSpeedOptions index
+	 * @return Latency stats, or nullptr if no input was measured at that speed
+	 */
+	const FMTGInputLatencyStats* GetInputLatencyStats(int32 InSimSpeedIndex) const;
+
+	/** Log the input-to-effect latency of every sim speed */
+	void LogInputLatency() const;
+
+	/**
+	 * Get the number of sim speed options
+	 * @return Number of SimSpeedOptions
+	 */
+	int32 GetNumSimSpeedOptions() const { return SimSpeedOptions.Num(); }
+
+	/**
+	 * Get the dilation of a sim speed option
+	 * @param InSimSpeedIndex SimSpeedOptions index
+	 * @return Sim time dilation of that speed
+	 */
+	float GetSimSpeedOption(int32 InSimSpeedIndex) const { return SimSpeedOptions[InSimSpeedIndex]; }
+
+	/**
+	 * Run the simulation as fast as possible until SimTimeElapsed reaches TargetSimTime.
+	 *
+	 * While fast forwarding, the Mass processing phases are suspended (so no
+	 * representation or visualization processor runs), and every frame this
+	 * subsystem runs as many FastForwardStepSeconds sim steps of the
+	 * FastForwardProcessors as fit in FastForwardFrameBudgetMs.  The engine
+	 * runs with a fixed time step, VSync is disabled and world rendering is
+	 * suspended, so frames don't wait on anything else.  Only the UI stays
+	 * live, so the SimControlWidget can show progress.
+	 *
+	 * When the target is reached, the previous frame timing, rendering and
+	 * Play/Pause state are all restored.
+	 *
+	 * @param TargetSimTime The SimTimeElapsed value to fast forward to
+	 * @return True if the fast forward started, else False (e.g. the target is in the past)
+	 */
+	bool FastForwardTo(double TargetSimTime);
+
+	/**
+	 * Stop a fast forward in progress, restoring the previous state.
+	 * The sim stays at whatever time it had reached.
+	 */
+	void CancelFastForward();
+
+	/**
+	 * Is a FastForwardTo currently in progress?
+	 * @return True if we're fast forwarding, else False
+	 */
+	bool IsFastForwarding() const { return bIsFastForwarding; }
+
+	/**
+	 * Get the progress of the current fast forward
+	 * @return Value in the range 0..1, or 0 if not fast forwarding
+	 */
+	float GetFastForwardProgress() const;
+
+	/**
+	 * Suspend (or restore) the Mass processing phases while the sim clock keeps running.
+	 *
+	 * Used by replay playback: no processor (ours or stock LOD, representation, avoidance)
+	 * touches the entities, yet OnSimTickCompleted still fires every frame with a sim-dilated
+	 * DeltaTime, and pause/speed controls work as usual. Fast forward is unavailable meanwhile.
+	 *
+	 * @param bSuspended True to pause the Mass phases, False to let them run again
+	 */
+	void SetMassProcessingSuspended(bool bSuspended);
+
+	/**
+	 * Are the Mass processing phases suspended by SetMassProcessingSuspended?
+	 * @return True if suspended, else False
+	 */
+	bool IsMassProcessingSuspended() const { return bMassProcessingSuspended; }
+
 protected:
 	/**
 	 * An ordered array of all the possible sim speed settings.
@@ -168,6 +474,31 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
 	TArray<float> SimSpeedOptions;
 
+	/**
+	 * Amount of sim time (seconds) each FastForwardTo sim step advances.
+	 *
+	 * Every fast forward processor sees this as its DeltaTime, so don't make it
+	 * much bigger than a normal frame at the fastest SimSpeedOptions value.
+	 * Throughput comes from running many steps per frame instead.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0.001))
+	float FastForwardStepSeconds;
+
+	/**
+	 * Wall time (ms) per frame spent running FastForwardTo sim steps.
+	 * The rest of the frame keeps the UI (and the progress bar) responsive.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	float FastForwardFrameBudgetMs;
+
+	/**
+	 * Processors run by every FastForwardTo sim step, in execution order, while the Mass
+	 * processing phases are suspended.  This is the whole sim; representation and
+	 * visualization processors deliberately aren't listed, since nothing is rendered.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	TArray<TSoftClassPtr<UMassProcessor>> FastForwardProcessors;
+
 	/**
 	 * Try to find the index in SimSpeedOptions that corresponds to the current SimTimeDilation.
 	 * @return SimSpeedOptions index of the highest value that is <= SimTimeDilation
@@ -186,6 +517,77 @@ protected:
 	 */
 	void NativeOnSimulationResumed(TNotNull<UMassSimulationSubsystem*> MassSimulationSubsystem);
 
+	/**
+	 * Set the fixed DeltaTime the engine will use for the next frame of a fast forward,
+	 * such that a sim tick of that frame does not overshoot FastForwardTargetTime.
+	 */
+	void UpdateFastForwardStep();
+
+	/**
+	 * Run fast forward sim steps until the target or the frame budget is reached.
+	 * Only called once the Mass processing phases are suspended.
+	 */
+	void RunFastForwardSteps();
+
+	/**
+	 * Advance the sim clock by one tick
+	 * @param DeltaTime Sim-dilated DeltaTime of the tick
+	 */
+	void AdvanceSimClock(double DeltaTime);
+
+	/** Restore everything FastForwardTo changed, and broadcast OnFastForwardFinished */
+	void EndFastForward();
+
+	/**
+	 * Processors that run on the sim pipeline when mtg.PipelinedSim is enabled, in execution order.
+	 * They must only read/write fragments and thread safe subsystems, and must call IsDeferredToSimPipeline.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	TArray<TSoftClassPtr<UMassProcessor>> PipelinedProcessors;
+
+	/**
+	 * Callback at the start of every world tick, before any Mass phase
+	 * @param World The world that is about to tick
+	 * @param TickType The type of tick
+	 * @param DeltaSeconds Dilated DeltaTime of this frame
+	 */
+	void NativeOnWorldPreActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/**
+	 * Launch the pipelined processors for the sim tick that just finished on the game thread
+	 * @param DeltaTime Sim DeltaTime of this tick
+	 */
+	void LaunchSimPipeline(float DeltaTime);
+
+	/**
+	 * Callback from UMassSimulationSubsystem at the start of every Mass processing phase
+	 * @param DeltaSeconds DeltaTime of the phase
+	 */
+	void NativeOnProcessingPhaseStarted(float DeltaSeconds);
+
+	/** Apply every queued player input.  MUST be called at a tick boundary. */
+	void ApplyPendingSimInputs();
+
+	/** Broadcast OnSimTickCompleted, and record the latency of inputs waiting for a sim tick */
+	void CompleteSimTick();
+
+	/** Reset the frame arenas at a tick boundary, and publish their stats */
+	void ResetFrameArenas();
+
+	/** What a player input is waiting for before it's visible to the player */
+	enum class EInputEffect : uint8
+	{
+		Paused,
+		Resumed,
+		SimTick,
+	};
+
+	/**
+	 * Record the latency of every input waiting for Effect
+	 * @param Effect The effect that just happened
+	 */
+	void ResolveInputLatency(EInputEffect Effect);
+
 private:
 	/** Is the sim currently paused? */
 	bool bIsSimPaused = false;
@@ -199,12 +601,107 @@ private:
 	/** Total amount of dilated elapsed sim time since the world began play */
 	double SimTimeElapsed = 0.;
 
+	/** Same as SimTimeElapsed, but accumulated exactly */
+	FMTGExactSimTime ExactSimTime;
+
 	/** Current sim time dilation factor */
 	float SimTimeDilation = 1.;
 
 	/** SimSpeedOptions index most closely matching the current SimTimeDilation */
 	int32 SimSpeedIndex = INDEX_NONE;
 
+	/** Is a FastForwardTo currently in progress? */
+	bool bIsFastForwarding = false;
+
+	/** SimTimeElapsed when the current fast forward began */
+	double FastForwardStartTime = 0.;
+
+	/** SimTimeElapsed we are fast forwarding to */
+	double FastForwardTargetTime = 0.;
+
+	/** State that FastForwardTo changed, and which EndFastForward will restore */
+	struct FPreFastForwardState
+	{
+		bool bWasPaused = false;
+		bool bUsedFixedTimeStep = false;
+		double FixedDeltaTime = 0.;
+		int32 VSync = 0;
+		bool bDisableWorldRendering = false;
+	};
+	FPreFastForwardState PreFastForwardState;
+
+	/** Is the sim pipeline computing this frame's tick (decided at the start of the frame)? */
+	bool bIsSimPipelined = false;
+
+	/** Has the current sim tick finished, but not yet been broadcast because its pipelined work is in flight? */
+	bool bIsSimTickCompletionPending = false;
+
+	/** Our own instances of PipelinedProcessors, created the first time the pipeline runs */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UMassProcessor>> PipelineProcessorInstances;
+
+	/** Our own instances of FastForwardProcessors, created the first time a fast forward steps */
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UMassProcessor>> FastForwardProcessorInstances;
+
+	/** Did this fast forward suspend the Mass processing phases (and so must resume them)? */
+	bool bSuspendedMassForFastForward = false;
+
+	/** Has SetMassProcessingSuspended paused the Mass processing phases? */
+	bool bMassProcessingSuspended = false;
+
+	/** The in-flight pipelined sim tick, if any */
+	UE::Tasks::FTask SimPipelineTask;
+
+	/** Tasks reading the last sim tick's fragments, see LaunchSimTickReader */
+	TArray<UE::Tasks::FTask> SimTickReaderTasks;
+
+	/** Transient memory of the current sim tick, see GetFrameArenas */
+	FMTGFrameArenas FrameArenas;
+
+	/** Number of times ResetFrameArenas has run, i.e. tick boundaries seen */
+	int32 NumFrameArenaResets = 0;
+
+	/** Arena blocks allocated as of the previous reset */
+	int32 LastNumArenaBlocksAllocated = 0;
+
+	/** Heap allocations (arena blocks, fallbacks and, with -MTGCountSimAllocs, anything in a scope) made after the warm up */
+	int64 NumSteadyStateHeapAllocs = 0;
+
+	/** Have we already warned about a steady state heap allocation? */
+	bool bWarnedSteadyStateHeapAllocs = false;
+
+	/** Handle of our FWorldDelegates::OnWorldPreActorTick subscription */
+	FDelegateHandle WorldPreActorTickHandle;
+
+	/** A player input, and the real time it was made */
+	struct FTimedSimInput
+	{
+		EMTGSimInput Input = EMTGSimInput::TogglePlayPause;
+		double RequestTime = 0.;
+		int32 SimSpeedIndex = INDEX_NONE;
+	};
+
+	/** Player inputs waiting for the next tick boundary */
+	TArray<FTimedSimInput> PendingSimInputs;
+
+	/** An applied player input that isn't visible to the player yet */
+	struct FAwaitingInputEffect
+	{
+		EInputEffect Effect = EInputEffect::SimTick;
+		double RequestTime = 0.;
+		int32 SimSpeedIndex = INDEX_NONE;
+	};
+
+	/** Applied player inputs waiting for their effect */
+	TArray<FAwaitingInputEffect> AwaitingInputEffects;
+
+	/** Did we apply player input since the start of this world tick? */
+	bool bAppliedSimInputThisFrame = false;
+
+	/** Input-to-effect latency, indexed by the SimSpeedIndex at which the input was made */
+	TArray<FMTGInputLatencyStats> InputLatencyBySpeed;
+
 	/** Delegate broadcast when the simulation enters the Paused state */
 	FOnPauseStateChanged OnSimulationPaused;
 
@@ -213,4 +710,13 @@ private:
 
 	/** Delegate broadcast when the simulation time dilation factor changes */
 	FOnTimeDilationChanged OnTimeDilationChanged;
+
+	/** Delegate broadcast when a FastForwardTo begins */
+	FOnFastForwardStateChanged OnFastForwardStarted;
+
+	/** Delegate broadcast at the end of every non-paused sim tick */
+	FOnSimTickCompleted OnSimTickCompleted;
+
+	/** Delegate broadcast when a FastForwardTo ends */
+	FOnFastForwardStateChanged OnFastForwardFinished;
 };
@@ -0,0 +1,201 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGSoakSubsystem.h"
+
+#include "MassCommonFragments.h"
+#include "MassEntityQuery.h"
+#include "MassEntitySubsystem.h"
+#include "MassTimeGame.h"
+#include "MTGMassFragments.h"
+#include "MTGSimTimeSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+namespace UE::MTG::Soak
+{
+	static constexpr double SecondsPerDay = 24. * 60. * 60.;
+	static constexpr double BytesPerMiB = 1024. * 1024.;
+}
+
+// Set Class Defaults
+UMTGSoakSubsystem::UMTGSoakSubsystem()
+{
+	SampleIntervalSeconds = 3600.f;
+	StepSeconds = 1.f / 30.f;
+}
+
+double UMTGSoakSubsystem::GetSoakDays()
+{
+	double SoakDays = 0.;
+	FParse::Value(FCommandLine::Get(), TEXT("MTGSoakDays="), SoakDays);
+	return FMath::Max(0., SoakDays);
+}
+
+bool UMTGSoakSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	return Super::ShouldCreateSubsystem(Outer) && GetSoakDays() > 0.;
+}
+
+void UMTGSoakSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+	}
+}
+
+void UMTGSoakSubsystem::Deinitialize()
+{
+	if (bIsSoaking)
+	{
+		// FApp fixed time step is global, DO NOT leave it enabled after this world goes away
+		FApp::SetUseFixedTimeStep(bPreviousUseFixedTimeStep);
+		FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+		bIsSoaking = false;
+	}
+
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	Super::Deinitialize();
+}
+
+bool UMTGSoakSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMTGSoakSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (!SimTimeSubsystem)
+	{
+		return;
+	}
+
+	const double SoakDays = GetSoakDays();
+	CsvFilename = FPaths::ProjectSavedDir() / TEXT("MTG") / FString::Printf(TEXT("Soak-%s.csv"), *FDateTime::Now().ToString());
+	FFileHelper::SaveStringToFile(TEXT("RealTimeSeconds,ExactSimTimeSeconds,SimTickNumber,ClockDriftSeconds,UsedPhysicalMiB,NumEntities,AverageTickMs\n"), *CsvFilename);
+
+	StartRealTime = FPlatformTime::Seconds();
+	LastSampleRealTime = StartRealTime;
+	LastSampleTickNumber = SimTimeSubsystem->GetSimTickNumber();
+	NextSampleSimTime = SimTimeSubsystem->GetExactSimTimeSeconds();
+	EndSimTime = NextSampleSimTime + SoakDays * UE::MTG::Soak::SecondsPerDay;
+
+	// The engine will apply the world time dilation to this, so give it the real time equivalent
+	double RealStepSeconds = StepSeconds / SimTimeSubsystem->GetSimTimeDilation();
+
+	// Stay within the range AWorldSettings::FixupDeltaSeconds will allow, else it will clamp us anyway
+	if (const AWorldSettings* WorldSettings = InWorld.GetWorldSettings())
+	{
+		RealStepSeconds = FMath::Clamp(RealStepSeconds, WorldSettings->MinUndilatedFrameTime, WorldSettings->MaxUndilatedFrameTime);
+	}
+
+	// Normal frames, so every Mass phase ticks; with a fixed time step the engine doesn't wait for
+	// real time, so they run back-to-back.  Every frame is one sim tick, so samples land on tick boundaries.
+	bPreviousUseFixedTimeStep = FApp::UseFixedTimeStep();
+	PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(RealStepSeconds);
+	bIsSoaking = true;
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Soak run: %.2f sim days in fixed %.4f s frames (all Mass phases), sampling every %.0f sim seconds to [%s]"),
+		SoakDays, StepSeconds, SampleIntervalSeconds, *CsvFilename);
+
+	SimTimeSubsystem->ResumeSimulation();
+}
+
+void UMTGSoakSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	if (LIKELY(!bIsSoaking || SimTimeSubsystemIn->GetExactSimTimeSeconds() < NextSampleSimTime))
+	{
+		return;
+	}
+
+	if (SimTimeSubsystemIn->GetExactSimTimeSeconds() >= EndSimTime)
+	{
+		FinishSoak();
+		return;
+	}
+
+	TakeSample();
+	NextSampleSimTime = FMath::Min(NextSampleSimTime + SampleIntervalSeconds, EndSimTime);
+}
+
+void UMTGSoakSubsystem::FinishSoak()
+{
+	TakeSample();
+	bIsSoaking = false;
+
+	const double RealSeconds = FPlatformTime::Seconds() - StartRealTime;
+	const double SimSeconds = GetSoakDays() * UE::MTG::Soak::SecondsPerDay;
+	const uint64 NumTicks = SimTimeSubsystem->GetSimTickNumber() - FirstSample.GetValue().SimTickNumber;
+	UE_LOG(LogMassTimeGame, Log, TEXT("Soak run finished after %.1f real minutes: %llu sim ticks at %.3f ms/tick, %.0fx real time"),
+		RealSeconds / 60., NumTicks, NumTicks > 0 ? 1000. * RealSeconds / NumTicks : 0., SimSeconds / FMath::Max(RealSeconds, UE_SMALL_NUMBER));
+	FPlatformMisc::RequestExit(false, TEXT("MTGSoakSubsystem"));
+}
+
+void UMTGSoakSubsystem::TakeSample()
+{
+	using namespace UE::MTG::Soak;
+
+	FMTGSoakSample Sample;
+	Sample.RealTimeSeconds = FPlatformTime::Seconds() - StartRealTime;
+	Sample.ExactSimTimeSeconds = SimTimeSubsystem->GetExactSimTimeSeconds();
+	Sample.SimTickNumber = SimTimeSubsystem->GetSimTickNumber();
+	Sample.ClockDriftSeconds = SimTimeSubsystem->GetSimClockDrift();
+	Sample.UsedPhysicalBytes = FPlatformMemory::GetStats().UsedPhysical;
+
+	if (UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>())
+	{
+		// Parked entities waiting in the recycle pool aren't part of the sim; only a leak of live entities matters here
+		FMassEntityQuery Query(EntitySubsystem->GetMutableEntityManager().AsShared());
+		Query.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+		Query.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+		Sample.NumEntities = Query.GetNumMatchingEntities();
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const uint64 NumTicks = Sample.SimTickNumber - LastSampleTickNumber;
+	Sample.AverageTickMs = NumTicks > 0 ? 1000. * (Now - LastSampleRealTime) / NumTicks : 0.;
+	LastSampleRealTime = Now;
+	LastSampleTickNumber = Sample.SimTickNumber;
+
+	if (!FirstSample.IsSet())
+	{
+		FirstSample = Sample;
+	}
+
+	const FMTGSoakSample& First = FirstSample.GetValue();
+	const double UsedMiB = Sample.UsedPhysicalBytes / BytesPerMiB;
+	const double MemoryGrowthMiB = UsedMiB - First.UsedPhysicalBytes / BytesPerMiB;
+	const double SimDays = Sample.ExactSimTimeSeconds / SecondsPerDay;
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Soak: sim %.3f days (tick %llu), drift %+.6f s | memory %.1f MiB (%+.1f) | entities %d (%+d) | %.3f ms/tick (first %.3f)"),
+		SimDays, Sample.SimTickNumber, Sample.ClockDriftSeconds,
+		UsedMiB, MemoryGrowthMiB,
+		Sample.NumEntities, Sample.NumEntities - First.NumEntities,
+		Sample.AverageTickMs, First.AverageTickMs);
+
+	const FString Line = FString::Printf(TEXT("%.3f,%.6f,%llu,%.9f,%.2f,%d,%.4f\n"),
+		Sample.RealTimeSeconds, Sample.ExactSimTimeSeconds, Sample.SimTickNumber, Sample.ClockDriftSeconds,
+		UsedMiB, Sample.NumEntities, Sample.AverageTickMs);
+	FFileHelper::SaveStringToFile(Line, *CsvFilename, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+}
@@ -0,0 +1,134 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGSoakSubsystem.generated.h"
+
+class UMTGSimTimeSubsystem;
+
+/**
+ * One soak run sample
+ */
+struct FMTGSoakSample
+{
+	double RealTimeSeconds = 0.;
+	double ExactSimTimeSeconds = 0.;
+	uint64 SimTickNumber = 0;
+
+	/** SimTimeElapsed - exact sim time */
+	double ClockDriftSeconds = 0.;
+
+	uint64 UsedPhysicalBytes = 0;
+	int32 NumEntities = 0;
+
+	/** Average real time per sim tick (one whole engine frame) since the previous sample */
+	double AverageTickMs = 0.;
+};
+
+/**
+ * MTG Soak Subsystem
+ *
+ * Unattended long runs to catch slow leaks and degradation.  Run the game with:
+ *
+ *   -nullrhi -MTGSoakDays=3
+ *
+ * The sim runs through that much sim time, then the game exits.
+ * Every SampleIntervalSeconds of sim time it logs (and appends to a CSV in
+ * Saved/MTG) the memory in use, the live entity count (recycled entities
+ * parked in the pool aren't counted), the average real cost per sim tick and
+ * the drift of SimTimeElapsed from the exact sim clock, each with its change
+ * since the first sample.
+ *
+ * The soak runs the normal engine frames, so every Mass processing phase
+ * ticks: LOD, representation, observers and signals are soaked along with
+ * the sim processors (FastForwardTo would only run FastForwardProcessors).
+ * For the duration, FApp uses a fixed time step of StepSeconds of sim time,
+ * and a fixed time step doesn't wait for real time, so frames run
+ * back-to-back as fast as the CPU allows.  The previous FApp settings are
+ * restored when the subsystem goes away.
+ *
+ * Timing: one frame is one sim tick, so the run takes about
+ * SoakDays * 86400 / StepSeconds frames times the logged ms/tick.  With the
+ * default 1/30 s step, 3 days is 7.8M frames, i.e. about 2.2 real hours at
+ * 1 ms/frame.  The final log line reports the measured tick count, ms/tick
+ * and speed relative to real time.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Soak Subsystem"))
+class MASSTIMEGAME_API UMTGSoakSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGSoakSubsystem();
+
+	//~Begin USubsystem interface
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 * Get the soak duration requested on the command line
+	 * @return Sim days to soak, or 0 if this is not a soak run
+	 */
+	static double GetSoakDays();
+
+protected:
+	/** Sim time (seconds) between samples */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	float SampleIntervalSeconds;
+
+	/** Sim time (seconds) of every soak frame; the fixed time step the engine runs at */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=0.001, ForceUnits="s"))
+	float StepSeconds;
+
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/** Take the last sample, log the totals and exit */
+	void FinishSoak();
+
+	/** Take a sample, log it and append it to the CSV */
+	void TakeSample();
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** CSV file the samples are appended to */
+	FString CsvFilename;
+
+	/** First sample of the run; growth is reported relative to it */
+	TOptional<FMTGSoakSample> FirstSample;
+
+	/** Exact sim time of the next sample */
+	double NextSampleSimTime = 0.;
+
+	/** Real time and tick number at the previous sample, to compute the average tick cost */
+	double LastSampleRealTime = 0.;
+	uint64 LastSampleTickNumber = 0;
+
+	/** Real time the soak started */
+	double StartRealTime = 0.;
+
+	/** Exact sim time at which the soak is done */
+	double EndSimTime = 0.;
+
+	/** Has the soak started (and changed the FApp fixed time step)? */
+	bool bIsSoaking = false;
+
+	/** FApp fixed time step settings before the soak, restored in Deinitialize */
+	bool bPreviousUseFixedTimeStep = false;
+	double PreviousFixedDeltaTime = 0.;
+};
@@ -0,0 +1,454 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGSpawnerSubsystem.h"
+
+#include "MassArchetypeData.h"
+#include "MassCommandBuffer.h"
+#include "MassCommands.h"
+#include "MassCommonFragments.h"
+#include "MassEntityConfigAsset.h"
+#include "MassEntityManager.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutionContext.h"
+#include "MassMovementFragments.h"
+#include "MassSpawnerSubsystem.h"
+#include "MassSpawnerTypes.h"
+#include "MassSpawnLocationProcessor.h"
+#include "MassTimeGame.h"
+#include "MTGMassFragments.h"
+#include "MTGRandomSubsystem.h"
+#include "MTGSimTimeSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Spawner"), STAT_MTGSpawner, STATGROUP_MassTimeGame);
+DECLARE_CYCLE_STAT(TEXT("MTG Spawner Flush"), STAT_MTGSpawnerFlush, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Spawn Commands Flushed"), STAT_MTGSpawnCommandsFlushed, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Spawned Recycled"), STAT_MTGSpawnedRecycled, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Spawned Created"), STAT_MTGSpawnedCreated, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Despawned"), STAT_MTGDespawned, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Recycle List Size"), STAT_MTGRecycleListSize, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::Spawner
+{
+	/**
+	 * Set the initial velocity and wander target of spawned entities, if the request has them
+	 * @param FirstIndex Index in the request of Entities[0]
+	 */
+	static void ApplySpawnMotion(FMassEntityManager& EntityManager, const FMTGSpawnRequest& Request, const int32 FirstIndex, TConstArrayView<FMassEntityHandle> Entities)
+	{
+		if (Request.Velocities.Num() == 0)
+		{
+			return;
+		}
+
+		for (int32 Index = 0; Index < Entities.Num(); ++Index)
+		{
+			if (FMassVelocityFragment* Velocity = EntityManager.GetFragmentDataPtr<FMassVelocityFragment>(Entities[Index]))
+			{
+				Velocity->Value = Request.Velocities[FirstIndex + Index];
+			}
+			if (FMTGWanderTargetFragment* WanderTarget = EntityManager.GetFragmentDataPtr<FMTGWanderTargetFragment>(Entities[Index]))
+			{
+				*WanderTarget = Request.WanderTargets[FirstIndex + Index];
+			}
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdSpawnWave(
+		TEXT("mtg.SpawnWave"),
+		TEXT("Spawn a wave of wanderers around the world origin at the next sim tick. Usage: mtg.SpawnWave 10000 [Radius]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UMTGSpawnerSubsystem* SpawnerSubsystem = World ? World->GetSubsystem<UMTGSpawnerSubsystem>() : nullptr;
+			const UMassEntityConfigAsset* EntityConfig = SpawnerSubsystem ? SpawnerSubsystem->GetWandererEntityConfig() : nullptr;
+			if (!EntityConfig || Args.Num() < 1)
+			{
+				return;
+			}
+
+			const int32 Num = FMath::Max(0, FCString::Atoi(*Args[0]));
+			const float Radius = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 10000.f;
+
+			// Seed from the world seed so the same wave gives the same layout on every run
+			const UMTGRandomSubsystem* RandomSubsystem = World->GetSubsystem<UMTGRandomSubsystem>();
+			FRandomStream RandomStream(HashCombineFast(GetTypeHash(RandomSubsystem ? RandomSubsystem->GetWorldSeed() : 0), GetTypeHash(Num)));
+
+			TArray<FTransform> Transforms;
+			Transforms.Reserve(Num);
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				const FVector2D Offset = FVector2D(RandomStream.VRand()).GetSafeNormal() * Radius * FMath::Sqrt(RandomStream.FRand());
+				Transforms.Emplace(FRotator(0., RandomStream.FRandRange(-180., 180.), 0.), FVector(Offset, 0.));
+			}
+
+			SpawnerSubsystem->RequestSpawn(*EntityConfig, Transforms);
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdDespawnWave(
+		TEXT("mtg.DespawnWave"),
+		TEXT("Despawn (recycle) up to N live wanderers at the next sim tick. Usage: mtg.DespawnWave 10000"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UMTGSpawnerSubsystem* SpawnerSubsystem = World ? World->GetSubsystem<UMTGSpawnerSubsystem>() : nullptr;
+			UMassEntitySubsystem* EntitySubsystem = World ? World->GetSubsystem<UMassEntitySubsystem>() : nullptr;
+			const UMassEntityConfigAsset* EntityConfig = SpawnerSubsystem ? SpawnerSubsystem->GetWandererEntityConfig() : nullptr;
+			if (!EntityConfig || !EntitySubsystem || Args.Num() < 1)
+			{
+				return;
+			}
+
+			// Console commands run between frames, while pipelined processors or sim tick readers may still use the chunks
+			if (UMTGSimTimeSubsystem* SimTimeSubsystem = World->GetSubsystem<UMTGSimTimeSubsystem>())
+			{
+				SimTimeSubsystem->FlushSimPipeline();
+			}
+
+			const int32 Num = FMath::Max(0, FCString::Atoi(*Args[0]));
+			FMassEntityManager& EntityManager = EntitySubsystem->GetMutableEntityManager();
+
+			FMassEntityQuery Query(EntityManager.AsShared());
+			Query.AddRequirement<FMTGWanderTargetFragment>(EMassFragmentAccess::ReadOnly);
+			Query.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+
+			TArray<FMassEntityHandle> Entities;
+			FMassExecutionContext ExecutionContext(EntityManager);
+			Query.ForEachEntityChunk(ExecutionContext, [&Entities, Num](FMassExecutionContext& Context)
+			{
+				const int32 NumToTake = FMath::Min(Context.GetNumEntities(), Num - Entities.Num());
+				Entities.Append(Context.GetEntities().Left(NumToTake));
+			});
+
+			SpawnerSubsystem->RequestDespawn(*EntityConfig, Entities);
+		}));
+
+	static FAutoConsoleCommandWithWorld CmdSpawnerStats(
+		TEXT("mtg.SpawnerStats"),
+		TEXT("Log the number of entities waiting in MTGSpawnerSubsystem recycle lists, and their share of all entities"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			const UMTGSpawnerSubsystem* SpawnerSubsystem = World ? World->GetSubsystem<UMTGSpawnerSubsystem>() : nullptr;
+			UMassEntitySubsystem* EntitySubsystem = World ? World->GetSubsystem<UMassEntitySubsystem>() : nullptr;
+			if (SpawnerSubsystem && EntitySubsystem)
+			{
+				// Parked entities are still visited by the stock Mass LOD, representation and avoidance processors
+				FMassEntityQuery Query(EntitySubsystem->GetMutableEntityManager().AsShared());
+				Query.AddRequirement<FTransformFragment>(EMassFragmentAccess::None);
+
+				const int32 NumRecycled = SpawnerSubsystem->GetNumRecycled();
+				const int32 NumEntities = Query.GetNumMatchingEntities();
+				UE_LOG(LogMassTimeGame, Log, TEXT("Recycled entities: %d of %d (%.1f%%)"), NumRecycled, NumEntities, NumEntities > 0 ? 100. * NumRecycled / NumEntities : 0.);
+			}
+		}));
+
+	/** @return Number of entities that fit in one chunk of the archetype, used as the batch size */
+	static int32 GetBatchSize(const FMassArchetypeHandle& ArchetypeHandle)
+	{
+		const FMassArchetypeData* ArchetypeData = FMassArchetypeHelper::ArchetypeDataFromHandle(ArchetypeHandle);
+		return ArchetypeData ? FMath::Max(1, ArchetypeData->GetNumEntitiesPerChunk()) : 1024;
+	}
+}
+
+// Set Class Defaults
+UMTGSpawnerSubsystem::UMTGSpawnerSubsystem()
+{
+	WandererEntityConfig = TSoftObjectPtr<UMassEntityConfigAsset>(FSoftObjectPath(TEXT("/Game/Mass/MEC_Wanderer.MEC_Wanderer")));
+	MaxSpawnsPerTick = 10000;
+	MaxDespawnsPerTick = 10000;
+	ParkingLocation = FVector(0., 0., -1000000.);
+}
+
+void UMTGSpawnerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+	Collection.InitializeDependency<UMassSpawnerSubsystem>();
+	Collection.InitializeDependency<UMTGRandomSubsystem>();
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+	}
+}
+
+void UMTGSpawnerSubsystem::Deinitialize()
+{
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	PendingSpawns.Empty();
+	PendingDespawns.Empty();
+	RecycleLists.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UMTGSpawnerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMTGSpawnerSubsystem::RequestSpawn(const UMassEntityConfigAsset& EntityConfig, TConstArrayView<FTransform> Transforms)
+{
+	if (Transforms.Num() > 0)
+	{
+		FMTGSpawnRequest& Request = PendingSpawns.AddDefaulted_GetRef();
+		Request.EntityConfig = &EntityConfig;
+		Request.Transforms = Transforms;
+	}
+}
+
+void UMTGSpawnerSubsystem::RequestDespawn(const UMassEntityConfigAsset& EntityConfig, TConstArrayView<FMassEntityHandle> Entities)
+{
+	if (Entities.Num() > 0)
+	{
+		FMTGDespawnRequest& Request = PendingDespawns.AddDefaulted_GetRef();
+		Request.EntityConfig = &EntityConfig;
+		Request.Entities = Entities;
+	}
+}
+
+void UMTGSpawnerSubsystem::RequestSpawn(const UMassEntityConfigAsset& EntityConfig, TConstArrayView<FTransform> Transforms, TConstArrayView<FVector> Velocities, TConstArrayView<FMTGWanderTargetFragment> WanderTargets)
+{
+	if (!ensure(Velocities.Num() == Transforms.Num() && WanderTargets.Num() == Transforms.Num()))
+	{
+		return;
+	}
+
+	if (Transforms.Num() > 0)
+	{
+		FMTGSpawnRequest& Request = PendingSpawns.AddDefaulted_GetRef();
+		Request.EntityConfig = &EntityConfig;
+		Request.Transforms = Transforms;
+		Request.Velocities = Velocities;
+		Request.WanderTargets = WanderTargets;
+	}
+}
+
+int32 UMTGSpawnerSubsystem::GetNumRecycled() const
+{
+	int32 NumRecycled = 0;
+	for (const TPair<FMassEntityTemplateID, TArray<FMassEntityHandle>>& Pair : RecycleLists)
+	{
+		NumRecycled += Pair.Value.Num();
+	}
+	return NumRecycled;
+}
+
+void UMTGSpawnerSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	if (PendingSpawns.Num() == 0 && PendingDespawns.Num() == 0)
+	{
+		return;
+	}
+
+	if (SimTimeSubsystemIn->ShouldYieldToInput())
+	{
+		// Waves can wait a tick; player input can't
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGSpawner);
+
+	UMassEntitySubsystem* EntitySubsystem = GetWorld()->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntitySubsystem))
+	{
+		return;
+	}
+
+	FMassEntityManager& EntityManager = EntitySubsystem->GetMutableEntityManager();
+
+	// Despawn first, so a tick that does both can immediately reuse what it just parked
+	int32 NumCommands = ProcessDespawns(EntityManager);
+	NumCommands += ProcessSpawns(EntityManager);
+
+	// One flush applies every tag change of this tick; each one is an archetype move
+	{
+		SCOPE_CYCLE_COUNTER(STAT_MTGSpawnerFlush);
+		EntityManager.FlushCommands();
+	}
+
+	SET_DWORD_STAT(STAT_MTGSpawnCommandsFlushed, NumCommands);
+	SET_DWORD_STAT(STAT_MTGRecycleListSize, GetNumRecycled());
+}
+
+int32 UMTGSpawnerSubsystem::ProcessDespawns(FMassEntityManager& EntityManager)
+{
+	const UWorld* World = GetWorld();
+
+	int32 NumCommands = 0;
+	int32 Budget = MaxDespawnsPerTick;
+	int32 NumDespawned = 0;
+
+	TArray<FMassEntityHandle> Entities;
+
+	int32 RequestIndex = 0;
+	for (; RequestIndex < PendingDespawns.Num() && Budget > 0; ++RequestIndex)
+	{
+		FMTGDespawnRequest& Request = PendingDespawns[RequestIndex];
+		const UMassEntityConfigAsset* EntityConfig = Request.EntityConfig.Get();
+		if (!EntityConfig)
+		{
+			continue;
+		}
+
+		const FMassEntityTemplate& EntityTemplate = EntityConfig->GetOrCreateEntityTemplate(*World);
+		const int32 NumToDespawn = FMath::Min(Budget, Request.Entities.Num() - Request.NumDespawned);
+
+		// Skip entities that are gone or already parked
+		Entities.Reset();
+		for (int32 Index = Request.NumDespawned; Index < Request.NumDespawned + NumToDespawn; ++Index)
+		{
+			const FMassEntityHandle Entity = Request.Entities[Index];
+			if (EntityManager.IsEntityValid(Entity)
+				&& !EntityManager.GetArchetypeComposition(EntityManager.GetArchetypeForEntity(Entity)).Tags.Contains<FMTGRecycledTag>())
+			{
+				Entities.Add(Entity);
+			}
+		}
+
+		Request.NumDespawned += NumToDespawn;
+		Budget -= NumToDespawn;
+
+		// Park them now so they stop affecting density, rendering, etc. even before the tag lands
+		for (const FMassEntityHandle Entity : Entities)
+		{
+			if (FTransformFragment* Transform = EntityManager.GetFragmentDataPtr<FTransformFragment>(Entity))
+			{
+				Transform->GetMutableTransform().SetLocation(ParkingLocation);
+			}
+			if (FMassVelocityFragment* Velocity = EntityManager.GetFragmentDataPtr<FMassVelocityFragment>(Entity))
+			{
+				Velocity->Value = FVector::ZeroVector;
+			}
+			if (FMTGWanderTargetFragment* WanderTarget = EntityManager.GetFragmentDataPtr<FMTGWanderTargetFragment>(Entity))
+			{
+				WanderTarget->bHasDestination = false;
+			}
+		}
+
+		const int32 BatchSize = UE::MTG::Spawner::GetBatchSize(EntityTemplate.GetArchetype());
+		for (int32 Start = 0; Start < Entities.Num(); Start += BatchSize)
+		{
+			const int32 Count = FMath::Min(BatchSize, Entities.Num() - Start);
+			EntityManager.Defer().PushCommand<FMassCommandAddTag<FMTGRecycledTag>>(TConstArrayView<FMassEntityHandle>(Entities.GetData() + Start, Count));
+			++NumCommands;
+		}
+
+		RecycleLists.FindOrAdd(EntityTemplate.GetTemplateID()).Append(Entities);
+		NumDespawned += Entities.Num();
+
+		if (Request.NumDespawned < Request.Entities.Num())
+		{
+			// Out of budget; continue this request next tick
+			break;
+		}
+	}
+	PendingDespawns.RemoveAt(0, RequestIndex, EAllowShrinking::No);
+
+	INC_DWORD_STAT_BY(STAT_MTGDespawned, NumDespawned);
+	return NumCommands;
+}
+
+int32 UMTGSpawnerSubsystem::ProcessSpawns(FMassEntityManager& EntityManager)
+{
+	const UWorld* World = GetWorld();
+	UMassSpawnerSubsystem* SpawnerSubsystem = World->GetSubsystem<UMassSpawnerSubsystem>();
+	if (!ensure(SpawnerSubsystem))
+	{
+		return 0;
+	}
+
+	int32 NumCommands = 0;
+	int32 Budget = MaxSpawnsPerTick;
+	int32 NumRecycled = 0;
+	int32 NumCreated = 0;
+
+	FMassTransformsSpawnData SpawnData;
+	SpawnData.bRandomize = false;
+	TArray<FMassEntityHandle> SpawnedEntities;
+	TArray<FMassEntityHandle> ReusedEntities;
+
+	int32 RequestIndex = 0;
+	for (; RequestIndex < PendingSpawns.Num() && Budget > 0; ++RequestIndex)
+	{
+		FMTGSpawnRequest& Request = PendingSpawns[RequestIndex];
+		const UMassEntityConfigAsset* EntityConfig = Request.EntityConfig.Get();
+		if (!EntityConfig)
+		{
+			continue;
+		}
+
+		const FMassEntityTemplate& EntityTemplate = EntityConfig->GetOrCreateEntityTemplate(*World);
+		const int32 BatchSize = UE::MTG::Spawner::GetBatchSize(EntityTemplate.GetArchetype());
+
+		const int32 NumWanted = FMath::Min(Budget, Request.Transforms.Num() - Request.NumSpawned);
+
+		// 1) Reuse parked entities of the same template
+		if (TArray<FMassEntityHandle>* RecycleList = RecycleLists.Find(EntityTemplate.GetTemplateID()))
+		{
+			ReusedEntities.Reset();
+			while (ReusedEntities.Num() < NumWanted && RecycleList->Num() > 0)
+			{
+				const FMassEntityHandle Entity = RecycleList->Pop(EAllowShrinking::No);
+				if (EntityManager.IsEntityValid(Entity))
+				{
+					ReusedEntities.Add(Entity);
+				}
+			}
+
+			for (int32 Index = 0; Index < ReusedEntities.Num(); ++Index)
+			{
+				const FMassEntityHandle Entity = ReusedEntities[Index];
+				if (FTransformFragment* Transform = EntityManager.GetFragmentDataPtr<FTransformFragment>(Entity))
+				{
+					Transform->SetTransform(Request.Transforms[Request.NumSpawned + Index]);
+				}
+			}
+			UE::MTG::Spawner::ApplySpawnMotion(EntityManager, Request, Request.NumSpawned, ReusedEntities);
+
+			for (int32 Start = 0; Start < ReusedEntities.Num(); Start += BatchSize)
+			{
+				const int32 Count = FMath::Min(BatchSize, ReusedEntities.Num() - Start);
+				EntityManager.Defer().PushCommand<FMassCommandRemoveTag<FMTGRecycledTag>>(TConstArrayView<FMassEntityHandle>(ReusedEntities.GetData() + Start, Count));
+				++NumCommands;
+			}
+
+			Request.NumSpawned += ReusedEntities.Num();
+			NumRecycled += ReusedEntities.Num();
+			Budget -= ReusedEntities.Num();
+		}
+
+		// 2) Create the remainder, one chunk-sized batch at a time
+		const int32 NumToCreate = FMath::Min(Budget, Request.Transforms.Num() - Request.NumSpawned);
+		for (int32 Start = 0; Start < NumToCreate; Start += BatchSize)
+		{
+			const int32 Count = FMath::Min(BatchSize, NumToCreate - Start);
+			SpawnData.Transforms = TArray<FTransform>(Request.Transforms.GetData() + Request.NumSpawned + Start, Count);
+
+			SpawnedEntities.Reset();
+			SpawnerSubsystem->SpawnEntities(EntityTemplate.GetTemplateID(), Count, FConstStructView::Make(SpawnData), UMassSpawnLocationProcessor::StaticClass(), SpawnedEntities);
+			UE::MTG::Spawner::ApplySpawnMotion(EntityManager, Request, Request.NumSpawned + Start, SpawnedEntities);
+		}
+
+		Request.NumSpawned += NumToCreate;
+		NumCreated += NumToCreate;
+		Budget -= NumToCreate;
+
+		if (Request.NumSpawned < Request.Transforms.Num())
+		{
+			// Out of budget; continue this request next tick
+			break;
+		}
+	}
+	PendingSpawns.RemoveAt(0, RequestIndex, EAllowShrinking::No);
+
+	INC_DWORD_STAT_BY(STAT_MTGSpawnedRecycled, NumRecycled);
+	INC_DWORD_STAT_BY(STAT_MTGSpawnedCreated, NumCreated);
+	return NumCommands;
+}
@@ -0,0 +1,178 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassArchetypeTypes.h"
+#include "MassEntityHandle.h"
+#include "MassEntityTemplate.h"
+#include "MTGMassFragments.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGSpawnerSubsystem.generated.h"
+
+class UMassEntityConfigAsset;
+class UMTGSimTimeSubsystem;
+struct FMassEntityManager;
+
+/** A queued MTGSpawnerSubsystem spawn request */
+struct FMTGSpawnRequest
+{
+	TWeakObjectPtr<const UMassEntityConfigAsset> EntityConfig;
+	TArray<FTransform> Transforms;
+
+	/** Optional; if not empty, the initial velocity and wander target of each entity */
+	TArray<FVector> Velocities;
+	TArray<FMTGWanderTargetFragment> WanderTargets;
+
+	/** Number of Transforms already spawned */
+	int32 NumSpawned = 0;
+};
+
+/** A queued MTGSpawnerSubsystem despawn request */
+struct FMTGDespawnRequest
+{
+	/** Config the entities were spawned from; their recycle list is this config's */
+	TWeakObjectPtr<const UMassEntityConfigAsset> EntityConfig;
+	TArray<FMassEntityHandle> Entities;
+
+	/** Number of Entities already despawned */
+	int32 NumDespawned = 0;
+};
+
+/**
+ * MTG Spawner Subsystem
+ *
+ * Batched spawn/despawn for large waves of entities.
+ *
+ * Requests are queued and applied at the next sim tick boundary, at most
+ * MaxSpawnsPerTick/MaxDespawnsPerTick per tick, skipping ticks that yield to
+ * player input:
+ *
+ * - Despawned entities are not destroyed.  They are parked (zero velocity,
+ *   moved to ParkingLocation), tagged FMTGRecycledTag with one deferred
+ *   command per chunk-sized batch, and added to the recycle list of the
+ *   entity template they were spawned from.
+ * - Spawns first reuse entities from the recycle list of the request's
+ *   template (one untag command per batch, and their transform is
+ *   reset), and only create new entities for the remainder, one
+ *   BatchCreateEntities per chunk-sized batch.
+ *
+ * Recycle lists are keyed by template, not archetype: a live entity's
+ * archetype also has the LOD and representation tags Mass added at runtime,
+ * so it never matches the bare template archetype.
+ *
+ * Parking isn't free.  Adding and removing FMTGRecycledTag moves the
+ * entity to another archetype, and while MTG processors skip parked
+ * entities, the stock Mass LOD, representation and avoidance processors
+ * still iterate them.  "MTG Spawner Flush" times the archetype moves, and
+ * mtg.SpawnerStats logs what share of all entities is parked.
+ *
+ * Recycled entities keep their other fragments (e.g. StateTree state); the
+ * wanderer logic treats them like an entity that just arrived somewhere new.
+ *
+ * All commands of a tick are flushed once.  "MTG Spawn Commands Flushed"
+ * counts them per tick.
+ *
+ * mtg.SpawnWave and mtg.DespawnWave generate test waves.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Spawner Subsystem"))
+class MASSTIMEGAME_API UMTGSpawnerSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGSpawnerSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 * Queue entities to spawn at the next sim tick boundary
+	 * @param EntityConfig Config to spawn
+	 * @param Transforms One transform per entity to spawn
+	 */
+	void RequestSpawn(const UMassEntityConfigAsset& EntityConfig, TConstArrayView<FTransform> Transforms);
+
+	/**
+	 * Queue entities to spawn at the next sim tick boundary, already moving (e.g. wanderers arriving from another shard)
+	 * @param EntityConfig Config to spawn
+	 * @param Transforms One transform per entity to spawn
+	 * @param Velocities One initial velocity per entity
+	 * @param WanderTargets One initial wander target per entity
+	 */
+	void RequestSpawn(const UMassEntityConfigAsset& EntityConfig, TConstArrayView<FTransform> Transforms, TConstArrayView<FVector> Velocities, TConstArrayView<FMTGWanderTargetFragment> WanderTargets);
+
+	/**
+	 * Queue entities to despawn (and recycle) at the next sim tick boundary
+	 * @param EntityConfig Config the entities were spawned from
+	 * @param Entities Entities to despawn
+	 */
+	void RequestDespawn(const UMassEntityConfigAsset& EntityConfig, TConstArrayView<FMassEntityHandle> Entities);
+
+	/**
+	 * Get the config used by the test wave console commands
+	 * @return Wanderer entity config, or nullptr if it failed to load
+	 */
+	const UMassEntityConfigAsset* GetWandererEntityConfig() const { return WandererEntityConfig.LoadSynchronous(); }
+
+	/**
+	 * Get the number of entities waiting in recycle lists
+	 * @return Total recycled entities
+	 */
+	int32 GetNumRecycled() const;
+
+protected:
+	/** Entity config used by mtg.SpawnWave */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	TSoftObjectPtr<UMassEntityConfigAsset> WandererEntityConfig;
+
+	/** Maximum entities spawned per sim tick; the rest wait for following ticks */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	int32 MaxSpawnsPerTick;
+
+	/** Maximum entities despawned per sim tick; the rest wait for following ticks */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	int32 MaxDespawnsPerTick;
+
+	/** Where recycled entities are parked; far from anything, so LOD turns off their representation */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	FVector ParkingLocation;
+
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/**
+	 * Apply queued despawns
+	 * @return Number of deferred commands pushed
+	 */
+	int32 ProcessDespawns(FMassEntityManager& EntityManager);
+
+	/**
+	 * Apply queued spawns
+	 * @return Number of deferred commands pushed
+	 */
+	int32 ProcessSpawns(FMassEntityManager& EntityManager);
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** Spawn requests in the order they were made */
+	TArray<FMTGSpawnRequest> PendingSpawns;
+
+	/** Despawn requests in the order they were made */
+	TArray<FMTGDespawnRequest> PendingDespawns;
+
+	/** Parked entities ready for reuse, per the entity template they were spawned from */
+	TMap<FMassEntityTemplateID, TArray<FMassEntityHandle>> RecycleLists;
+};
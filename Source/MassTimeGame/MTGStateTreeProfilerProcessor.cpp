@@ -0,0 +1,192 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGStateTreeProfilerProcessor.h"
+
+#include "MassCommonTypes.h"
+#include "MassExecutionContext.h"
+#include "MassStateTreeFragments.h"
+#include "MassStateTreeProcessors.h"
+#include "MassStateTreeSubsystem.h"
+#include "MassTimeGame.h"
+#include "MTGFrameArena.h"
+#include "MTGMassFragments.h"
+#include "MTGSimTimeSubsystem.h"
+#include "MTGStateTreeUtils.h"
+#include "StateTree.h"
+#include "StateTreeExecutionTypes.h"
+#include "StateTreeInstanceData.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG StateTree Profiler"), STAT_MTGStateTreeProfiler, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::StateTreeProfiler
+{
+	/** Entities per work item when splitting chunks */
+	static constexpr int32 RangeSize = 1024;
+}
+
+// Set Class Defaults
+UMTGStateTreeProfilerBeginProcessor::UMTGStateTreeProfilerBeginProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Behavior;
+	ExecutionOrder.ExecuteBefore.Add(UMassStateTreeProcessor::StaticClass()->GetFName());
+}
+
+void UMTGStateTreeProfilerBeginProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FMTGStateTreeProfileFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddSubsystemRequirement<UMTGStateTreeProfilerSubsystem>(EMassFragmentAccess::ReadWrite);
+}
+
+void UMTGStateTreeProfilerBeginProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	UMTGStateTreeProfilerSubsystem* ProfilerSubsystem = Context.GetMutableSubsystem<UMTGStateTreeProfilerSubsystem>();
+	if (UNLIKELY(ProfilerSubsystem && ProfilerSubsystem->IsProfiling()))
+	{
+		ProfilerSubsystem->MarkStateTreeProcessingStart();
+	}
+}
+
+// Set Class Defaults
+UMTGStateTreeProfilerProcessor::UMTGStateTreeProfilerProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Behavior;
+	ExecutionOrder.ExecuteAfter.Add(UMassStateTreeProcessor::StaticClass()->GetFName());
+}
+
+void UMTGStateTreeProfilerProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FMassStateTreeInstanceFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FMTGStateTreeProfileFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddSharedRequirement<FMassStateTreeSharedFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+	EntityQuery.AddSubsystemRequirement<UMassStateTreeSubsystem>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddSubsystemRequirement<UMTGStateTreeProfilerSubsystem>(EMassFragmentAccess::ReadWrite);
+}
+
+void UMTGStateTreeProfilerProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	using namespace UE::MTG::StateTreeProfiler;
+
+	UMTGStateTreeProfilerSubsystem* ProfilerSubsystem = Context.GetMutableSubsystem<UMTGStateTreeProfilerSubsystem>();
+	if (LIKELY(!ProfilerSubsystem || !ProfilerSubsystem->IsProfiling()))
+	{
+		return;
+	}
+
+	// The StateTree processor has just finished
+	const uint64 StateTreeEndCycles = FPlatformTime::Cycles64();
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGStateTreeProfiler);
+
+	UMassStateTreeSubsystem* StateTreeSubsystem = Context.GetMutableSubsystem<UMassStateTreeSubsystem>();
+	const UStateTree* StateTree = ProfilerSubsystem->GetProfiledStateTree();
+	if (!StateTreeSubsystem || !StateTree)
+	{
+		return;
+	}
+
+	const int32 NumStates = StateTree->GetStates().Num();
+	const uint16 SampleGeneration = ProfilerSubsystem->GetSampleGeneration();
+
+	// UMassStateTreeProcessor stamps every entity it updates with the world time
+	const float TimeSeconds = Context.GetWorld()->GetTimeSeconds();
+
+	// Every scratch array below lives until the next tick boundary at most
+	FMTGFrameArenas* FrameArenas = UMTGSimTimeSubsystem::FindFrameArenas(Context.GetWorld());
+	FMTGFrameArenaScope ArenaScope(FrameArenas);
+
+	TArray<FEntityRange, FMTGFrameArenaAllocator> EntityRanges;
+
+	EntityQuery.ForEachEntityChunk(Context, [&EntityRanges, StateTree](FMassExecutionContext& Context)
+	{
+		if (Context.GetSharedFragment<FMassStateTreeSharedFragment>().StateTree != StateTree)
+		{
+			return;
+		}
+
+		const TConstArrayView<FMassStateTreeInstanceFragment> Instances = Context.GetFragmentView<FMassStateTreeInstanceFragment>();
+		const TArrayView<FMTGStateTreeProfileFragment> Profiles = Context.GetMutableFragmentView<FMTGStateTreeProfileFragment>();
+
+		const int32 NumEntities = Context.GetNumEntities();
+		for (int32 Start = 0; Start < NumEntities; Start += RangeSize)
+		{
+			FEntityRange& Range = EntityRanges.AddDefaulted_GetRef();
+			Range.Instances = &Instances[Start];
+			Range.Profiles = &Profiles[Start];
+			Range.Num = FMath::Min(RangeSize, NumEntities - Start);
+		}
+	});
+
+	// One set of counters per worker; each worker takes every NumWorkers'th range
+	const int32 NumWorkers = FMath::Clamp(FTaskGraphInterface::Get().GetNumWorkerThreads() + 1, 1, FMath::Max(1, EntityRanges.Num()));
+	TArray<TArray<FMTGStateProfile, FMTGFrameArenaAllocator>, FMTGFrameArenaAllocator> PartialProfiles;
+	PartialProfiles.SetNum(NumWorkers);
+
+	ParallelFor(TEXT("MTGStateTreeProfiler"), NumWorkers, 1, [FrameArenas, &EntityRanges, &PartialProfiles, StateTreeSubsystem, StateTree, NumStates, NumWorkers, SampleGeneration, TimeSeconds](int32 WorkerIndex)
+	{
+		FMTGFrameArenaScope WorkerArenaScope(FrameArenas);
+
+		TArray<FMTGStateProfile, FMTGFrameArenaAllocator>& Partial = PartialProfiles[WorkerIndex];
+		Partial.SetNum(NumStates);
+
+		for (int32 RangeIndex = WorkerIndex; RangeIndex < EntityRanges.Num(); RangeIndex += NumWorkers)
+		{
+			const FEntityRange& Range = EntityRanges[RangeIndex];
+			for (int32 Index = 0; Index < Range.Num; ++Index)
+			{
+				const FMassStateTreeInstanceFragment& Instance = Range.Instances[Index];
+				const FStateTreeInstanceData* InstanceData = StateTreeSubsystem->GetInstanceData(Instance.InstanceHandle);
+				const FStateTreeExecutionState* ExecState = InstanceData ? InstanceData->GetExecutionState() : nullptr;
+				if (!ExecState)
+				{
+					continue;
+				}
+
+				const FStateTreeStateHandle Leaf = UE::MTG::StateTreeUtils::GetLeafState(*ExecState, StateTree);
+				if (!Leaf.IsValid() || Leaf.Index >= NumStates)
+				{
+					continue;
+				}
+
+				FMTGStateProfile& State = Partial[Leaf.Index];
+				++State.Occupancy;
+
+				if (Instance.LastUpdateTimeInSeconds == TimeSeconds)
+				{
+					++State.NumTicked;
+				}
+
+				// The change count wraps; uint16 subtraction handles that
+				FMTGStateTreeProfileFragment& Profile = Range.Profiles[Index];
+				if (Profile.SampleGeneration == SampleGeneration)
+				{
+					State.TransitionsIn += static_cast<uint16>(ExecState->StateChangeCount - Profile.LastStateChangeCount);
+				}
+				Profile.LastStateChangeCount = ExecState->StateChangeCount;
+				Profile.SampleGeneration = SampleGeneration;
+			}
+		}
+	});
+
+	// Merge; cost is states x workers, independent of entity count
+	TArray<FMTGStateProfile, FMTGFrameArenaAllocator> States;
+	States.SetNum(NumStates);
+	for (const TArray<FMTGStateProfile, FMTGFrameArenaAllocator>& Partial : PartialProfiles)
+	{
+		for (int32 StateIndex = 0; StateIndex < Partial.Num(); ++StateIndex)
+		{
+			States[StateIndex].Occupancy += Partial[StateIndex].Occupancy;
+			States[StateIndex].TransitionsIn += Partial[StateIndex].TransitionsIn;
+			States[StateIndex].NumTicked += Partial[StateIndex].NumTicked;
+		}
+	}
+
+	ProfilerSubsystem->SubmitTick(States, StateTreeEndCycles);
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassProcessor.h"
+#include "MTGStateTreeProfilerSubsystem.h"
+#include "MTGStateTreeProfilerProcessor.generated.h"
+
+struct FMassStateTreeInstanceFragment;
+struct FMTGStateTreeProfileFragment;
+
+/**
+ * MTG StateTree Profiler Begin Processor
+ *
+ * Marks the time just before UMassStateTreeProcessor runs, so
+ * UMTGStateTreeProfilerProcessor can tell how long it took.
+ */
+UCLASS()
+class MASSTIMEGAME_API UMTGStateTreeProfilerBeginProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGStateTreeProfilerBeginProcessor();
+
+protected:
+	//~Begin UMassProcessor interface
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+	//~End UMassProcessor interface
+
+	FMassEntityQuery EntityQuery;
+};
+
+/**
+ * MTG StateTree Profiler Processor
+ *
+ * Runs right after UMassStateTreeProcessor while mtg.StateTreeProfiler is on.
+ * Reads every profiled entity's active leaf state and StateTree state change
+ * count, and submits the per-state counts to UMTGStateTreeProfilerSubsystem.
+ *
+ * Each worker counts its share of the entities into its own per-state
+ * array, and the arrays are summed once at the end, so there are no atomics
+ * and no shared counters even when every entity is in the same state.
+ */
+UCLASS()
+class MASSTIMEGAME_API UMTGStateTreeProfilerProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGStateTreeProfilerProcessor();
+
+protected:
+	//~Begin UMassProcessor interface
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+	//~End UMassProcessor interface
+
+	FMassEntityQuery EntityQuery;
+
+private:
+	/** A contiguous run of entities, all from the same chunk */
+	struct FEntityRange
+	{
+		const FMassStateTreeInstanceFragment* Instances = nullptr;
+		FMTGStateTreeProfileFragment* Profiles = nullptr;
+		int32 Num = 0;
+	};
+
+};
@@ -0,0 +1,271 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGStateTreeProfilerSubsystem.h"
+
+#include "MassTimeGame.h"
+#include "MTGSimTimeSubsystem.h"
+#include "StateTree.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Trace/Trace.inl"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG StateTree Transitions/Tick"), STAT_MTGStateTreeTransitions, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG StateTree Peak Transitions/Tick"), STAT_MTGStateTreePeakTransitions, STATGROUP_MassTimeGame);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("MTG StateTree Processor (ms)"), STAT_MTGStateTreeCostMs, STATGROUP_MassTimeGame);
+
+UE_TRACE_CHANNEL_DEFINE(MTGStateTreeChannel)
+
+UE_TRACE_EVENT_BEGIN(MTGStateTree, StateSample)
+	UE_TRACE_EVENT_FIELD(uint64, SimTick)
+	UE_TRACE_EVENT_FIELD(uint16, StateIndex)
+	UE_TRACE_EVENT_FIELD(int32, Occupancy)
+	UE_TRACE_EVENT_FIELD(int32, Transitions)
+	UE_TRACE_EVENT_FIELD(float, CostMs)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, StateName)
+UE_TRACE_EVENT_END()
+
+namespace UE::MTG::StateTreeProfiler
+{
+	/** 0 = off, 1 = profile, 2 = profile and show the per-state table on screen */
+	static int32 GProfilerMode = 0;
+	static FAutoConsoleVariableRef CVarProfilerMode(
+		TEXT("mtg.StateTreeProfiler"),
+		GProfilerMode,
+		TEXT("Profile StateTree state occupancy, transitions and cost. 0 = off, 1 = on, 2 = on + on screen table"));
+
+	static FAutoConsoleCommandWithWorld CmdStateTreeProfile(
+		TEXT("mtg.StateTreeProfile"),
+		TEXT("Log the StateTree profile collected since mtg.StateTreeProfiler was enabled"),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			if (const UMTGStateTreeProfilerSubsystem* ProfilerSubsystem = World ? World->GetSubsystem<UMTGStateTreeProfilerSubsystem>() : nullptr)
+			{
+				ProfilerSubsystem->LogSummary();
+			}
+		}));
+
+	/** Base key for the on screen table, one line per state so each replaces itself every tick */
+	static constexpr int32 HUDMessageKey = 0x4D545354;  // "MTST"
+}
+
+// Set Class Defaults
+UMTGStateTreeProfilerSubsystem::UMTGStateTreeProfilerSubsystem()
+{
+}
+
+void UMTGStateTreeProfilerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().AddUObject(this, &ThisClass::NativeOnSimTickCompleted);
+	}
+}
+
+void UMTGStateTreeProfilerSubsystem::Deinitialize()
+{
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimTickCompleted().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	bIsProfiling = false;
+	ProfiledStateTreeAsset = nullptr;
+
+	Super::Deinitialize();
+}
+
+bool UMTGStateTreeProfilerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMTGStateTreeProfilerSubsystem::NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	if (bIsProfiling)
+	{
+		ProfiledSimSeconds += SimTimeSubsystemIn->GetSimDeltaTime();
+	}
+
+	// Only change at the tick boundary, so both profiler processors agree for the whole tick
+	const bool bWantProfiling = UE::MTG::StateTreeProfiler::GProfilerMode > 0;
+	if (LIKELY(bWantProfiling == bIsProfiling))
+	{
+		return;
+	}
+
+	if (bWantProfiling)
+	{
+		ProfiledStateTreeAsset = ProfiledStateTree.LoadSynchronous();
+		if (!ProfiledStateTreeAsset)
+		{
+			UE_LOG(LogMassTimeGame, Warning, TEXT("StateTree profiler: cannot load ProfiledStateTree [%s]"), *ProfiledStateTree.ToString());
+			UE::MTG::StateTreeProfiler::GProfilerMode = 0;
+			return;
+		}
+
+		// New session; 0 is what new entities start with, so never use it
+		if (++SampleGeneration == 0)
+		{
+			++SampleGeneration;
+		}
+
+		Totals.Reset();
+		Totals.SetNum(ProfiledStateTreeAsset->GetStates().Num());
+		LastTick.Reset();
+		NumProfiledTicks = 0;
+		ProfiledSimSeconds = 0.;
+
+		UE_LOG(LogMassTimeGame, Log, TEXT("StateTree profiler enabled for %s (%d states)"), *GetNameSafe(ProfiledStateTreeAsset), Totals.Num());
+	}
+	else
+	{
+		LogSummary();
+	}
+
+	bIsProfiling = bWantProfiling;
+}
+
+void UMTGStateTreeProfilerSubsystem::SubmitTick(const TArrayView<FMTGStateProfile> States, const uint64 StateTreeEndCycles)
+{
+	const double CostMs = StateTreeStartCycles > 0 && StateTreeEndCycles > StateTreeStartCycles
+		? FPlatformTime::ToMilliseconds64(StateTreeEndCycles - StateTreeStartCycles)
+		: 0.;
+	StateTreeStartCycles = 0;
+
+	int32 TotalTicked = 0;
+	int32 TotalTransitions = 0;
+	for (const FMTGStateProfile& State : States)
+	{
+		TotalTicked += State.NumTicked;
+		TotalTransitions += State.TransitionsIn;
+	}
+
+	// The StateTree processor doesn't time states separately; split its time by who it updated
+	const int32 NumStates = FMath::Min(States.Num(), Totals.Num());
+	int32 PeakTransitions = 0;
+	for (int32 StateIndex = 0; StateIndex < NumStates; ++StateIndex)
+	{
+		FMTGStateProfile& State = States[StateIndex];
+		State.CostMs = TotalTicked > 0 ? static_cast<float>(CostMs * State.NumTicked / TotalTicked) : 0.f;
+
+		FStateTotals& StateTotals = Totals[StateIndex];
+		StateTotals.Occupancy += State.Occupancy;
+		StateTotals.Transitions += State.TransitionsIn;
+		StateTotals.PeakTransitionsPerTick = FMath::Max(StateTotals.PeakTransitionsPerTick, State.TransitionsIn);
+		StateTotals.CostMs += State.CostMs;
+
+		PeakTransitions = FMath::Max(PeakTransitions, StateTotals.PeakTransitionsPerTick);
+	}
+
+	++NumProfiledTicks;
+	// Reuses LastTick's allocation; States is the processor's frame arena scratch
+	LastTick.Reset();
+	LastTick.Append(States.GetData(), States.Num());
+
+	SET_DWORD_STAT(STAT_MTGStateTreeTransitions, TotalTransitions);
+	SET_DWORD_STAT(STAT_MTGStateTreePeakTransitions, PeakTransitions);
+	SET_FLOAT_STAT(STAT_MTGStateTreeCostMs, static_cast<float>(CostMs));
+
+	TraceTick();
+
+	if (UE::MTG::StateTreeProfiler::GProfilerMode >= 2)
+	{
+		DrawHUD();
+	}
+}
+
+void UMTGStateTreeProfilerSubsystem::TraceTick() const
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(MTGStateTreeChannel) || !ProfiledStateTreeAsset)
+	{
+		return;
+	}
+
+	const uint64 SimTick = SimTimeSubsystem ? SimTimeSubsystem->GetSimTickNumber() : 0;
+	const TConstArrayView<FCompactStateTreeState> CompactStates = ProfiledStateTreeAsset->GetStates();
+
+	for (int32 StateIndex = 0; StateIndex < LastTick.Num() && StateIndex < CompactStates.Num(); ++StateIndex)
+	{
+		const FMTGStateProfile& State = LastTick[StateIndex];
+		const FString StateName = CompactStates[StateIndex].Name.ToString();
+
+		UE_TRACE_LOG(MTGStateTree, StateSample, MTGStateTreeChannel)
+			<< StateSample.SimTick(SimTick)
+			<< StateSample.StateIndex(static_cast<uint16>(StateIndex))
+			<< StateSample.Occupancy(State.Occupancy)
+			<< StateSample.Transitions(State.TransitionsIn)
+			<< StateSample.CostMs(State.CostMs)
+			<< StateSample.StateName(*StateName, StateName.Len());
+	}
+}
+
+void UMTGStateTreeProfilerSubsystem::DrawHUD() const
+{
+	if (!GEngine || !ProfiledStateTreeAsset)
+	{
+		return;
+	}
+
+	const TConstArrayView<FCompactStateTreeState> CompactStates = ProfiledStateTreeAsset->GetStates();
+	const double InvSimSeconds = ProfiledSimSeconds > 0. ? 1. / ProfiledSimSeconds : 0.;
+
+	// Messages are drawn newest first, so add them in reverse to get the header on top
+	for (int32 StateIndex = LastTick.Num() - 1; StateIndex >= 0; --StateIndex)
+	{
+		if (!CompactStates.IsValidIndex(StateIndex) || !Totals.IsValidIndex(StateIndex))
+		{
+			continue;
+		}
+
+		const FMTGStateProfile& State = LastTick[StateIndex];
+		const FStateTotals& StateTotals = Totals[StateIndex];
+
+		GEngine->AddOnScreenDebugMessage(UE::MTG::StateTreeProfiler::HUDMessageKey + 1 + StateIndex, 0.f, FColor::Cyan,
+			FString::Printf(TEXT("  %-24s %8d %10.1f %8d %8.3f"),
+				*CompactStates[StateIndex].Name.ToString(),
+				State.Occupancy,
+				StateTotals.Transitions * InvSimSeconds,
+				StateTotals.PeakTransitionsPerTick,
+				State.CostMs));
+	}
+
+	GEngine->AddOnScreenDebugMessage(UE::MTG::StateTreeProfiler::HUDMessageKey, 0.f, FColor::White,
+		FString::Printf(TEXT("%s @ %.3fx: %-16s %8s %10s %8s %8s"),
+			*GetNameSafe(ProfiledStateTreeAsset),
+			SimTimeSubsystem ? SimTimeSubsystem->GetSimTimeDilation() : 1.f,
+			TEXT("State"), TEXT("Entities"), TEXT("Trans/SimS"), TEXT("PeakTick"), TEXT("ms")));
+}
+
+void UMTGStateTreeProfilerSubsystem::LogSummary() const
+{
+	if (NumProfiledTicks == 0 || !ProfiledStateTreeAsset)
+	{
+		UE_LOG(LogMassTimeGame, Log, TEXT("StateTree profiler: no data; enable with mtg.StateTreeProfiler 1"));
+		return;
+	}
+
+	const TConstArrayView<FCompactStateTreeState> CompactStates = ProfiledStateTreeAsset->GetStates();
+	const double InvSimSeconds = ProfiledSimSeconds > 0. ? 1. / ProfiledSimSeconds : 0.;
+	const double InvTicks = 1. / NumProfiledTicks;
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("StateTree profile of %s: %lld ticks, %.2f sim seconds"),
+		*GetNameSafe(ProfiledStateTreeAsset), NumProfiledTicks, ProfiledSimSeconds);
+	UE_LOG(LogMassTimeGame, Log, TEXT("  %-24s %12s %12s %10s %12s"),
+		TEXT("State"), TEXT("AvgEntities"), TEXT("Trans/SimS"), TEXT("PeakTick"), TEXT("AvgMs/Tick"));
+
+	for (int32 StateIndex = 0; StateIndex < Totals.Num() && StateIndex < CompactStates.Num(); ++StateIndex)
+	{
+		const FStateTotals& StateTotals = Totals[StateIndex];
+		UE_LOG(LogMassTimeGame, Log, TEXT("  %-24s %12.1f %12.1f %10d %12.4f"),
+			*CompactStates[StateIndex].Name.ToString(),
+			StateTotals.Occupancy * InvTicks,
+			StateTotals.Transitions * InvSimSeconds,
+			StateTotals.PeakTransitionsPerTick,
+			StateTotals.CostMs * InvTicks);
+	}
+}
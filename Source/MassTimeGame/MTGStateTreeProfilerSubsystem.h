@@ -0,0 +1,154 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassExternalSubsystemTraits.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGStateTreeProfilerSubsystem.generated.h"
+
+class UMTGSimTimeSubsystem;
+class UStateTree;
+
+/**
+ * One sim tick worth of profile data for one state
+ */
+struct FMTGStateProfile
+{
+	/** Entities whose active leaf state is this state */
+	int32 Occupancy = 0;
+
+	/** State changes made by entities that ended the tick in this state */
+	int32 TransitionsIn = 0;
+
+	/** Entities in this state that the StateTree processor updated this tick */
+	int32 NumTicked = 0;
+
+	/** Estimated StateTree processor time (ms) spent on entities in this state */
+	float CostMs = 0.f;
+};
+
+/**
+ * MTG StateTree Profiler Subsystem
+ *
+ * Collects the per-state results of UMTGStateTreeProfilerProcessor for the
+ * ProfiledStateTree (ST_Wanderer), once per sim tick:
+ * - how many entities are in each state,
+ * - transitions per sim second into each state, and the peak per tick,
+ *   so bursts of simultaneous transitions at high sim speeds stand out,
+ * - the StateTree processor time per tick, attributed to states by how many
+ *   of the entities it updated were in each state.
+ *
+ * Enable with mtg.StateTreeProfiler 1 (2 also shows the per-state table on
+ * screen).  While enabled, totals are in "stat MassTimeGame", every state of
+ * every tick is emitted on the MTGStateTree trace channel (-trace=MTGStateTree),
+ * and mtg.StateTreeProfile logs the per-state summary.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG StateTree Profiler Subsystem"))
+class MASSTIMEGAME_API UMTGStateTreeProfilerSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGStateTreeProfilerSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 * Is profiling enabled?  Only changes at sim tick boundaries.
+	 * @return True if the profiler processors should run, else False
+	 */
+	bool IsProfiling() const { return bIsProfiling; }
+
+	/**
+	 * Get the current profiling session, so entities sampled in an earlier session aren't counted as transitions
+	 * @return Non-zero session number
+	 */
+	uint16 GetSampleGeneration() const { return SampleGeneration; }
+
+	/**
+	 * Get the StateTree being profiled
+	 * @return ST_Wanderer, or nullptr if it failed to load
+	 */
+	const UStateTree* GetProfiledStateTree() const { return ProfiledStateTreeAsset; }
+
+	/** Called by the profiler processors just before the StateTree processor runs */
+	void MarkStateTreeProcessingStart() { StateTreeStartCycles = FPlatformTime::Cycles64(); }
+
+	/**
+	 * Called by the profiler processor after the StateTree processor, with this tick's merged counts
+	 * @param States Profile of each state, indexed by state index; CostMs is filled in here, then it's copied
+	 * @param StateTreeEndCycles Cycles when the StateTree processor finished
+	 */
+	void SubmitTick(TArrayView<FMTGStateProfile> States, uint64 StateTreeEndCycles);
+
+	/** Log the per-state summary since profiling was enabled */
+	void LogSummary() const;
+
+protected:
+	/** The StateTree whose states are profiled; entities running other trees are ignored */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	TSoftObjectPtr<UStateTree> ProfiledStateTree;
+
+	/**
+	 * Callback from MTGSimTimeSubsystem at the end of every sim tick
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimTickCompleted(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/** Emit the last tick on the trace channel */
+	void TraceTick() const;
+
+	/** Show the last tick on screen */
+	void DrawHUD() const;
+
+private:
+	/** Running totals of one state since profiling was enabled */
+	struct FStateTotals
+	{
+		int64 Occupancy = 0;
+		int64 Transitions = 0;
+		int32 PeakTransitionsPerTick = 0;
+		double CostMs = 0.;
+	};
+
+	/** Saved reference to the MTGSimTimeSubsystem */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** ProfiledStateTree, loaded when profiling starts */
+	UPROPERTY(Transient)
+	TObjectPtr<const UStateTree> ProfiledStateTreeAsset;
+
+	bool bIsProfiling = false;
+	uint16 SampleGeneration = 0;
+
+	/** Cycles at MarkStateTreeProcessingStart, this tick */
+	uint64 StateTreeStartCycles = 0;
+
+	/** The last submitted tick */
+	TArray<FMTGStateProfile> LastTick;
+
+	/** Totals per state since profiling was enabled */
+	TArray<FStateTotals> Totals;
+	int64 NumProfiledTicks = 0;
+	double ProfiledSimSeconds = 0.;
+};
+
+/** The profiler processors only call it from their Execute, never concurrently */
+template<>
+struct TMassExternalSubsystemTraits<UMTGStateTreeProfilerSubsystem> final
+{
+	enum
+	{
+		GameThreadOnly = false,
+		ThreadSafeWrite = false,
+	};
+};
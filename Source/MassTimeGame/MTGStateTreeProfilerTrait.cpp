@@ -0,0 +1,13 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGStateTreeProfilerTrait.h"
+
+#include "MassEntityTemplateRegistry.h"
+#include "MassStateTreeFragments.h"
+#include "MTGMassFragments.h"
+
+void UMTGStateTreeProfilerTrait::BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const
+{
+	BuildContext.RequireFragment<FMassStateTreeInstanceFragment>();
+	BuildContext.AddFragment<FMTGStateTreeProfileFragment>();
+}
@@ -0,0 +1,24 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassEntityTraitBase.h"
+#include "MTGStateTreeProfilerTrait.generated.h"
+
+/**
+ * MTG StateTree Profiler Trait
+ *
+ * Add this to an entity config that also has the Mass StateTree trait (e.g.
+ * MEC_Wanderer) so UMTGStateTreeProfilerProcessor counts its state
+ * occupancy and transitions while mtg.StateTreeProfiler is on.
+ */
+UCLASS(meta=(DisplayName="MTG StateTree Profiler"))
+class MASSTIMEGAME_API UMTGStateTreeProfilerTrait : public UMassEntityTraitBase
+{
+	GENERATED_BODY()
+
+protected:
+	//~Begin UMassEntityTraitBase interface
+	virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+	//~End UMassEntityTraitBase interface
+};
@@ -0,0 +1,22 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGStateTreeUtils.h"
+
+#include "StateTree.h"
+#include "StateTreeExecutionTypes.h"
+
+namespace UE::MTG::StateTreeUtils
+{
+	FStateTreeStateHandle GetLeafState(const FStateTreeExecutionState& ExecState, const UStateTree* StateTree)
+	{
+		for (int32 FrameIndex = ExecState.ActiveFrames.Num() - 1; FrameIndex >= 0; --FrameIndex)
+		{
+			const FStateTreeExecutionFrame& Frame = ExecState.ActiveFrames[FrameIndex];
+			if (Frame.StateTree == StateTree && Frame.ActiveStates.Num() > 0)
+			{
+				return Frame.ActiveStates.Last();
+			}
+		}
+		return FStateTreeStateHandle::Invalid;
+	}
+}
@@ -0,0 +1,22 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FStateTreeExecutionState;
+struct FStateTreeStateHandle;
+class UStateTree;
+
+/**
+ * StateTree helpers shared by anything that reads Mass entities' StateTree
+ * instance data (the StateTree profiler, the transform export, ...).
+ */
+namespace UE::MTG::StateTreeUtils
+{
+	/**
+	 * Find the entity's active leaf state in StateTree
+	 * @return Leaf state handle, or an invalid handle if StateTree isn't active
+	 */
+	MASSTIMEGAME_API FStateTreeStateHandle GetLeafState(const FStateTreeExecutionState& ExecState, const UStateTree* StateTree);
+}
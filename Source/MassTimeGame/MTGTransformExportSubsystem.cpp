@@ -0,0 +1,309 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGTransformExportSubsystem.h"
+
+#include "MassCommonFragments.h"
+#include "MassEntitySubsystem.h"
+#include "MassExecutionContext.h"
+#include "MassMovementFragments.h"
+#include "MassStateTreeFragments.h"
+#include "MassStateTreeSubsystem.h"
+#include "MassTimeGame.h"
+#include "MTGMassFragments.h"
+#include "MTGSimTimeSubsystem.h"
+#include "MTGStateTreeUtils.h"
+#include "StateTreeExecutionTypes.h"
+#include "StateTreeInstanceData.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Transform Export"), STAT_MTGTransformExport, STATGROUP_MassTimeGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("MTG Transform Export Entities"), STAT_MTGTransformExportEntities, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::TransformExport
+{
+	static bool bEnabled = false;
+	static FAutoConsoleVariableRef CVarEnabled(
+		TEXT("mtg.TransformExport"),
+		bEnabled,
+		TEXT("If true, publish every sim tick's wanderer transforms, velocities and states to shared memory"));
+
+	/** Arrays and slots start on their own cache line */
+	static constexpr uint64 Alignment = 64;
+
+	/** What the export task needs to know about the region */
+	struct FSlotTarget
+	{
+		uint8* RegionBase = nullptr;
+		FSlotHeader* Slot = nullptr;
+		uint8* SlotBase = nullptr;
+		int64 NumPublished = 0;
+		int32 MaxEntities = 0;
+	};
+
+	/**
+	 * Copy the wanderers out of their chunks into a slot, then publish it.  Sim tick reader task.
+	 */
+	static void WriteSlot(FMassEntityManager& EntityManager, UMassStateTreeSubsystem* StateTreeSubsystem, const FSlotTarget& Target, const FMTGSimClockState& Clock)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_MTGTransformExport);
+
+		FRegionHeader& Region = *reinterpret_cast<FRegionHeader*>(Target.RegionBase);
+		FSlotHeader& Slot = *Target.Slot;
+
+		// Odd: readers discard anything they copy from this slot until it's even again
+		const int64 Sequence = Slot.Sequence;
+		FPlatformAtomics::AtomicStore(&Slot.Sequence, Sequence + 1);
+
+		FMassEntityHandle* Entities = reinterpret_cast<FMassEntityHandle*>(Target.SlotBase + Region.EntitiesOffset);
+		FTransformFragment* Transforms = reinterpret_cast<FTransformFragment*>(Target.SlotBase + Region.TransformsOffset);
+		FMassVelocityFragment* Velocities = reinterpret_cast<FMassVelocityFragment*>(Target.SlotBase + Region.VelocitiesOffset);
+		uint16* StateIds = reinterpret_cast<uint16*>(Target.SlotBase + Region.StateIdsOffset);
+
+		FMassEntityQuery Query(EntityManager.AsShared());
+		Query.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+		Query.AddRequirement<FMassVelocityFragment>(EMassFragmentAccess::ReadOnly);
+		Query.AddRequirement<FMassStateTreeInstanceFragment>(EMassFragmentAccess::ReadOnly, EMassFragmentPresence::Optional);
+		Query.AddSharedRequirement<FMassStateTreeSharedFragment>(EMassFragmentAccess::ReadOnly, EMassFragmentPresence::Optional);
+		Query.AddRequirement<FMTGWanderTargetFragment>(EMassFragmentAccess::None);
+		Query.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+
+		int32 NumEntities = 0;
+		int32 NumDropped = 0;
+
+		FMassExecutionContext ExecutionContext(EntityManager);
+		Query.ForEachEntityChunk(ExecutionContext, [&](FMassExecutionContext& Context)
+		{
+			const int32 NumInChunk = Context.GetNumEntities();
+			const int32 NumToCopy = FMath::Min(NumInChunk, Target.MaxEntities - NumEntities);
+			NumDropped += NumInChunk - NumToCopy;
+			if (NumToCopy <= 0)
+			{
+				return;
+			}
+
+			// Straight from chunk memory, one bulk copy per fragment array
+			FMemory::Memcpy(Entities + NumEntities, Context.GetEntities().GetData(), NumToCopy * sizeof(FMassEntityHandle));
+			FMemory::Memcpy(Transforms + NumEntities, Context.GetFragmentView<FTransformFragment>().GetData(), NumToCopy * sizeof(FTransformFragment));
+			FMemory::Memcpy(Velocities + NumEntities, Context.GetFragmentView<FMassVelocityFragment>().GetData(), NumToCopy * sizeof(FMassVelocityFragment));
+
+			// StateTree keeps its state outside of the chunk; look up each entity's leaf
+			const TConstArrayView<FMassStateTreeInstanceFragment> Instances = Context.GetFragmentView<FMassStateTreeInstanceFragment>();
+			const FMassStateTreeSharedFragment* StateTreeShared = Context.GetSharedFragmentPtr<FMassStateTreeSharedFragment>();
+			const UStateTree* StateTree = StateTreeShared ? StateTreeShared->StateTree.Get() : nullptr;
+
+			for (int32 Index = 0; Index < NumToCopy; ++Index)
+			{
+				uint16 StateId = InvalidStateId;
+				if (StateTree && StateTreeSubsystem && Instances.Num() > 0)
+				{
+					const FStateTreeInstanceData* InstanceData = StateTreeSubsystem->GetInstanceData(Instances[Index].InstanceHandle);
+					if (const FStateTreeExecutionState* ExecState = InstanceData ? InstanceData->GetExecutionState() : nullptr)
+					{
+						const FStateTreeStateHandle Leaf = UE::MTG::StateTreeUtils::GetLeafState(*ExecState, StateTree);
+						StateId = Leaf.IsValid() ? Leaf.Index : InvalidStateId;
+					}
+				}
+				StateIds[NumEntities + Index] = StateId;
+			}
+
+			NumEntities += NumToCopy;
+		});
+
+		Slot.SimTickNumber = Clock.SimTickNumber;
+		Slot.SimTimeElapsed = Clock.SimTimeElapsed;
+		Slot.SimTimeDilation = Clock.SimTimeDilation;
+		Slot.NumEntities = NumEntities;
+
+		// Even again: the slot is complete, and it's the latest
+		FPlatformAtomics::AtomicStore(&Slot.Sequence, Sequence + 2);
+		FPlatformAtomics::AtomicStore(&Region.NumPublished, Target.NumPublished);
+
+		SET_DWORD_STAT(STAT_MTGTransformExportEntities, NumEntities);
+
+		if (UNLIKELY(NumDropped > 0))
+		{
+			UE_LOG(LogMassTimeGame, Warning, TEXT("Transform export left out %d wanderers at tick %llu; raise MaxEntities"), NumDropped, Clock.SimTickNumber);
+		}
+	}
+}
+
+// Set Class Defaults
+UMTGTransformExportSubsystem::UMTGTransformExportSubsystem()
+{
+	SharedMemoryName = TEXT("MassTimeGameTransforms");
+	MaxEntities = 200000;
+	NumSlots = 2;
+}
+
+void UMTGTransformExportSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UMassEntitySubsystem>();
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required"));
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("MTGTransformExport")))
+	{
+		UE::MTG::TransformExport::bEnabled = true;
+	}
+
+	// After every tickable (including MTGSimTimeSubsystem) has ticked, so the frame's sim tick has run or been launched
+	WorldTickEndHandle = FWorldDelegates::OnWorldTickEnd.AddUObject(this, &ThisClass::NativeOnWorldTickEnd);
+}
+
+void UMTGTransformExportSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickEnd.Remove(WorldTickEndHandle);
+
+	// The export task uses the entity manager, DO NOT let it outlive the world
+	UnmapRegion();
+
+	SimTimeSubsystem = nullptr;
+
+	Super::Deinitialize();
+}
+
+bool UMTGTransformExportSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMTGTransformExportSubsystem::NativeOnWorldTickEnd(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	using namespace UE::MTG::TransformExport;
+
+	if (World != GetWorld() || !SimTimeSubsystem)
+	{
+		return;
+	}
+
+	if (bEnabled != IsExporting())
+	{
+		if (!bEnabled)
+		{
+			UnmapRegion();
+		}
+		else if (!MapRegion())
+		{
+			// Don't retry every frame
+			bEnabled = false;
+		}
+	}
+
+	if (!IsExporting() || SimTimeSubsystem->GetSimTickNumber() == LastExportedTickNumber)
+	{
+		return;
+	}
+
+	UMassEntitySubsystem* EntitySubsystem = World->GetSubsystem<UMassEntitySubsystem>();
+	if (!ensure(EntitySubsystem))
+	{
+		return;
+	}
+
+	// FlushSimPipeline waited for the previous export at this tick's boundary
+	if (!ensure(ExportTask.IsCompleted()))
+	{
+		ExportTask.Wait();
+	}
+
+	const FMTGSimClockState Clock = SimTimeSubsystem->GetSimClockState();
+	LastExportedTickNumber = Clock.SimTickNumber;
+
+	uint8* RegionBase = static_cast<uint8*>(Region->GetAddress());
+	const FRegionHeader& Header = *reinterpret_cast<const FRegionHeader*>(RegionBase);
+
+	FSlotTarget Target;
+	Target.RegionBase = RegionBase;
+	Target.SlotBase = RegionBase + Header.FirstSlotOffset + (NumWritten % NumSlots) * Header.SlotSize;
+	Target.Slot = reinterpret_cast<FSlotHeader*>(Target.SlotBase);
+	Target.NumPublished = ++NumWritten;
+	Target.MaxEntities = MaxEntities;
+
+	const TSharedRef<FMassEntityManager> EntityManager = EntitySubsystem->GetMutableEntityManager().AsShared();
+	UMassStateTreeSubsystem* StateTreeSubsystem = World->GetSubsystem<UMassStateTreeSubsystem>();
+
+	// Deinitialize waits for the task, so the subsystem pointer outlives it
+	ExportTask = SimTimeSubsystem->LaunchSimTickReader(TEXT("MTGTransformExport"), [EntityManager, StateTreeSubsystem, Target, Clock]()
+	{
+		WriteSlot(*EntityManager, StateTreeSubsystem, Target, Clock);
+	});
+}
+
+bool UMTGTransformExportSubsystem::MapRegion()
+{
+	using namespace UE::MTG::TransformExport;
+
+	check(!Region);
+
+	FRegionHeader Header;
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.NumSlots = NumSlots;
+	Header.MaxEntities = MaxEntities;
+	Header.TransformStride = sizeof(FTransformFragment);
+	Header.VelocityStride = sizeof(FMassVelocityFragment);
+
+	uint64 SlotSize = Align(sizeof(FSlotHeader), Alignment);
+	Header.EntitiesOffset = SlotSize;
+	SlotSize = Align(SlotSize + MaxEntities * sizeof(FMassEntityHandle), Alignment);
+	Header.TransformsOffset = SlotSize;
+	SlotSize = Align(SlotSize + MaxEntities * sizeof(FTransformFragment), Alignment);
+	Header.VelocitiesOffset = SlotSize;
+	SlotSize = Align(SlotSize + MaxEntities * sizeof(FMassVelocityFragment), Alignment);
+	Header.StateIdsOffset = SlotSize;
+	SlotSize = Align(SlotSize + MaxEntities * sizeof(uint16), Alignment);
+
+	Header.SlotSize = SlotSize;
+	Header.FirstSlotOffset = Align(sizeof(FRegionHeader), Alignment);
+
+	const uint64 RegionSize = Header.FirstSlotOffset + NumSlots * SlotSize;
+
+	Region = FPlatformMemory::MapNamedSharedMemoryRegion(SharedMemoryName, true,
+		FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write, RegionSize);
+
+	if (!Region)
+	{
+		UE_LOG(LogMassTimeGame, Error, TEXT("Cannot create transform export shared memory [%s] (%llu bytes)"), *SharedMemoryName, RegionSize);
+		return false;
+	}
+
+	// Readers check Magic; zero everything else first so they never see a half written header
+	uint8* RegionBase = static_cast<uint8*>(Region->GetAddress());
+	FMemory::Memzero(RegionBase, Header.FirstSlotOffset);
+	for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+	{
+		new (RegionBase + Header.FirstSlotOffset + SlotIndex * SlotSize) FSlotHeader();
+	}
+
+	const uint32 HeaderMagic = Header.Magic;
+	Header.Magic = 0;
+	FMemory::Memcpy(RegionBase, &Header, sizeof(FRegionHeader));
+	FPlatformMisc::MemoryBarrier();
+	reinterpret_cast<FRegionHeader*>(RegionBase)->Magic = HeaderMagic;
+
+	NumWritten = 0;
+	LastExportedTickNumber = MAX_uint64;
+
+	UE_LOG(LogMassTimeGame, Log, TEXT("Transform export started: [%s], %d slots of %d wanderers, %.1f MB"), *SharedMemoryName, NumSlots, MaxEntities, RegionSize / (1024. * 1024.));
+	return true;
+}
+
+void UMTGTransformExportSubsystem::UnmapRegion()
+{
+	ExportTask.Wait();
+	ExportTask = {};
+
+	if (Region)
+	{
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+		Region = nullptr;
+
+		UE_LOG(LogMassTimeGame, Log, TEXT("Transform export stopped after %lld ticks"), NumWritten);
+	}
+}
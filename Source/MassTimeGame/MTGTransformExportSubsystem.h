@@ -0,0 +1,168 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tasks/Task.h"
+#include "MTGTransformExportSubsystem.generated.h"
+
+class UMTGSimTimeSubsystem;
+
+/**
+ * Layout of the shared memory region written by UMTGTransformExportSubsystem.
+ * External readers map it read-only; everything is little endian.
+ */
+namespace UE::MTG::TransformExport
+{
+	/** FRegionHeader::Magic, "MTGX" */
+	inline constexpr uint32 Magic = 0x5847544D;
+
+	/** FRegionHeader::Version; bumped whenever the layout changes */
+	inline constexpr uint32 Version = 1;
+
+	/** StateIds entry of an entity with no active StateTree state */
+	inline constexpr uint16 InvalidStateId = MAX_uint16;
+
+	/**
+	 * Start of the region.  Written once when the region is created, except NumPublished.
+	 */
+	struct FRegionHeader
+	{
+		uint32 Magic = 0;
+		uint32 Version = 0;
+
+		/** Number of slots in the ring */
+		uint32 NumSlots = 0;
+
+		/** Capacity of each slot's arrays */
+		uint32 MaxEntities = 0;
+
+		/** Byte offset of slot 0 from the start of the region, and bytes per slot */
+		uint64 FirstSlotOffset = 0;
+		uint64 SlotSize = 0;
+
+		/** Byte offset of each array from the start of its slot */
+		uint64 EntitiesOffset = 0;
+		uint64 TransformsOffset = 0;
+		uint64 VelocitiesOffset = 0;
+		uint64 StateIdsOffset = 0;
+
+		/** Bytes per Transforms / Velocities entry; readers should check them */
+		uint32 TransformStride = 0;
+		uint32 VelocityStride = 0;
+
+		/** Number of slots published so far; the latest is slot (NumPublished - 1) % NumSlots */
+		volatile int64 NumPublished = 0;
+	};
+
+	/**
+	 * Start of each slot, followed by its arrays:
+	 *
+	 * - Entities: FMassEntityHandle (int32 Index, int32 SerialNumber)
+	 * - Transforms: FTransformFragment, i.e. FTransform as doubles: rotation XYZW, translation XYZ + pad, scale XYZ + pad
+	 * - Velocities: FMassVelocityFragment, i.e. XYZ doubles (cm/s)
+	 * - StateIds: uint16 active leaf state index of the entity's StateTree, or InvalidStateId
+	 */
+	struct FSlotHeader
+	{
+		/**
+		 * Odd while the slot is being written.  Readers read it before and after
+		 * copying the slot, and discard the copy if it was odd or has changed.
+		 */
+		volatile int64 Sequence = 0;
+
+		uint64 SimTickNumber = 0;
+		double SimTimeElapsed = 0.;
+		float SimTimeDilation = 1.f;
+
+		/** Number of valid entries in each array */
+		uint32 NumEntities = 0;
+	};
+}
+
+/**
+ * MTG Transform Export Subsystem
+ *
+ * Publishes every sim tick's wanderer transforms, velocities and StateTree
+ * state to a named shared memory region (/dev/shm/<SharedMemoryName> on
+ * Linux), for external analysis tools.
+ *
+ * The region is a ring of NumSlots slots, tagged with the sim tick number,
+ * elapsed sim time and dilation.  After each sim tick, a sim tick reader
+ * task (UMTGSimTimeSubsystem::LaunchSimTickReader) copies the fragment
+ * arrays straight out of chunk memory into the next slot, then publishes it.
+ * While it writes one slot, readers read the others.
+ *
+ * Readers only map the region; nothing is sent to them and nobody waits for
+ * them, so the game thread cost (launching one task per tick) is the same
+ * with any number of readers.  A reader that falls NumSlots ticks behind
+ * sees a slot's Sequence change under it and must retry with the latest.
+ *
+ * Toggle it with mtg.TransformExport, or start with -MTGTransformExport.
+ */
+UCLASS(Config=MTG, meta=(DisplayName="MTG Transform Export Subsystem"))
+class MASSTIMEGAME_API UMTGTransformExportSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	UMTGTransformExportSubsystem();
+
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 * Is the shared memory region mapped and being written?
+	 * @return True if exporting, else False
+	 */
+	bool IsExporting() const { return Region != nullptr; }
+
+protected:
+	/** Name of the shared memory region */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config)
+	FString SharedMemoryName;
+
+	/** Capacity of each slot; any more wanderers than this are left out */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=1))
+	int32 MaxEntities;
+
+	/** Number of slots in the ring; 2 is double buffered */
+	UPROPERTY(EditDefaultsOnly, Category="Xist", Config, meta=(ClampMin=2))
+	int32 NumSlots;
+
+	/** Callback at the end of every world tick; exports the sim tick that just ran */
+	void NativeOnWorldTickEnd(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	/** Create the shared memory region and write its header */
+	bool MapRegion();
+
+	/** Wait for the last export, then release the shared memory region */
+	void UnmapRegion();
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** The mapped region, if exporting */
+	FPlatformMemory::FSharedMemoryRegion* Region = nullptr;
+
+	/** Number of slots written, including the one ExportTask is writing */
+	int64 NumWritten = 0;
+
+	/** Sim tick last exported; a frame without a new tick (e.g. paused) exports nothing */
+	uint64 LastExportedTickNumber = MAX_uint64;
+
+	/** The in-flight export, if any */
+	UE::Tasks::FTask ExportTask;
+
+	/** Handle of our FWorldDelegates::OnWorldTickEnd subscription */
+	FDelegateHandle WorldTickEndHandle;
+};
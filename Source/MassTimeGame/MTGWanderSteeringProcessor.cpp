@@ -0,0 +1,473 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGWanderSteeringProcessor.h"
+
+#include "MassCommonFragments.h"
+#include "MassCommonTypes.h"
+#include "MassEntityManager.h"
+#include "MassExecutionContext.h"
+#include "MassExecutor.h"
+#include "MassMovementFragments.h"
+#include "MassMovementProcessors.h"
+#include "MassNavigationFragments.h"
+#include "MassNavigationProcessors.h"
+#include "MassNavigationSubsystem.h"
+#include "MassTimeGame.h"
+#include "MTGCostHeatmapSubsystem.h"
+#include "MTGCrowdDensityProcessor.h"
+#include "MTGCrowdDensitySubsystem.h"
+#include "MTGFrameArena.h"
+#include "MTGMassFragments.h"
+#include "MTGSimTimeSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "Avoidance/MassAvoidanceFragments.h"
+#include "Avoidance/MassAvoidanceProcessors.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Math/VectorRegister.h"
+#include "Steering/MassSteeringFragments.h"
+#include "Steering/MassSteeringProcessors.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Wander Steering"), STAT_MTGWanderSteering, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::WanderSteering
+{
+	static int32 BatchSize = 512;
+	static FAutoConsoleVariableRef CVarBatchSize(
+		TEXT("mtg.WanderSteering.BatchSize"),
+		BatchSize,
+		TEXT("Number of entities per parallel work item in UMTGWanderSteeringProcessor"));
+
+	static bool bParallel = true;
+	static FAutoConsoleVariableRef CVarParallel(
+		TEXT("mtg.WanderSteering.Parallel"),
+		bParallel,
+		TEXT("If true, UMTGWanderSteeringProcessor spreads its batches over worker threads"));
+
+	/** Entities deinterleaved per SIMD block; must be a multiple of 4 */
+	static constexpr int32 BlockSize = 64;
+
+	/** Avoid divide by zero for entities that are exactly at their destination or stopped */
+	static constexpr float Epsilon = UE_KINDA_SMALL_NUMBER;
+
+	void SteerAndIntegrate(const FEntityRange& Range, const float DeltaTime)
+	{
+		const FMTGWanderSteeringParameters& Parameters = *Range.Parameters;
+
+		const FMTGCrowdDensityGrid* DensityGrid = Range.DensityGrid;
+		const bool bAvoid = DensityGrid && DensityGrid->Num() > 0 && Parameters.DensityAvoidanceStrength > 0.f;
+
+		// Cell indices are computed in float, which is exact below 2^24 cells
+		checkSlow(!bAvoid || DensityGrid->Num() < (1 << 24));
+
+		const VectorRegister4Float Zero = VectorZeroFloat();
+		const VectorRegister4Float One = VectorOneFloat();
+		const VectorRegister4Float Eps = VectorSetFloat1(Epsilon);
+		const VectorRegister4Float MaxSpeed = VectorSetFloat1(Parameters.MaxSpeed);
+		const VectorRegister4Float MaxDeltaSpeed = VectorSetFloat1(Parameters.MaxAcceleration * DeltaTime);
+		const VectorRegister4Float ArriveGain = VectorSetFloat1(Parameters.MaxSpeed / FMath::Max(Parameters.SlowdownRadius, 1.f));
+
+		// Density grid constants. The gradient is a central difference over 2 cells, per cm; the strength
+		// is per cell, so the CellSize cancels out and avoidance is the density difference * -Strength/2.
+		const FVector2D GridOrigin = bAvoid ? DensityGrid->Origin : FVector2D::ZeroVector;
+		const double InvCellSize = bAvoid ? 1. / DensityGrid->CellSize : 0.;
+		const float* Density = bAvoid ? DensityGrid->Density.GetData() : nullptr;
+		const VectorRegister4Float AvoidanceScale = VectorSetFloat1(-0.5f * Parameters.DensityAvoidanceStrength);
+		const VectorRegister4Float NumCellsX = VectorSetFloat1(bAvoid ? static_cast<float>(DensityGrid->NumX) : 0.f);
+		const VectorRegister4Float NumCellsY = VectorSetFloat1(bAvoid ? static_cast<float>(DensityGrid->NumY) : 0.f);
+		const VectorRegister4Float MaxCellX = VectorSubtract(NumCellsX, One);
+		const VectorRegister4Float MaxCellY = VectorSubtract(NumCellsY, One);
+
+		// SoA scratch: offset to destination, location in grid cells and velocity, in the XY plane
+		alignas(16) float DX[BlockSize];
+		alignas(16) float DY[BlockSize];
+		alignas(16) float GX[BlockSize];
+		alignas(16) float GY[BlockSize];
+		alignas(16) float VX[BlockSize];
+		alignas(16) float VY[BlockSize];
+
+		// SoA scratch for avoidance: neighbour cell indices, their densities, and the per-entity avoidance scale
+		alignas(16) int32 LeftCell[BlockSize];
+		alignas(16) int32 RightCell[BlockSize];
+		alignas(16) int32 DownCell[BlockSize];
+		alignas(16) int32 UpCell[BlockSize];
+		alignas(16) float LeftDensity[BlockSize];
+		alignas(16) float RightDensity[BlockSize];
+		alignas(16) float DownDensity[BlockSize];
+		alignas(16) float UpDensity[BlockSize];
+		alignas(16) float AvoidanceWeight[BlockSize];
+
+		for (int32 Start = 0; Start < Range.Num; Start += BlockSize)
+		{
+			const int32 Count = FMath::Min(BlockSize, Range.Num - Start);
+			const int32 PaddedCount = Align(Count, 4);
+
+			// Deinterleave. The subtractions are done in double so large world coordinates don't lose precision.
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				const FVector Location = Range.Transforms[Start + Index].GetTransform().GetLocation();
+				const FMTGWanderTargetFragment& Target = Range.Targets[Start + Index];
+				const FVector& Velocity = Range.Velocities[Start + Index].Value;
+
+				// No destination means seek our own location, i.e. brake to a stop
+				const FVector Offset = Target.bHasDestination ? Target.Destination - Location : FVector::ZeroVector;
+
+				DX[Index] = static_cast<float>(Offset.X);
+				DY[Index] = static_cast<float>(Offset.Y);
+				GX[Index] = static_cast<float>((Location.X - GridOrigin.X) * InvCellSize);
+				GY[Index] = static_cast<float>((Location.Y - GridOrigin.Y) * InvCellSize);
+				VX[Index] = static_cast<float>(Velocity.X);
+				VY[Index] = static_cast<float>(Velocity.Y);
+			}
+
+			// Pad the tail with stopped entities at their destination; their results are discarded
+			for (int32 Index = Count; Index < PaddedCount; ++Index)
+			{
+				DX[Index] = DY[Index] = GX[Index] = GY[Index] = VX[Index] = VY[Index] = 0.f;
+			}
+
+			if (bAvoid)
+			{
+				// Find the 4 neighbour cells of each entity, 4 entities at a time
+				for (int32 Index = 0; Index < PaddedCount; Index += 4)
+				{
+					const VectorRegister4Float CellX = VectorFloor(VectorLoadAligned(&GX[Index]));
+					const VectorRegister4Float CellY = VectorFloor(VectorLoadAligned(&GY[Index]));
+
+					// Entities outside the grid get no avoidance, like FMTGCrowdDensityGrid::GetDensityGradient
+					const VectorRegister4Float InsideMask = VectorBitwiseAnd(
+						VectorBitwiseAnd(VectorCompareGE(CellX, Zero), VectorCompareLT(CellX, NumCellsX)),
+						VectorBitwiseAnd(VectorCompareGE(CellY, Zero), VectorCompareLT(CellY, NumCellsY)));
+					VectorStoreAligned(VectorSelect(InsideMask, AvoidanceScale, Zero), &AvoidanceWeight[Index]);
+
+					// Neighbours are clamped at the grid border (one-sided difference). Clamping the cell
+					// itself first keeps the indices of entities outside the grid in range too.
+					const VectorRegister4Float X = VectorMin(VectorMax(CellX, Zero), MaxCellX);
+					const VectorRegister4Float Y = VectorMin(VectorMax(CellY, Zero), MaxCellY);
+					const VectorRegister4Float Row = VectorMultiply(Y, NumCellsX);
+					const VectorRegister4Float RowDown = VectorMultiply(VectorMax(VectorSubtract(Y, One), Zero), NumCellsX);
+					const VectorRegister4Float RowUp = VectorMultiply(VectorMin(VectorAdd(Y, One), MaxCellY), NumCellsX);
+
+					VectorIntStoreAligned(VectorFloatToInt(VectorAdd(Row, VectorMax(VectorSubtract(X, One), Zero))), &LeftCell[Index]);
+					VectorIntStoreAligned(VectorFloatToInt(VectorAdd(Row, VectorMin(VectorAdd(X, One), MaxCellX))), &RightCell[Index]);
+					VectorIntStoreAligned(VectorFloatToInt(VectorAdd(RowDown, X)), &DownCell[Index]);
+					VectorIntStoreAligned(VectorFloatToInt(VectorAdd(RowUp, X)), &UpCell[Index]);
+				}
+
+				// Gather the neighbour densities into SoA lanes; SSE/NEON have no gather, so this is the only per-entity loop
+				for (int32 Index = 0; Index < PaddedCount; ++Index)
+				{
+					LeftDensity[Index] = Density[LeftCell[Index]];
+					RightDensity[Index] = Density[RightCell[Index]];
+					DownDensity[Index] = Density[DownCell[Index]];
+					UpDensity[Index] = Density[UpCell[Index]];
+				}
+			}
+
+			for (int32 Index = 0; Index < PaddedCount; Index += 4)
+			{
+				const VectorRegister4Float OffsetX = VectorLoadAligned(&DX[Index]);
+				const VectorRegister4Float OffsetY = VectorLoadAligned(&DY[Index]);
+				VectorRegister4Float VelocityX = VectorLoadAligned(&VX[Index]);
+				VectorRegister4Float VelocityY = VectorLoadAligned(&VY[Index]);
+
+				// Arrive: full speed until within SlowdownRadius, then slow down linearly
+				const VectorRegister4Float Distance = VectorSqrt(VectorMultiplyAdd(OffsetX, OffsetX, VectorMultiply(OffsetY, OffsetY)));
+				const VectorRegister4Float DesiredSpeed = VectorMin(MaxSpeed, VectorMultiply(Distance, ArriveGain));
+				const VectorRegister4Float DesiredScale = VectorDivide(DesiredSpeed, VectorMax(Distance, Eps));
+
+				VectorRegister4Float DesiredX = VectorMultiply(OffsetX, DesiredScale);
+				VectorRegister4Float DesiredY = VectorMultiply(OffsetY, DesiredScale);
+
+				// Crowd avoidance: push down the density gradient
+				if (bAvoid)
+				{
+					const VectorRegister4Float Weight = VectorLoadAligned(&AvoidanceWeight[Index]);
+					DesiredX = VectorMultiplyAdd(VectorSubtract(VectorLoadAligned(&RightDensity[Index]), VectorLoadAligned(&LeftDensity[Index])), Weight, DesiredX);
+					DesiredY = VectorMultiplyAdd(VectorSubtract(VectorLoadAligned(&UpDensity[Index]), VectorLoadAligned(&DownDensity[Index])), Weight, DesiredY);
+				}
+
+				// Steer toward the desired velocity, limited by acceleration
+				const VectorRegister4Float SteerX = VectorSubtract(DesiredX, VelocityX);
+				const VectorRegister4Float SteerY = VectorSubtract(DesiredY, VelocityY);
+				const VectorRegister4Float SteerLength = VectorSqrt(VectorMultiplyAdd(SteerX, SteerX, VectorMultiply(SteerY, SteerY)));
+				const VectorRegister4Float SteerScale = VectorMin(One, VectorDivide(MaxDeltaSpeed, VectorMax(SteerLength, Eps)));
+
+				VelocityX = VectorMultiplyAdd(SteerX, SteerScale, VelocityX);
+				VelocityY = VectorMultiplyAdd(SteerY, SteerScale, VelocityY);
+
+				// Clamp speed
+				const VectorRegister4Float Speed = VectorSqrt(VectorMultiplyAdd(VelocityX, VelocityX, VectorMultiply(VelocityY, VelocityY)));
+				const VectorRegister4Float SpeedScale = VectorMin(One, VectorDivide(MaxSpeed, VectorMax(Speed, Eps)));
+
+				VectorStoreAligned(VectorMultiply(VelocityX, SpeedScale), &VX[Index]);
+				VectorStoreAligned(VectorMultiply(VelocityY, SpeedScale), &VY[Index]);
+			}
+
+			// Write back and integrate
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				const FVector NewVelocity(VX[Index], VY[Index], 0.);
+				Range.Velocities[Start + Index].Value = NewVelocity;
+				Range.Transforms[Start + Index].GetMutableTransform().AddToTranslation(NewVelocity * DeltaTime);
+			}
+		}
+	}
+
+	/**
+	 * Time UMTGWanderSteeringProcessor against the stock Mass movement path over the same entities, and log the results.
+	 *
+	 * The entities live in a scratch entity manager, so the world's processors never see them and the
+	 * benchmarked processors never see the world's entities.  Every processor runs through UE::Mass::Executor
+	 * with the world's subsystems, exactly as it would in a Mass phase:
+	 *  - Stock: UMassNavigationObstacleGridProcessor, UMassSteerToMoveTargetProcessor,
+	 *    UMassMovingAvoidanceProcessor and UMassApplyMovementProcessor.  The obstacle grid update that the
+	 *    stock avoidance needs is also logged on its own.
+	 *  - MTG: UMTGWanderSteeringProcessor, single threaded and with ParallelFor.  It samples the live crowd
+	 *    density grid; the density grid build is UMTGCrowdDensityProcessor's cost and isn't included.
+	 */
+	static void RunBenchmark(UWorld& World, const int32 NumEntities, const int32 NumIterations)
+	{
+		constexpr float DeltaTime = 1.f / 60.f;
+		FRandomStream RandomStream(NumEntities);
+
+		const TSharedRef<FMassEntityManager> EntityManager = MakeShareable(new FMassEntityManager(&World));
+		EntityManager->Initialize();
+
+		// Both paths get the same speed and acceleration
+		const FMTGWanderSteeringParameters Parameters;
+		FMassMovementParameters MovementParameters;
+		MovementParameters.MaxSpeed = Parameters.MaxSpeed;
+		MovementParameters.MaxAcceleration = Parameters.MaxAcceleration;
+
+		FMassArchetypeSharedFragmentValues SharedValues;
+		SharedValues.AddConstSharedFragment(EntityManager->GetOrCreateConstSharedFragment(Parameters));
+		SharedValues.AddConstSharedFragment(EntityManager->GetOrCreateConstSharedFragment(MovementParameters));
+		SharedValues.AddConstSharedFragment(EntityManager->GetOrCreateConstSharedFragment(FMassMovingSteeringParameters()));
+		SharedValues.AddConstSharedFragment(EntityManager->GetOrCreateConstSharedFragment(FMassStandingSteeringParameters()));
+		SharedValues.AddConstSharedFragment(EntityManager->GetOrCreateConstSharedFragment(FMassMovingAvoidanceParameters()));
+		SharedValues.AddConstSharedFragment(EntityManager->GetOrCreateConstSharedFragment(FMassStandingAvoidanceParameters()));
+		SharedValues.Sort();
+
+		// Everything the stock movement traits and the MTG Wander Steering trait add
+		const FMassArchetypeHandle Archetype = EntityManager->CreateArchetype({
+			FTransformFragment::StaticStruct(),
+			FAgentRadiusFragment::StaticStruct(),
+			FMassVelocityFragment::StaticStruct(),
+			FMassForceFragment::StaticStruct(),
+			FMassDesiredMovementFragment::StaticStruct(),
+			FMassMoveTargetFragment::StaticStruct(),
+			FMassGhostLocationFragment::StaticStruct(),
+			FMassSteeringFragment::StaticStruct(),
+			FMassStandingSteeringFragment::StaticStruct(),
+			FMassNavigationEdgesFragment::StaticStruct(),
+			FMassNavigationObstacleGridCellLocationFragment::StaticStruct(),
+			FMTGWanderTargetFragment::StaticStruct(),
+			FMTGWanderSteeringParameters::StaticStruct(),
+			FMassMovementParameters::StaticStruct(),
+			FMassMovingSteeringParameters::StaticStruct(),
+			FMassStandingSteeringParameters::StaticStruct(),
+			FMassMovingAvoidanceParameters::StaticStruct(),
+			FMassStandingAvoidanceParameters::StaticStruct()});
+
+		TArray<FMassEntityHandle> Entities;
+		EntityManager->BatchCreateEntities(Archetype, SharedValues, NumEntities, Entities);
+
+		// Same random crowd for every run: spread over the density grid, each heading somewhere else on it
+		auto ResetEntities = [&]()
+		{
+			RandomStream.Reset();
+			for (const FMassEntityHandle Entity : Entities)
+			{
+				const FVector Location(RandomStream.FRandRange(-50000., 50000.), RandomStream.FRandRange(-50000., 50000.), 0.);
+				const FVector Velocity(RandomStream.FRandRange(-200., 200.), RandomStream.FRandRange(-200., 200.), 0.);
+				const FVector Destination(RandomStream.FRandRange(-50000., 50000.), RandomStream.FRandRange(-50000., 50000.), 0.);
+
+				EntityManager->GetFragmentDataChecked<FTransformFragment>(Entity).GetMutableTransform().SetLocation(Location);
+				EntityManager->GetFragmentDataChecked<FMassVelocityFragment>(Entity).Value = Velocity;
+				EntityManager->GetFragmentDataChecked<FMassForceFragment>(Entity).Value = FVector::ZeroVector;
+				EntityManager->GetFragmentDataChecked<FAgentRadiusFragment>(Entity).Radius = 40.f;
+
+				FMTGWanderTargetFragment& Target = EntityManager->GetFragmentDataChecked<FMTGWanderTargetFragment>(Entity);
+				Target.Destination = Destination;
+				Target.bHasDestination = true;
+
+				FMassMoveTargetFragment& MoveTarget = EntityManager->GetFragmentDataChecked<FMassMoveTargetFragment>(Entity);
+				MoveTarget.CreateNewAction(EMassMovementAction::Move, World);
+				MoveTarget.Center = Destination;
+				MoveTarget.Forward = (Destination - Location).GetSafeNormal();
+				MoveTarget.DistanceToGoal = static_cast<float>(FVector::Dist(Location, Destination));
+				MoveTarget.DesiredSpeed.Set(Parameters.MaxSpeed);
+				MoveTarget.IntentAtGoal = EMassMovementAction::Stand;
+			}
+		};
+
+		auto CreateProcessor = [&World, &EntityManager](UClass* Class)
+		{
+			UMassProcessor* Processor = NewObject<UMassProcessor>(&World, Class);
+			Processor->CallInitialize(&World, EntityManager);
+			return Processor;
+		};
+
+		UMassProcessor* ObstacleGridProcessor = CreateProcessor(UMassNavigationObstacleGridProcessor::StaticClass());
+		const TArray<UMassProcessor*> StockProcessors = {
+			ObstacleGridProcessor,
+			CreateProcessor(UMassSteerToMoveTargetProcessor::StaticClass()),
+			CreateProcessor(UMassMovingAvoidanceProcessor::StaticClass()),
+			CreateProcessor(UMassApplyMovementProcessor::StaticClass())};
+		UMassProcessor* SteeringProcessor = CreateProcessor(UMTGWanderSteeringProcessor::StaticClass());
+
+		auto TimeMs = [&](const TConstArrayView<UMassProcessor*> Processors, const TCHAR* Name, const bool bMovesEntities) -> double
+		{
+			ResetEntities();
+			const FVector FirstLocation = Entities.Num() > 0 ? EntityManager->GetFragmentDataChecked<FTransformFragment>(Entities[0]).GetTransform().GetLocation() : FVector::ZeroVector;
+
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+			{
+				for (UMassProcessor* Processor : Processors)
+				{
+					FMassProcessingContext ProcessingContext(EntityManager, DeltaTime);
+					UE::Mass::Executor::Run(*Processor, ProcessingContext);
+				}
+			}
+			const double ElapsedMs = 1000. * (FPlatformTime::Seconds() - StartTime) / NumIterations;
+
+			// A processor whose query doesn't match the benchmark archetype would time as free
+			if (bMovesEntities && Entities.Num() > 0 && EntityManager->GetFragmentDataChecked<FTransformFragment>(Entities[0]).GetTransform().GetLocation().Equals(FirstLocation))
+			{
+				UE_LOG(LogMassTimeGame, Warning, TEXT("MTGBench WanderSteering: the %s path didn't move the benchmark entities; its timing is meaningless"), Name);
+			}
+			return ElapsedMs;
+		};
+
+		const double StockGridMs = TimeMs({ObstacleGridProcessor}, TEXT("stock obstacle grid"), false);
+		const double StockMs = TimeMs(StockProcessors, TEXT("stock"), true);
+
+		const bool bWasParallel = bParallel;
+		bParallel = false;
+		const double SerialMs = TimeMs({SteeringProcessor}, TEXT("MTG"), true);
+		bParallel = true;
+		const double ParallelMs = TimeMs({SteeringProcessor}, TEXT("MTG parallel"), true);
+		bParallel = bWasParallel;
+
+		UE_LOG(LogMassTimeGame, Display, TEXT("MTGBench WanderSteering Entities=%d BatchSize=%d StockMs=%.4f (ObstacleGridMs=%.4f) MTGMs=%.4f MTGParallelMs=%.4f Speedup=%.2fx ParallelSpeedup=%.2fx"),
+			NumEntities, FMath::Max(1, BatchSize), StockMs, StockGridMs, SerialMs, ParallelMs,
+			StockMs / FMath::Max(SerialMs, UE_SMALL_NUMBER), StockMs / FMath::Max(ParallelMs, UE_SMALL_NUMBER));
+
+		// The obstacle grid belongs to the world's UMassNavigationSubsystem; take our entities back out of it
+		if (UMassNavigationSubsystem* NavigationSubsystem = World.GetSubsystem<UMassNavigationSubsystem>())
+		{
+			for (const FMassEntityHandle Entity : Entities)
+			{
+				FMassNavigationObstacleItem ObstacleItem;
+				ObstacleItem.Entity = Entity;
+				NavigationSubsystem->GetObstacleGridMutable().Remove(ObstacleItem, EntityManager->GetFragmentDataChecked<FMassNavigationObstacleGridCellLocationFragment>(Entity).CellLoc);
+			}
+		}
+
+		EntityManager->BatchDestroyEntities(Entities);
+		EntityManager->Deinitialize();
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs CmdBenchWanderSteering(
+		TEXT("mtg.BenchWanderSteering"),
+		TEXT("Benchmark UMTGWanderSteeringProcessor against the stock Mass steering, avoidance and movement processors. Usage: mtg.BenchWanderSteering [NumIterations]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			UMTGSimTimeSubsystem* SimTimeSubsystem = World ? World->GetSubsystem<UMTGSimTimeSubsystem>() : nullptr;
+			if (!SimTimeSubsystem)
+			{
+				return;
+			}
+
+			// The pipelined sim reads the density grid we sample, and would make UMTGWanderSteeringProcessor skip its game thread Execute
+			SimTimeSubsystem->FlushSimPipeline();
+			if (SimTimeSubsystem->IsSimPipelined())
+			{
+				UE_LOG(LogMassTimeGame, Warning, TEXT("mtg.BenchWanderSteering needs mtg.PipelinedSim 0"));
+				return;
+			}
+
+			const int32 NumIterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100;
+			RunBenchmark(*World, 10000, NumIterations);
+			RunBenchmark(*World, 100000, NumIterations);
+		}));
+}
+
+// Set Class Defaults
+UMTGWanderSteeringProcessor::UMTGWanderSteeringProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+	ExecutionOrder.ExecuteInGroup = UE::Mass::ProcessorGroupNames::Movement;
+	ExecutionOrder.ExecuteAfter.Add(UMTGCrowdDensityProcessor::StaticClass()->GetFName());
+}
+
+void UMTGWanderSteeringProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMassVelocityFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMTGWanderTargetFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddConstSharedRequirement<FMTGWanderSteeringParameters>();
+	EntityQuery.AddTagRequirement<FMTGRecycledTag>(EMassFragmentPresence::None);
+	EntityQuery.AddSubsystemRequirement<UMTGCrowdDensitySubsystem>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddSubsystemRequirement<UMTGCostHeatmapSubsystem>(EMassFragmentAccess::ReadWrite);
+}
+
+void UMTGWanderSteeringProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	using namespace UE::MTG::WanderSteering;
+
+	if (UMTGSimTimeSubsystem::IsDeferredToSimPipeline(Context.GetWorld()))
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGWanderSteering);
+
+	// Every scratch array below lives until the next tick boundary at most
+	FMTGFrameArenas* FrameArenas = UMTGSimTimeSubsystem::FindFrameArenas(Context.GetWorld());
+	FMTGFrameArenaScope ArenaScope(FrameArenas);
+
+	const int32 RangeSize = FMath::Max(1, BatchSize);
+	TArray<FEntityRange, FMTGFrameArenaAllocator> EntityRanges;
+
+	const UMTGCrowdDensitySubsystem* DensitySubsystem = Context.GetSubsystem<UMTGCrowdDensitySubsystem>();
+	const FMTGCrowdDensityGrid* DensityGrid = DensitySubsystem ? &DensitySubsystem->GetGrid() : nullptr;
+
+	// Gather the chunks' fragment arrays. There are no structural changes during Execute,
+	// so the views stay valid until we're done with them below.
+	EntityQuery.ForEachEntityChunk(Context, [&EntityRanges, RangeSize, DensityGrid](FMassExecutionContext& Context)
+	{
+		const TArrayView<FTransformFragment> Transforms = Context.GetMutableFragmentView<FTransformFragment>();
+		const TArrayView<FMassVelocityFragment> Velocities = Context.GetMutableFragmentView<FMassVelocityFragment>();
+		const TConstArrayView<FMTGWanderTargetFragment> Targets = Context.GetFragmentView<FMTGWanderTargetFragment>();
+		const FMTGWanderSteeringParameters& Parameters = Context.GetConstSharedFragment<FMTGWanderSteeringParameters>();
+
+		const int32 NumEntities = Context.GetNumEntities();
+		for (int32 Start = 0; Start < NumEntities; Start += RangeSize)
+		{
+			FEntityRange& Range = EntityRanges.AddDefaulted_GetRef();
+			Range.Transforms = &Transforms[Start];
+			Range.Velocities = &Velocities[Start];
+			Range.Targets = &Targets[Start];
+			Range.Parameters = &Parameters;
+			Range.DensityGrid = DensityGrid;
+			Range.Num = FMath::Min(RangeSize, NumEntities - Start);
+		}
+	});
+
+	const float DeltaTime = Context.GetDeltaTimeSeconds();
+	UMTGCostHeatmapSubsystem* Heatmap = Context.GetMutableSubsystem<UMTGCostHeatmapSubsystem>();
+
+	ParallelFor(TEXT("MTGWanderSteering"), EntityRanges.Num(), 1, [FrameArenas, &EntityRanges, DeltaTime, Heatmap](int32 RangeIndex)
+	{
+		FMTGFrameArenaScope WorkerArenaScope(FrameArenas);
+
+		const FEntityRange& Range = EntityRanges[RangeIndex];
+		FMTGCostSampleScope CostSample(Heatmap, TConstArrayView<FTransformFragment>(Range.Transforms, Range.Num));
+		SteerAndIntegrate(Range, DeltaTime);
+	}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+}
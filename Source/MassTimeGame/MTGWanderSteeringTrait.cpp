@@ -0,0 +1,20 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGWanderSteeringTrait.h"
+
+#include "MassCommonFragments.h"
+#include "MassEntityTemplateRegistry.h"
+#include "MassEntityUtils.h"
+#include "MassMovementFragments.h"
+
+void UMTGWanderSteeringTrait::BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const
+{
+	FMassEntityManager& EntityManager = UE::Mass::Utils::GetEntityManagerChecked(World);
+
+	BuildContext.RequireFragment<FTransformFragment>();
+	BuildContext.AddFragment<FMassVelocityFragment>();
+	BuildContext.AddFragment<FMTGWanderTargetFragment>();
+
+	const FConstSharedStruct ParametersFragment = EntityManager.GetOrCreateConstSharedFragment(Parameters);
+	BuildContext.AddConstSharedFragment(ParametersFragment);
+}
@@ -0,0 +1,30 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "MassEntityTraitBase.h"
+#include "MTGMassFragments.h"
+#include "MTGWanderSteeringTrait.generated.h"
+
+/**
+ * MTG Wander Steering Trait
+ *
+ * Moves the entity with UMTGWanderSteeringProcessor: seek/arrive toward its
+ * FMTGWanderTargetFragment, with speed and acceleration limits.
+ *
+ * Use this INSTEAD of the stock steering/movement traits; an entity with both
+ * would be moved twice per tick.
+ */
+UCLASS(meta=(DisplayName="MTG Wander Steering"))
+class MASSTIMEGAME_API UMTGWanderSteeringTrait : public UMassEntityTraitBase
+{
+	GENERATED_BODY()
+
+protected:
+	//~Begin UMassEntityTraitBase interface
+	virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+	//~End UMassEntityTraitBase interface
+
+	UPROPERTY(EditAnywhere, Category="Movement")
+	FMTGWanderSteeringParameters Parameters;
+};
@@ -0,0 +1,115 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGWandererActor.h"
+
+#include "MTGActorPoolSubsystem.h"
+#include "MTGWandererAnimSubsystem.h"
+#include "Engine/World.h"
+
+// Set Class Defaults
+AMTGWandererActor::AMTGWandererActor()
+{
+	// Blueprint subclasses may tick; we just don't need to at the C++ level
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
+void AMTGWandererActor::PostActorCreated()
+{
+	Super::PostActorCreated();
+
+	// This is the earliest hook during SpawnActor; BeginPlay is the end of it
+	SpawnStartTime = FPlatformTime::Seconds();
+}
+
+void AMTGWandererActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!bIsPrewarmed)
+	{
+		// The representation had to spawn this actor on demand, which means the pool was empty
+		if (UMTGActorPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<UMTGActorPoolSubsystem>(GetWorld()))
+		{
+			PoolSubsystem->RecordPoolMiss(FPlatformTime::Seconds() - SpawnStartTime);
+		}
+	}
+
+	// Pre-warmed actors go straight into the pool, which unregisters them again
+	if (UMTGWandererAnimSubsystem* AnimSubsystem = UWorld::GetSubsystem<UMTGWandererAnimSubsystem>(GetWorld()))
+	{
+		AnimSubsystem->RegisterActor(this);
+	}
+}
+
+void AMTGWandererActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UMTGWandererAnimSubsystem* AnimSubsystem = UWorld::GetSubsystem<UMTGWandererAnimSubsystem>(GetWorld()))
+	{
+		AnimSubsystem->UnregisterActor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool AMTGWandererActor::CanBePooled_Implementation()
+{
+	return true;
+}
+
+void AMTGWandererActor::PrepareForPooling_Implementation()
+{
+	DeactivateForPool();
+
+	if (UMTGActorPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<UMTGActorPoolSubsystem>(GetWorld()))
+	{
+		PoolSubsystem->RecordPoolRelease();
+	}
+}
+
+void AMTGWandererActor::PrepareForGame_Implementation()
+{
+	ActivateFromPool();
+
+	if (UMTGActorPoolSubsystem* PoolSubsystem = UWorld::GetSubsystem<UMTGActorPoolSubsystem>(GetWorld()))
+	{
+		PoolSubsystem->RecordPoolHit();
+	}
+}
+
+void AMTGWandererActor::DeactivateForPool()
+{
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+
+	// Components tick independently of the actor (e.g. the skeletal mesh anim)
+	for (UActorComponent* Component : GetComponents())
+	{
+		Component->SetComponentTickEnabled(false);
+	}
+
+	if (UMTGWandererAnimSubsystem* AnimSubsystem = UWorld::GetSubsystem<UMTGWandererAnimSubsystem>(GetWorld()))
+	{
+		AnimSubsystem->UnregisterActor(this);
+	}
+}
+
+void AMTGWandererActor::ActivateFromPool()
+{
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	for (UActorComponent* Component : GetComponents())
+	{
+		Component->SetComponentTickEnabled(Component->PrimaryComponentTick.bStartWithTickEnabled);
+	}
+
+	SetActorTickEnabled(PrimaryActorTick.bStartWithTickEnabled);
+
+	// After the component ticks are restored, so a paused sim keeps the anims frozen
+	if (UMTGWandererAnimSubsystem* AnimSubsystem = UWorld::GetSubsystem<UMTGWandererAnimSubsystem>(GetWorld()))
+	{
+		AnimSubsystem->RegisterActor(this);
+	}
+}
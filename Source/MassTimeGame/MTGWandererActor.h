@@ -0,0 +1,65 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "GameFramework/Actor.h"
+#include "MassActorPoolableInterface.h"
+#include "MTGWandererActor.generated.h"
+
+class UMTGActorPoolSubsystem;
+
+/**
+ * MTG Wanderer Actor
+ *
+ * Base class for the high LOD wanderer representation actor (BP_Wanderer).
+ *
+ * Wanderer actors are recycled through the Mass actor pool rather than being
+ * destroyed and respawned every time an entity crosses an LOD boundary.
+ * When pooled, the actor is hidden and stops ticking; when retrieved from the
+ * pool, it is shown again and resumes ticking.
+ *
+ * While active, its skeletal mesh anims are frozen and scaled with the sim
+ * by UMTGWandererAnimSubsystem.
+ *
+ * UMTGActorPoolSubsystem pre-warms the pool with these at BeginPlay.
+ */
+UCLASS(Blueprintable)
+class MASSTIMEGAME_API AMTGWandererActor
+	: public AActor
+	, public IMassActorPoolableInterface
+{
+	GENERATED_BODY()
+
+public:
+	// Set Class Defaults
+	AMTGWandererActor();
+
+	//~Begin AActor interface
+	virtual void PostActorCreated() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~End AActor interface
+
+	//~Begin IMassActorPoolableInterface interface
+	virtual bool CanBePooled_Implementation() override;
+	virtual void PrepareForPooling_Implementation() override;
+	virtual void PrepareForGame_Implementation() override;
+	//~End IMassActorPoolableInterface interface
+
+	/** Set by UMTGActorPoolSubsystem on the actors it spawns to pre-warm the pool */
+	void MarkAsPrewarmed() { bIsPrewarmed = true; }
+
+protected:
+	/** Put this actor into its inactive, pooled state */
+	void DeactivateForPool();
+
+	/** Bring this actor back from its inactive, pooled state */
+	void ActivateFromPool();
+
+private:
+	/** Was this actor spawned to pre-warm the pool (as opposed to on demand by the representation)? */
+	bool bIsPrewarmed = false;
+
+	/** Platform time when spawning started, used to measure the cost of on-demand spawns */
+	double SpawnStartTime = 0.;
+};
@@ -0,0 +1,144 @@
+// Copyright (c) 2025 Xist.GG
+
+#include "MTGWandererAnimSubsystem.h"
+
+#include "MassTimeGame.h"
+#include "MTGSimTimeSubsystem.h"
+#include "MTGWandererActor.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("MTG Wanderer Anim Apply"), STAT_MTGWandererAnimApply, STATGROUP_MassTimeGame);
+
+namespace UE::MTG::WandererAnim
+{
+	static bool bDriveAnims = true;
+	static FAutoConsoleVariableRef CVarDriveAnims(
+		TEXT("mtg.DriveWandererAnims"),
+		bDriveAnims,
+		TEXT("If true, wanderer actor anims are frozen while the sim is paused. Takes effect at the next pause or resume."));
+}
+
+void UMTGWandererAnimSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SimTimeSubsystem = Collection.InitializeDependency<UMTGSimTimeSubsystem>();
+	if (ensureMsgf(SimTimeSubsystem, TEXT("MTGSimTimeSubsystem is required")))
+	{
+		SimTimeSubsystem->GetOnSimulationPaused().AddUObject(this, &ThisClass::NativeOnSimulationPauseStateChanged);
+		SimTimeSubsystem->GetOnSimulationResumed().AddUObject(this, &ThisClass::NativeOnSimulationPauseStateChanged);
+	}
+}
+
+void UMTGWandererAnimSubsystem::Deinitialize()
+{
+	if (SimTimeSubsystem)
+	{
+		SimTimeSubsystem->GetOnSimulationPaused().RemoveAll(this);
+		SimTimeSubsystem->GetOnSimulationResumed().RemoveAll(this);
+		SimTimeSubsystem = nullptr;
+	}
+
+	Meshes.Reset();
+
+	Super::Deinitialize();
+}
+
+void UMTGWandererAnimSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// The sim may start paused, in which case no pause event will tell us
+	ApplySimState();
+}
+
+bool UMTGWandererAnimSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMTGWandererAnimSubsystem::RegisterActor(AMTGWandererActor* Actor)
+{
+	check(IsInGameThread());
+
+	if (!Actor)
+	{
+		return;
+	}
+
+	// Catch up with a pause that happened before any event could reach us
+	ApplySimState();
+
+	TInlineComponentArray<USkeletalMeshComponent*> ActorMeshes(Actor);
+	for (USkeletalMeshComponent* Mesh : ActorMeshes)
+	{
+		Meshes.Add(Mesh);
+
+		// It may have been pooled under a different sim state
+		ApplyToMesh(*Mesh);
+	}
+}
+
+void UMTGWandererAnimSubsystem::UnregisterActor(AMTGWandererActor* Actor)
+{
+	check(IsInGameThread());
+
+	if (!Actor)
+	{
+		return;
+	}
+
+	TInlineComponentArray<USkeletalMeshComponent*> ActorMeshes(Actor);
+	for (USkeletalMeshComponent* Mesh : ActorMeshes)
+	{
+		Meshes.Remove(Mesh);
+	}
+}
+
+void UMTGWandererAnimSubsystem::NativeOnSimulationPauseStateChanged(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystemIn)
+{
+	ApplySimState();
+}
+
+void UMTGWandererAnimSubsystem::ApplySimState()
+{
+	using namespace UE::MTG::WandererAnim;
+
+	if (!SimTimeSubsystem)
+	{
+		return;
+	}
+
+	const bool bNewIsFrozen = bDriveAnims && SimTimeSubsystem->IsPaused();
+	if (bNewIsFrozen == bIsFrozen)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MTGWandererAnimApply);
+
+	bIsFrozen = bNewIsFrozen;
+
+	for (auto It = Meshes.CreateIterator(); It; ++It)
+	{
+		if (USkeletalMeshComponent* Mesh = It->Get())
+		{
+			ApplyToMesh(*Mesh);
+		}
+		else
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	UE_LOG(LogMassTimeGame, Verbose, TEXT("Wanderer anims %s on %d meshes"), bIsFrozen ? TEXT("frozen") : TEXT("running"), Meshes.Num());
+}
+
+void UMTGWandererAnimSubsystem::ApplyToMesh(USkeletalMeshComponent& Mesh) const
+{
+	Mesh.bPauseAnims = bIsFrozen;
+
+	// A paused mesh keeps its last pose; not ticking it skips the anim graph entirely
+	Mesh.SetComponentTickEnabled(!bIsFrozen && Mesh.PrimaryComponentTick.bStartWithTickEnabled);
+}
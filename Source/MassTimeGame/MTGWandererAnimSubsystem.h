@@ -0,0 +1,85 @@
+// Copyright (c) 2025 Xist.GG
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "MTGWandererAnimSubsystem.generated.h"
+
+class AMTGWandererActor;
+class UMTGSimTimeSubsystem;
+class USkeletalMeshComponent;
+
+/**
+ * MTG Wanderer Anim Subsystem
+ *
+ * Freezes the animation of every active wanderer actor while the sim is
+ * paused, so the anim blueprint doesn't have to poll UMTGBlueprintHelpers
+ * every anim update on every actor.
+ *
+ * AMTGWandererActor registers here when it comes out of the pool and
+ * unregisters when it goes back.  On pause, one pass over the registered
+ * skeletal meshes pauses their anims and disables their tick, so a paused
+ * world runs no anim graph evaluation at all; on resume their tick comes
+ * back.
+ *
+ * Sim speed needs nothing here: the sim time dilation is the world time
+ * dilation, which already scales the meshes' DeltaTime.
+ */
+UCLASS(meta=(DisplayName="MTG Wanderer Anim Subsystem"))
+class MASSTIMEGAME_API UMTGWandererAnimSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~Begin USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem interface
+
+	//~Begin UWorldSubsystem interface
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	//~End UWorldSubsystem interface
+
+	/**
+	 * Start driving an actor's animation, and apply the current sim state to it
+	 * @param Actor A wanderer actor that just became active
+	 */
+	void RegisterActor(AMTGWandererActor* Actor);
+
+	/**
+	 * Stop driving an actor's animation
+	 * @param Actor A wanderer actor that is going back to the pool or away
+	 */
+	void UnregisterActor(AMTGWandererActor* Actor);
+
+	/** @return Number of skeletal meshes currently driven */
+	int32 GetNumMeshes() const { return Meshes.Num(); }
+
+protected:
+	/**
+	 * Callback from MTGSimTimeSubsystem whenever the sim is paused or resumed
+	 * @param SimTimeSubsystem The world's MTGSimTimeSubsystem
+	 */
+	void NativeOnSimulationPauseStateChanged(TNotNull<UMTGSimTimeSubsystem*> SimTimeSubsystem);
+
+	/** Read the pause state from the sim, and apply it to every registered mesh if it changed */
+	void ApplySimState();
+
+	/**
+	 * Apply the current pause state to one mesh
+	 * @param Mesh The mesh to update
+	 */
+	void ApplyToMesh(USkeletalMeshComponent& Mesh) const;
+
+private:
+	/** Saved reference to the MTGSimTimeSubsystem */
+	UPROPERTY(Transient)
+	TObjectPtr<UMTGSimTimeSubsystem> SimTimeSubsystem;
+
+	/** Skeletal meshes of the registered actors */
+	TSet<TWeakObjectPtr<USkeletalMeshComponent>> Meshes;
+
+	/** Are the anims currently frozen? */
+	bool bIsFrozen = false;
+};
@@ -1,9 +1,25 @@
 // Copyright (c) 2025 Xist.GG
 
 #include "MassTimeGame.h"
+#include "MTGFrameArena.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, MassTimeGame, "MassTimeGame" );
+class FMassTimeGameModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		// Lets mtg.FrameArenaStats prove that a steady state sim tick doesn't touch the heap
+		if (FParse::Param(FCommandLine::Get(), TEXT("MTGCountSimAllocs")))
+		{
+			FMTGFrameArenas::InstallScopedHeapAllocCounter();
+		}
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FMassTimeGameModule, MassTimeGame, "MassTimeGame" );
 
 DEFINE_LOG_CATEGORY(LogMassTimeGame)
  
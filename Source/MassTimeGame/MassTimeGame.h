@@ -3,5 +3,8 @@
 #pragma once
 
 #include "Logging/LogMacros.h"
+#include "Stats/Stats.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogMassTimeGame, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("MassTimeGame"), STATGROUP_MassTimeGame, STATCAT_Advanced);